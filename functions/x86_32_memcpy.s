@@ -0,0 +1,33 @@
+_F6memcpyPIPIIII:
+push ebp
+mov ebp, esp
+
+push ecx
+push esi
+push edi
+
+;edi = dest + dest_offset
+mov edi, ecx
+add edi, [ebp + 12]
+
+;esi = src + src_offset
+mov esi, [ebp + 8]
+add esi, [ebp + 16]
+
+;ecx = number of bytes
+mov ecx, [ebp + 20]
+cmp ecx, 0
+jle .end
+
+;Forward copy, byte per byte
+cld
+rep movsb
+
+.end:
+
+pop edi
+pop esi
+pop ecx
+
+leave
+ret
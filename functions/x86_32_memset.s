@@ -0,0 +1,48 @@
+_F6memsetPIIIII:
+push ebp
+mov ebp, esp
+
+push eax
+push ecx
+push edx
+push edi
+
+;edi = dest + dest_offset
+mov edi, ecx
+add edi, [ebp + 8]
+
+;eax = value, replicated on each byte for byte elements
+mov eax, [ebp + 12]
+cmp dword [ebp + 20], 1
+jne .fill
+
+movzx eax, al
+imul eax, eax, 0x01010101
+
+.fill:
+
+mov edx, [ebp + 16]
+cmp edx, 0
+jle .end
+
+cld
+
+;Fill the double words
+mov ecx, edx
+shr ecx, 2
+rep stosd
+
+;Fill the remaining bytes
+mov ecx, edx
+and ecx, 3
+rep stosb
+
+.end:
+
+pop edi
+pop edx
+pop ecx
+pop eax
+
+leave
+ret
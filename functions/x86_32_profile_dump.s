@@ -0,0 +1,35 @@
+_F12profile_dump:
+push ebp
+mov ebp, esp
+
+;Open the profile file (O_WRONLY | O_CREAT | O_TRUNC, 0644)
+mov eax, 5
+mov ebx, V__profile_file
+mov ecx, 577
+mov edx, 420
+int 80h
+
+cmp eax, 0
+jl .end
+
+;Write the size of the counters array and all the counters
+mov ebx, eax
+push ebx
+
+mov ecx, V__profile_counters
+mov edx, [ecx]
+inc edx
+shl edx, 2
+
+mov eax, 4
+int 80h
+
+;Close the file
+pop ebx
+mov eax, 6
+int 80h
+
+.end:
+
+leave
+ret
@@ -0,0 +1,33 @@
+_F6memcpyPIPIIII:
+push rbp
+mov rbp, rsp
+
+push rcx
+push rsi
+push rdi
+
+;rdi = dest + dest_offset
+mov rdi, r14
+add rdi, [rbp + 16]
+
+;rsi = src + src_offset
+mov rsi, r15
+add rsi, [rbp + 24]
+
+;rcx = number of bytes
+mov rcx, [rbp + 32]
+cmp rcx, 0
+jle .end
+
+;Forward copy, byte per byte
+cld
+rep movsb
+
+.end:
+
+pop rdi
+pop rsi
+pop rcx
+
+leave
+ret
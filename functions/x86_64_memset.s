@@ -0,0 +1,49 @@
+_F6memsetPIIIII:
+push rbp
+mov rbp, rsp
+
+push rax
+push rcx
+push rdx
+push rdi
+
+;rdi = dest + dest_offset
+mov rdi, r14
+add rdi, r15
+
+;rax = value, replicated on each byte for byte elements
+mov rax, [rbp + 16]
+cmp qword [rbp + 32], 1
+jne .fill
+
+movzx rax, al
+mov rdx, 0x0101010101010101
+imul rax, rdx
+
+.fill:
+
+mov rdx, [rbp + 24]
+cmp rdx, 0
+jle .end
+
+cld
+
+;Fill the quad words
+mov rcx, rdx
+shr rcx, 3
+rep stosq
+
+;Fill the remaining bytes
+mov rcx, rdx
+and rcx, 7
+rep stosb
+
+.end:
+
+pop rdi
+pop rdx
+pop rcx
+pop rax
+
+leave
+ret
@@ -0,0 +1,35 @@
+_F12profile_dump:
+push rbp
+mov rbp, rsp
+
+;Open the profile file (O_WRONLY | O_CREAT | O_TRUNC, 0644)
+mov rax, 2
+mov rdi, V__profile_file
+mov rsi, 577
+mov rdx, 420
+syscall
+
+cmp rax, 0
+jl .end
+
+;Write the size of the counters array and all the counters
+mov rdi, rax
+push rdi
+
+mov rsi, V__profile_counters
+mov rdx, [rsi]
+inc rdx
+shl rdx, 3
+
+mov rax, 1
+syscall
+
+;Close the file
+pop rdi
+mov rax, 3
+syscall
+
+.end:
+
+leave
+ret
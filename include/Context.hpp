@@ -13,6 +13,8 @@
 
 #include <unordered_map>
 
+#include "symbol.hpp"
+
 #include "ast/Value.hpp"
 
 namespace eddic {
@@ -37,7 +39,7 @@ class Context {
         std::shared_ptr<GlobalContext> global_context;
 
     protected:
-        typedef std::unordered_map<std::string, std::shared_ptr<Variable>> Variables;
+        typedef std::unordered_map<symbol, std::shared_ptr<Variable>> Variables;
 
         Variables variables;
 
@@ -91,6 +93,13 @@ class Context {
          */
         virtual std::shared_ptr<Variable> new_temporary(std::shared_ptr<const Type> type);
 
+        /*!
+         * Search the given variable in this context and its parents.
+         * \param name The name of the searched variable.
+         * \return The variable with the given name or nullptr if it does not exist.
+         */
+        std::shared_ptr<Variable> find_variable(symbol name) const;
+
         /*!
          * Indicates if the given variable exists in this context. 
          * \param name The name of the searched variable. 
@@ -9,12 +9,15 @@
 #define GLOBAL_CONTEXT_H
 
 #include <map>
+#include <deque>
+#include <mutex>
 
 #include "Context.hpp"
 #include "Function.hpp"
 #include "Struct.hpp"
 #include "Platform.hpp"
 #include "statistics.hpp"
+#include "mapped_file.hpp"
 #include "timing.hpp"
 
 #include "parser_x3/error_handling.hpp"
@@ -30,8 +33,9 @@ namespace eddic {
  */
 struct GlobalContext final : public Context {
     public:
-        typedef std::unordered_map<std::string, Function> FunctionMap;
+        typedef std::unordered_map<symbol, Function> FunctionMap;
         typedef std::unordered_map<std::string, std::shared_ptr<Struct>> StructMap;
+        typedef std::unordered_map<std::string, std::shared_ptr<const Type>> TypeMap;
 
         x3_grammar::global_error_handler error_handler;
 
@@ -102,6 +106,20 @@ struct GlobalContext final : public Context {
          */
         bool struct_exists(std::shared_ptr<const Type> type) const ;
 
+        /*!
+         * Returns the unique structure type with the given mangled name.
+         * \param mangled The mangled name of the type.
+         * \return The type or nullptr if it has not been created yet.
+         */
+        std::shared_ptr<const Type> get_type(const std::string& mangled) const;
+
+        /*!
+         * Register the unique structure type with the given mangled name.
+         * \param mangled The mangled name of the type.
+         * \param type The type to register.
+         */
+        void add_type(const std::string& mangled, std::shared_ptr<const Type> type);
+
         std::shared_ptr<const Type> member_type(std::shared_ptr<const Struct> struct_, int offset) const;
         int member_offset(std::shared_ptr<const Struct> struct_, const std::string& member) const;
 
@@ -109,12 +127,24 @@ struct GlobalContext final : public Context {
         int total_size_of_struct(std::shared_ptr<const Struct> struct_) const;
         bool is_recursively_nested(std::shared_ptr<const Struct> struct_) const;
 
+        /*!
+         * Map the given source file in memory. This can be called from several threads.
+         * \param file_name The path to the source file.
+         * \return The index of the file.
+         */
         std::size_t new_file(const std::string& file_name);
-        std::string& get_file_content(std::size_t file);
+        const mapped_file& get_file_content(std::size_t file);
         const std::string& get_file_name(std::size_t file);
 
         const FunctionMap& functions() const;
 
+        /*!
+         * \brief Release the contexts of the functions.
+         *
+         * The function contexts hold the global context, this breaks the cycle once the program has been compiled.
+         */
+        void release_function_contexts();
+
         Platform target_platform() const;
 
         statistics& stats();
@@ -123,12 +153,15 @@ struct GlobalContext final : public Context {
     private:
         FunctionMap m_functions;
         StructMap m_structs;
+        TypeMap m_types;
         statistics m_statistics;
         timing_system m_timing;
         Platform platform;
 
-        std::vector<std::string> file_names;
-        std::vector<std::string> file_contents;
+        //The references to the files must stay valid when others are added
+        std::mutex files_mutex;
+        std::deque<std::string> file_names;
+        std::deque<mapped_file> file_contents;
 
         void addPrintFunction(const std::string& function, std::shared_ptr<const Type> parameterType);
         void defineStandardFunctions();
@@ -29,6 +29,8 @@ struct PlatformDescriptor {
     
     virtual unsigned short a_register() const = 0;
     virtual unsigned short d_register() const = 0;
+    virtual unsigned short c_register() const = 0;
+    virtual unsigned short di_register() const = 0;
 
     virtual unsigned short int_variable_register(unsigned int position) const = 0;
     
@@ -11,6 +11,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <unordered_map>
 
 #include <boost/optional.hpp>
 
@@ -119,14 +120,18 @@ class Type : public std::enable_shared_from_this<Type> {
         virtual unsigned int size(Platform platform) const;
 
         /*!
-         * Return the mangled name of the type.
+         * Return the mangled name of the type. The name is computed once and then cached.
          * \return The mangled name of the type.
          */
-        std::string mangle() const;
+        const std::string& mangle() const;
 
         friend bool operator==(std::shared_ptr<const Type> lhs, std::shared_ptr<const Type> rhs);
         friend bool operator!=(std::shared_ptr<const Type> lhs, std::shared_ptr<const Type> rhs);
 
+        friend std::shared_ptr<const Type> new_array_type(std::shared_ptr<const Type> data_type);
+        friend std::shared_ptr<const Type> new_array_type(std::shared_ptr<const Type> data_type, int size);
+        friend std::shared_ptr<const Type> new_pointer_type(std::shared_ptr<const Type> data_type);
+
     protected:
         /*!
          * Construct a new Type.
@@ -138,6 +143,14 @@ class Type : public std::enable_shared_from_this<Type> {
          * \return the base type.
          */
         virtual BaseType base() const;
+
+    private:
+        mutable std::string m_mangled;
+
+        //The types derived from this one, to return always the same instance
+        mutable std::weak_ptr<const Type> m_array;
+        mutable std::weak_ptr<const Type> m_pointer;
+        mutable std::unordered_map<int, std::weak_ptr<const Type>> m_sized_arrays;
 };
 
 /*!
@@ -178,7 +191,7 @@ class StandardType : public Type {
  */
 class CustomType : public Type {
     private:
-        std::shared_ptr<GlobalContext> context;
+        std::weak_ptr<GlobalContext> context;
         std::string m_type;
 
     public:
@@ -268,7 +281,7 @@ struct PointerType : public Type {
  */
 struct TemplateType : public Type {
     private:
-        std::shared_ptr<GlobalContext> context;
+        std::weak_ptr<GlobalContext> context;
         std::string main_type;
         std::vector<std::shared_ptr<const Type>> sub_types;
 
@@ -295,6 +308,11 @@ struct TemplateType : public Type {
 
 /* Relational operators  */
 
+/*
+ * The types are hash-consed: the factories below always return the same instance for the same structure.
+ * Only the standard types (const or not) and the arrays (sized or not) need to be compared structurally.
+ */
+
 bool operator==(std::shared_ptr<const Type> lhs, std::shared_ptr<const Type> rhs);
 bool operator!=(std::shared_ptr<const Type> lhs, std::shared_ptr<const Type> rhs);
 
@@ -308,6 +326,8 @@ extern std::shared_ptr<const Type> VOID;
 /*!
  * \brief Parse the given type into an EDDI std::shared_ptr<Type>.
  *
+ * The custom types are unique in the given context.
+ *
  * \param context The current global context
  * \param type The type to parse.
  */
@@ -335,6 +355,13 @@ std::shared_ptr<const Type> new_array_type(std::shared_ptr<const Type> data_type
  */
 std::shared_ptr<const Type> new_pointer_type(std::shared_ptr<const Type> data_type);
 
+/*!
+ * Create a new template type. The template types are unique in the given context.
+ * \param context The current global context
+ * \param data_type The name of the template structure.
+ * \param template_types The types of the template parameters.
+ * \return the created type;
+ */
 std::shared_ptr<const Type> new_template_type(std::shared_ptr<GlobalContext> context, std::string data_type, std::vector<std::shared_ptr<const Type>> template_types);
 
 /*!
@@ -78,6 +78,12 @@ bool file_exists(const std::string& file);
 
 std::string execCommand(const std::string& command);
 
+/*!
+ * \brief Return the memory currently resident for the process.
+ * \return The resident memory, in KB, or 0 if it cannot be read.
+ */
+std::size_t resident_memory();
+
 bool isPowerOfTwo (int x);
 
 int powerOfTwo(int x);
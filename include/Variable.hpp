@@ -14,6 +14,7 @@
 #include <ostream>
 
 #include "variant.hpp"
+#include "symbol.hpp"
 #include "Position.hpp"
 
 #include "parser_x3/error_handling.hpp"
@@ -34,7 +35,7 @@ class Variable {
     private:
         std::size_t m_references = 0;
 
-        const std::string m_name;
+        const symbol m_name;
         std::shared_ptr<const Type> m_type;
 
         Position m_position;
@@ -57,7 +58,7 @@ class Variable {
         std::size_t references() const;
         void add_reference();
 
-        std::string name() const ;
+        const std::string& name() const ;
         std::shared_ptr<const Type> type() const ;
         Position position() const ;
 
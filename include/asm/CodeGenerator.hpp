@@ -38,7 +38,25 @@ class CodeGenerator {
          * \param pool The string pool to use. 
          * \param float_pool The float pool to use. 
          */
-        virtual void generate(StringPool& pool, FloatPool& float_pool) = 0;
+        void generate(StringPool& pool, FloatPool& float_pool);
+
+        /*!
+         * Generates the code that precedes the functions. 
+         */
+        virtual void begin_program() = 0;
+
+        /*!
+         * Generates the code of one function. The functions can be generated one by one as soon as their LTAC is final. 
+         * \param function The function to generate the code for. 
+         */
+        virtual void generate(mtac::Function& function) = 0;
+
+        /*!
+         * Generates the code that follows the functions, the standard functions and the data. 
+         * \param pool The string pool to use. 
+         * \param float_pool The float pool to use. 
+         */
+        virtual void end_program(StringPool& pool, FloatPool& float_pool) = 0;
 
     protected:
         AssemblyFileWriter& writer;
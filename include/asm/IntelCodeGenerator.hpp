@@ -30,7 +30,11 @@ class IntelCodeGenerator : public CodeGenerator {
     public:
         IntelCodeGenerator(AssemblyFileWriter& writer, mtac::Program& program, std::shared_ptr<GlobalContext> context);
         
-        void generate(StringPool& pool, FloatPool& float_pool) override;
+        using CodeGenerator::generate;
+
+        void begin_program() override;
+        void generate(mtac::Function& function) override;
+        void end_program(StringPool& pool, FloatPool& float_pool) override;
 
     protected:
         std::shared_ptr<GlobalContext> context;
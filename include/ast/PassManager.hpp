@@ -32,8 +32,15 @@ class PassManager {
         void init_passes();
         void run_passes();
 
-        void function_instantiated(ast::TemplateFunctionDeclaration& function, const std::string& context);
-        void struct_instantiated(ast::struct_definition& struct_);
+        /*!
+         * Apply the passes to the given function instantiation and take it to add it to the program later.
+         */
+        void function_instantiated(ast::TemplateFunctionDeclaration&& function, const std::string& context);
+
+        /*!
+         * Apply the passes to the given struct instantiation and take it to add it to the program later.
+         */
+        void struct_instantiated(ast::struct_definition&& struct_);
 
         ast::SourceFile& program() {
             return program_;
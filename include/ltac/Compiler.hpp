@@ -35,9 +35,15 @@ class Compiler {
          * \param float_pool The float pool to use. 
          */
         void compile(mtac::Program& source, FloatPool& float_pool);
+
+        /*!
+         * Compile one MTAC function into LTAC. 
+         * \param src_function The source MTAC function. 
+         * \param float_pool The float pool to use. 
+         */
+        void compile(mtac::Function& src_function, FloatPool& float_pool);
     
     private:
-        void compile(mtac::Function& src_function, FloatPool& float_pool);
 
         std::unordered_set<mtac::basic_block_p> block_usage;
         Platform platform;
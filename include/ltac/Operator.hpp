@@ -88,9 +88,13 @@ enum class Operator : unsigned int {
     XORPS,
     MOVDQU,
 
+    //Fill the memory at the di register with the c register copies of the a register
+    REP_STOS,
+
     ALWAYS,
 
     CALL,
+    TAIL_CALL,      //Jump to a function, reusing the stack frame of the caller
 
     //Egality
     NE,
@@ -17,6 +17,7 @@ namespace eddic {
 namespace ltac {
 
 void optimize(mtac::Program& program, Platform platform);
+void optimize(mtac::Function& function, Platform platform);
 
 } //end of ltac
 
@@ -0,0 +1,36 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef LTAC_ADDRESS_FOLDING_H
+#define LTAC_ADDRESS_FOLDING_H
+
+#include "Platform.hpp"
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace ltac {
+
+/*!
+ * \brief Fold the address computations into the memory operands that use them.
+ *
+ * The multiplications by 1, 2, 4 or 8 and the additions computed in pseudo registers are folded into the
+ * base + index * scale + displacement form of the addresses of the same basic block. The small constant
+ * multiplications are done with LEA and the computations that are no longer used are removed.
+ * This must be done before register allocation.
+ * \param program The program to transform.
+ * \param platform The target platform.
+ */
+void fold_addresses(mtac::Program& program, Platform platform);
+void fold_addresses(mtac::Function& function, Platform platform);
+
+} //end of ltac
+
+} //end of eddic
+
+#endif
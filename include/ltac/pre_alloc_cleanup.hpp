@@ -15,6 +15,7 @@ namespace eddic {
 namespace ltac {
 
 void pre_alloc_cleanup(mtac::Program& program);
+void pre_alloc_cleanup(mtac::Function& function);
 
 } //end of ltac
 
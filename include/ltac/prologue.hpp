@@ -9,6 +9,9 @@
 #define LTAC_PROLOGUE_H
 
 #include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 #include "Options.hpp"
 
@@ -18,6 +21,40 @@ namespace eddic {
 
 namespace ltac {
 
+/*!
+ * \class PrologueGenerator
+ * \brief Generate the prologue and epilogue of the functions of a program, the callees before their callers.
+ *
+ * The registers saved around a call depend on the registers clobbered by the callee. The functions are generated
+ * by groups of mutually recursive functions and a group must be generated after all the groups it calls.
+ */
+class PrologueGenerator {
+    public:
+        PrologueGenerator(mtac::Program& program, std::shared_ptr<Configuration> configuration);
+
+        /*!
+         * Return the groups of functions in the order they must be generated, from the bottom to the top of the
+         * call graph. The functions not reachable from the entry point are in the last group.
+         */
+        std::vector<std::vector<mtac::Function*>> groups();
+
+        /*!
+         * Return the functions of the program called by the given function.
+         */
+        std::vector<mtac::Function*> callees(mtac::Function& function);
+
+        /*!
+         * Generate the prologue and epilogue of the given group of functions. The functions they call outside of
+         * the group must already have been generated.
+         */
+        void generate(const std::vector<mtac::Function*>& group);
+
+    private:
+        mtac::Program& program;
+        std::shared_ptr<Configuration> configuration;
+        std::unordered_map<std::string, mtac::Function*> functions;
+};
+
 void generate_prologue_epilogue(mtac::Program& program, std::shared_ptr<Configuration> configuration);
 
 } //end of ltac
@@ -19,6 +19,7 @@ namespace eddic {
 namespace ltac {
 
 void register_allocation(mtac::Program& program, Platform platform);
+void register_allocation(mtac::Function& function, Platform platform, bool profiled);
 
 } //end of mtac
 
@@ -0,0 +1,36 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef LTAC_SCHEDULER_H
+#define LTAC_SCHEDULER_H
+
+#include "Platform.hpp"
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace ltac {
+
+/*!
+ * \brief Reorder the instructions of each basic block to hide the latency of the loads and of the long operations.
+ *
+ * The instructions are list scheduled between barriers (labels, jumps, calls, stack manipulations) following the
+ * longest latency path of their dependency graph. Before register allocation, the scheduler avoids to increase
+ * the number of live pseudo registers when it is already close to the number of hard registers.
+ * \param program The program to schedule.
+ * \param platform The target platform, giving the latencies and the number of registers.
+ * \param allocated Indicates if the registers have already been allocated.
+ */
+void schedule(mtac::Program& program, Platform platform, bool allocated);
+void schedule(mtac::Function& function, Platform platform, bool allocated);
+
+} //end of ltac
+
+} //end of eddic
+
+#endif
@@ -17,6 +17,7 @@ namespace eddic {
 namespace ltac {
 
 void fix_stack_offsets(mtac::Program& program, Platform platform);
+void fix_stack_offsets(mtac::Function& function, Platform platform);
 
 } //end of ltac
 
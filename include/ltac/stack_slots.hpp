@@ -0,0 +1,35 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef LTAC_STACK_SLOTS_H
+#define LTAC_STACK_SLOTS_H
+
+#include "Platform.hpp"
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace ltac {
+
+/*!
+ * \brief Share the stack slots of the variables and of the spilled registers whose lifetimes do not overlap.
+ *
+ * The lifetime of a slot goes from its first access to its last read. The slots whose address is taken are never
+ * shared. The slots are packed by first fit in decreasing size and the BP offsets are rewritten, so this must be
+ * done after the register allocation and before the generation of the prologue.
+ * \param program The program to transform.
+ * \param platform The target platform.
+ */
+void color_stack_slots(mtac::Program& program, Platform platform);
+void color_stack_slots(mtac::Function& function, Platform platform);
+
+} //end of ltac
+
+} //end of eddic
+
+#endif
@@ -8,13 +8,27 @@
 #ifndef LTAC_STACK_SPACE_H
 #define LTAC_STACK_SPACE_H
 
+#include "Platform.hpp"
+
 #include "mtac/forward.hpp"
 
 namespace eddic {
 
 namespace ltac {
 
+/*!
+ * \brief Find where the structures and arrays on the stack must be cleared.
+ *
+ * An aggregate whose bytes are always written before being read is not cleared. The others are cleared in the
+ * block dominating all their uses, outside of the loops. Must be called on the MTAC code.
+ */
+void find_clear_points(mtac::Program& program);
+
+/*!
+ * \brief Clear the structures and arrays on the stack and set the sizes of the arrays.
+ */
 void alloc_stack_space(mtac::Program& program);
+void alloc_stack_space(mtac::Function& function, Platform platform);
 
 } //end of ltac
 
@@ -27,6 +27,21 @@ class Parameter;
  */
 std::string mangle(std::shared_ptr<const Type> type);
 
+/*!
+ * \brief Return the mangled representation of the custom type with the given name.
+ * \param name The name of the structure.
+ * \return The mangled type.
+ */
+std::string mangle_custom_type(const std::string& name);
+
+/*!
+ * \brief Return the mangled representation of the template type with the given name and template parameters.
+ * \param name The name of the template structure.
+ * \param types The types of the template parameters.
+ * \return The mangled type.
+ */
+std::string mangle_template_type(const std::string& name, const std::vector<std::shared_ptr<const Type>>& types);
+
 /*!
  * \brief Return the signature of the function from the mangled representation. 
  * \param mangled The mangled representation of the function. 
@@ -0,0 +1,56 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+
+namespace eddic {
+
+/*!
+ * \class mapped_file
+ * \brief A source file mapped read-only in memory.
+ *
+ * The contents are never copied. The mapping does not move when the mapped_file is moved, so the
+ * pointers into the contents stay valid as long as the mapped_file is alive.
+ */
+class mapped_file {
+    public:
+        mapped_file() = default;
+        ~mapped_file();
+
+        mapped_file(const mapped_file& rhs) = delete;
+        mapped_file& operator=(const mapped_file& rhs) = delete;
+
+        mapped_file(mapped_file&& rhs) noexcept;
+        mapped_file& operator=(mapped_file&& rhs) noexcept;
+
+        /*!
+         * Map the given file in memory.
+         * \param file The path to the file.
+         * \return true if the file has been mapped, false otherwise.
+         */
+        bool open(const std::string& file);
+
+        bool is_open() const;
+
+        const char* begin() const;
+        const char* end() const;
+        std::size_t size() const;
+
+    private:
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+        bool m_open = false;
+
+        void close();
+};
+
+} //end of eddic
+
+#endif
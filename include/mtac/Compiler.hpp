@@ -19,6 +19,7 @@ struct StringPool;
 namespace mtac {
 
 struct Compiler {
+    //The bodies of the functions are released from the AST as soon as their MTAC has been generated
     void compile(ast::SourceFile& source, std::shared_ptr<StringPool> pool, mtac::Program& program) const ;
 };
 
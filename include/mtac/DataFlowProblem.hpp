@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "mtac/forward.hpp"
+#include "mtac/block_map.hpp"
 #include "mtac/DataFlowDomain.hpp"
 
 namespace eddic {
@@ -19,8 +20,8 @@ namespace mtac {
 
 template<typename Domain>
 struct DataFlowResults {
-    std::unordered_map<mtac::basic_block_p, Domain> OUT;
-    std::unordered_map<mtac::basic_block_p, Domain> IN;
+    mtac::block_map<Domain> OUT;
+    mtac::block_map<Domain> IN;
     
     std::unordered_map<std::size_t, Domain> OUT_S;
     std::unordered_map<std::size_t, Domain> IN_S;
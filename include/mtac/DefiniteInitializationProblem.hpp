@@ -0,0 +1,116 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_DEFINITE_INITIALIZATION_PROBLEM_H
+#define MTAC_DEFINITE_INITIALIZATION_PROBLEM_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <ostream>
+
+#include <boost/utility.hpp>
+
+#define STATIC_CONSTANT(type,name,value) BOOST_STATIC_CONSTANT(type, name = value)
+
+#include "Platform.hpp"
+
+#include "mtac/DataFlowProblem.hpp"
+
+namespace eddic {
+
+class Variable;
+
+namespace mtac {
+
+/*!
+ * \brief A range of bytes [first, last[ of a variable.
+ */
+struct ByteRange {
+    int first;
+    int last;
+
+    ByteRange(int first, int last) : first(first), last(last) {}
+
+    bool operator==(const ByteRange& rhs) const {
+        return first == rhs.first && last == rhs.last;
+    }
+};
+
+std::ostream& operator<<(std::ostream& stream, const ByteRange& range);
+
+//The sorted and disjoint ranges of bytes of each aggregate written on all paths
+typedef std::unordered_map<std::shared_ptr<Variable>, std::vector<ByteRange>> InitializedValues;
+
+/*!
+ * \brief Accesses of a quadruple to a stack aggregate.
+ */
+struct AggregateAccess {
+    bool read = false;          //!< Bytes of the aggregate are read
+    bool write = false;         //!< Bytes of the aggregate are written
+    bool complete = false;      //!< The read may access any byte of the aggregate
+    ByteRange range{0, 0};      //!< The bytes read or written, only valid if not complete
+};
+
+/*!
+ * \brief Data-flow problem computing the bytes of the stack aggregates that are always written at each point.
+ *
+ * Only the writes at constant offsets and the memset and memcpy intrinsics with constant offsets and sizes are
+ * considered, the meet is the intersection of the written ranges.
+ */
+struct DefiniteInitializationProblem {
+    //The type of data managed
+    typedef Domain<InitializedValues> ProblemDomain;
+
+    //The direction and modes
+    STATIC_CONSTANT(DataFlowType, Type, DataFlowType::Fast_Forward);
+    STATIC_CONSTANT(bool, Low, false);
+
+    /*!
+     * \param platform The target platform, giving the size of the accesses
+     * \param initial The ranges of each aggregate written before the first statement
+     */
+    DefiniteInitializationProblem(Platform platform, InitializedValues initial);
+
+    ProblemDomain Boundary(mtac::Function& function);
+    ProblemDomain Init(mtac::Function& function);
+
+    void meet(ProblemDomain& in, const ProblemDomain& out);
+    void transfer(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple, ProblemDomain& in);
+
+    /*!
+     * \brief Compute the access of the quadruple to the given aggregate.
+     *
+     * Must be called on the quadruples in order, the constant arguments of the intrinsics are collected from their
+     * parameters.
+     */
+    AggregateAccess access(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple, const std::shared_ptr<Variable>& variable);
+
+    private:
+        Platform platform;
+        InitializedValues initial;
+
+        //Constant parameters of the intrinsic being called
+        std::size_t current_uid = 0;
+        std::unordered_map<std::string, int> parameters;
+
+        void collect(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple);
+};
+
+bool operator==(const mtac::Domain<InitializedValues>& lhs, const mtac::Domain<InitializedValues>& rhs);
+bool operator!=(const mtac::Domain<InitializedValues>& lhs, const mtac::Domain<InitializedValues>& rhs);
+
+/*!
+ * \brief Indicates if the bytes of the range are all written.
+ */
+bool initialized(const std::vector<ByteRange>& ranges, ByteRange range);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -12,6 +12,7 @@
 #include <vector>
 #include <utility>
 #include <set>
+#include <unordered_map>
 #include <ostream>
 
 #include "iterators.hpp"
@@ -41,9 +42,9 @@ class loop;
  * the Function can directly contains statements. After that, only the basic blocks have
  * statements.
  *
- * The basic_block of the Function are stored in a doubly-linked list. The entry and exit basic
- * blocks can be obtained with the entry_bb() and exit_bb() functions. The basic blocks can be
- * iterated using begin() and end() iterators. 
+ * The basic_block of the Function are stored in a block pool, in the order of their layout. The entry
+ * and exit basic blocks can be obtained with the entry_bb() and exit_bb() functions. The basic blocks
+ * can be iterated using begin() and end() iterators. 
  *
  * \see mtac::basic_block
  */
@@ -72,8 +73,15 @@ class Function : public std::enable_shared_from_this<Function> {
             statements.push_back(std::forward<mtac::Quadruple>(quadruple));
         }
 
+        /*!
+         * \brief Return the MTAC statement with the given UID.
+         *
+         * The position of the statements is kept in an index by block id that the basic blocks update on each
+         * insertion and removal, the lookups are in O(1).
+         * \param uid The UID of the statement to find.
+         * \return A reference to the MTAC statement with the given UID.
+         */
         mtac::Quadruple& find(std::size_t uid);
-        ltac::Instruction& find_low(std::size_t uid);
 
         std::vector<mtac::Quadruple>& get_statements();
         const std::vector<mtac::Quadruple>& get_statements() const;
@@ -91,41 +99,41 @@ class Function : public std::enable_shared_from_this<Function> {
         basic_block_p exit_bb();
 
         /*!
-         * \brief Return an iterator to the beginning of the doubly-linked list of basic blocks. 
-         * \return iterator to the beginning of the doubly-linked list of basic blocks. 
+         * \brief Return an iterator to the first basic block of the layout. 
+         * \return iterator to the first basic block of the layout. 
          */
         basic_block_iterator begin(){
-            return basic_block_iterator(entry, nullptr);
+            return basic_block_iterator(pool.get(), pool->at(0));
         }
 
         /*!
-         * \brief Return an iterator to the end of the doubly-linked list of basic blocks. 
-         * \return iterator to the end of the doubly-linked list of basic blocks. 
+         * \brief Return an iterator one past the last basic block of the layout. 
+         * \return iterator one past the last basic block of the layout. 
          */
         basic_block_iterator end(){
-            return basic_block_iterator(nullptr, exit);    
+            return basic_block_iterator(pool.get(), nullptr);
         }
 
         /*!
-         * \brief Return an iterator to the beginning of the doubly-linked list of basic blocks. 
-         * \return iterator to the beginning of the doubly-linked list of basic blocks. 
+         * \brief Return an iterator to the first basic block of the layout. 
+         * \return iterator to the first basic block of the layout. 
          */
         basic_block_const_iterator begin() const {
-            return basic_block_const_iterator(entry, nullptr);
+            return basic_block_const_iterator(pool.get(), pool->at(0));
         }
 
         /*!
-         * \brief Return an iterator to the end of the doubly-linked list of basic blocks. 
-         * \return iterator to the end of the doubly-linked list of basic blocks. 
+         * \brief Return an iterator one past the last basic block of the layout. 
+         * \return iterator one past the last basic block of the layout. 
          */
         basic_block_const_iterator end() const {
-            return basic_block_const_iterator(nullptr, exit);
+            return basic_block_const_iterator(pool.get(), nullptr);
         }
 
         /*!
          * \brief Return the position of the basic block inside the instruction stream of the function. 
          *
-         * The basic block must be part of the function. This runs in O(n).
+         * The basic block must be part of the function. This runs in O(1).
          *
          * \param bb The basic block to search
          * \return the position of the basic block inside the instruction stream of the function.
@@ -140,11 +148,26 @@ class Function : public std::enable_shared_from_this<Function> {
         basic_block_iterator remove(basic_block_iterator it);
         basic_block_iterator remove(basic_block_p bb);
 
+        /*!
+         * \brief Change the order of the basic blocks in the instruction stream.
+         *
+         * The control flow graph is not modified.
+         * \param order All the basic blocks of the function in their new order.
+         */
+        void reorder(const std::vector<basic_block_p>& order);
+
         std::pair<basic_block_iterator, basic_block_iterator> blocks();
 
         std::vector<mtac::loop>& loops();
 
         std::size_t bb_count() const;
+
+        /*!
+         * \brief Return the number of ids given to the basic blocks of the function so far.
+         *
+         * All the ids of the blocks are smaller than this number, it can be used to size a mtac::block_map.
+         */
+        std::size_t bb_ids() const;
         std::size_t size() const;
         std::size_t size_no_nop() const;
         
@@ -166,6 +189,22 @@ class Function : public std::enable_shared_from_this<Function> {
         void variable_use(ltac::Register reg);
         void variable_use(ltac::FloatRegister reg);
 
+        /*!
+         * \brief Return the registers whose value may be changed by a call to this function.
+         */
+        const std::set<ltac::Register>& clobbered_registers() const;
+        const std::set<ltac::FloatRegister>& clobbered_float_registers() const;
+
+        bool clobber(ltac::Register reg);
+        bool clobber(ltac::FloatRegister reg);
+
+        /*!
+         * \brief Return the block where each stack aggregate is cleared, null if it does not need to be cleared.
+         *
+         * The aggregates that are not present are cleared in the entry block.
+         */
+        std::unordered_map<std::shared_ptr<Variable>, basic_block_p>& clear_points();
+
         /*!
          * \brief Indicate if this function is the main function.
          * \return true if it is the main function, false otherwise. 
@@ -224,16 +263,19 @@ class Function : public std::enable_shared_from_this<Function> {
         bool _standard = false;
         
         //There is no basic blocks at the beginning
-        std::size_t count = 0;
         std::size_t index = 0;
-        basic_block_p entry = nullptr;
-        basic_block_p exit = nullptr;
+        std::unique_ptr<block_pool> pool;
 
         std::set<ltac::Register> _use_registers;
         std::set<ltac::FloatRegister> _use_float_registers;
         
         std::set<ltac::Register> _variable_registers;
         std::set<ltac::FloatRegister> _variable_float_registers;
+
+        std::set<ltac::Register> _clobbered_registers;
+        std::set<ltac::FloatRegister> _clobbered_float_registers;
+
+        std::unordered_map<std::shared_ptr<Variable>, basic_block_p> _clear_points;
         
         std::size_t last_pseudo_registers = 0;
         std::size_t last_float_pseudo_registers = 0;
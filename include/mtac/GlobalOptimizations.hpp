@@ -42,7 +42,7 @@ inline typename std::enable_if<Low, std::vector<ltac::Instruction>&>::type get_s
 }
 
 template<bool Low>
-inline typename std::enable_if<!Low, std::vector<mtac::Quadruple>&>::type get_statements(mtac::basic_block_p& B){
+inline typename std::enable_if<!Low, mtac::statement_list&>::type get_statements(mtac::basic_block_p& B){
     return B->statements;
 }
 
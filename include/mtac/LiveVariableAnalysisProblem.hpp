@@ -44,8 +44,8 @@ struct LiveVariableAnalysisProblem {
     void transfer(mtac::basic_block_p basic_block, ProblemDomain& in);
     void transfer(mtac::basic_block_p basic_block, mtac::Quadruple& statement, ProblemDomain& in);
     
-    std::unordered_map<mtac::basic_block_p, std::set<std::shared_ptr<Variable>>> def;
-    std::unordered_map<mtac::basic_block_p, std::set<std::shared_ptr<Variable>>> use;
+    mtac::block_map<std::set<std::shared_ptr<Variable>>> def;
+    mtac::block_map<std::set<std::shared_ptr<Variable>>> use;
 };
 
 bool operator==(const mtac::Domain<Values>& lhs, const mtac::Domain<Values>& rhs);
@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <iostream>
+#include <unordered_map>
 
 #include "mtac/Function.hpp"
 #include "mtac/call_graph.hpp"
@@ -48,6 +49,15 @@ struct Program {
 
     mtac::call_graph cg;
 
+    std::string profile_file;       /*!< The file where the instrumented program dumps its counters, empty if not instrumented */
+    bool profiled = false;          /*!< Indicates if the basic blocks and the call graph have execution counts */
+    std::size_t hot_frequency = 0;  /*!< The execution count from which a basic block is considered hot */
+    std::size_t specialized_size = 0; /*!< The number of statements added by the specialization of functions */
+
+    std::size_t original_size = 0;  /*!< The size of the program before inlining */
+    std::size_t inlined_size = 0;   /*!< The number of statements added by inlining */
+    std::unordered_map<std::string, std::size_t> original_sizes; /*!< The size of each function before inlining */
+
     /*!
      * Create a new Program
      */
@@ -13,6 +13,8 @@
 #include "variant.hpp"
 
 #include "mtac/forward.hpp"
+#include "mtac/block_pool.hpp"
+#include "mtac/statement_list.hpp"
 #include "mtac/Quadruple.hpp"
 
 #include "ltac/forward.hpp"
@@ -28,18 +30,19 @@ namespace mtac {
 /*!
  * \class basic_block
  * \brief A basic block in the MTAC representation. 
- * The basic blocks of a function are maintained in a doubly linked list. 
+ * The basic blocks of a function are stored in the block pool of the function, they only refer to each other by id. 
  */
 class basic_block {
     public:
-        typedef std::vector<mtac::Quadruple>::iterator iterator;
-        typedef std::vector<mtac::Quadruple>::reverse_iterator reverse_iterator;
+        typedef mtac::statement_list::iterator iterator;
+        typedef mtac::statement_list::reverse_iterator reverse_iterator;
 
         /*!
          * Create a new basic block with the given index. 
          * \param index The index of the basic block
+         * \param pool The pool of the function the block belongs to
          */
-        basic_block(int index);
+        basic_block(int index, block_pool& pool);
         
         /*!
          * Return an iterator to the first statement. 
@@ -94,19 +97,11 @@ class basic_block {
         /*!
          * \brief Return the MTAC statement with the given UID. 
          *
-         * Operation in O(n). The operation will fail if there are no MTAC statement with this UID in the basic block. 
+         * The statement is found with the uid index of the function. The operation will fail if there are no MTAC statement with this UID in the basic block. 
          * \return A reference to the MTAC statement with the given UID in the basic block. 
          */
         mtac::Quadruple& find(std::size_t uid);
 
-        /*!
-         * \brief Return the LTAC statement with the given UID. 
-         *
-         * Operation in O(n). The operation will fail if there are no LTAC statement with this UID in the basic block. 
-         * \return A reference to the LTAC statement with the given UID in the basic block. 
-         */
-        ltac::Instruction& find_low(std::size_t uid);
-
         /*!
          * \brief Return the number of MTAC statements of the basic blocks. 
          *
@@ -123,27 +118,55 @@ class basic_block {
          */
         std::size_t size_no_nop() const ;
 
+        /*!
+         * \brief Return the dense id of the basic block.
+         *
+         * The exit block has the id 0, the entry block the id 1 and the other blocks follow in creation order.
+         * \return the id of the basic block, to be used as an index in flat containers.
+         */
+        std::size_t id() const {
+            return index + 2;
+        }
+
+        /*!
+         * \brief Return the next basic block in the layout of the function, null if this is the last one.
+         */
+        std::shared_ptr<basic_block> next() const;
+
+        /*!
+         * \brief Return the previous basic block in the layout of the function, null if this is the first one.
+         */
+        std::shared_ptr<basic_block> prev() const;
+
+        /*!
+         * \brief Return the immediate dominator of this basic block, null if it has not been computed.
+         */
+        std::shared_ptr<basic_block> dominator() const;
+
+        /*!
+         * \brief Set the immediate dominator of this basic block.
+         */
+        void set_dominator(const std::shared_ptr<basic_block>& dominator);
+
         const int index;    /*!< The index of the block */
         unsigned int depth = 0;
+        std::size_t frequency = 0;  /*!< The number of executions of the block, only meaningful when the program has been profiled */
         std::string label;  /*!< The label of the block */
         std::shared_ptr<FunctionContext> context = nullptr;     /*!< The context of the enclosing function. */
 
-        std::vector<mtac::Quadruple> statements;    /*!< The MTAC statements inside the basic block. */
+        mtac::statement_list statements;    /*!< The MTAC statements inside the basic block. */
         
         std::vector<ltac::Instruction> l_statements;  /*!< The LTAC statements inside the basic block. */
 
-        /* Doubly-linked list  */
-
-        std::shared_ptr<basic_block> next = nullptr;     /*!< The next basic block in the doubly-linked list. */
-        std::shared_ptr<basic_block> prev = nullptr;     /*!< The previous basic block in the doubly-linked list. */
-
         /* Control Flow Graph */
-        std::vector<std::shared_ptr<basic_block>> successors;   //!< The basic block's predecessors in the CFG
-        std::vector<std::shared_ptr<basic_block>> predecessors; //!< The basic block's successors in the CFG
+        block_list successors;   //!< The basic block's successors in the CFG
+        block_list predecessors; //!< The basic block's predecessors in the CFG
 
-        /* Dominance tree */
-        
-        std::shared_ptr<basic_block> dominator = nullptr;     /*!< The immediate dominator of this basic block. */
+    private:
+        block_pool* pool;   //!< The pool of the function, null once the block has been removed
+        std::size_t dominator_id = block_pool::npos;
+
+        friend class block_pool;
 };
 
 typedef std::shared_ptr<basic_block> basic_block_p;
@@ -11,20 +11,26 @@
 #include <iterator>
 
 #include "mtac/forward.hpp"
+#include "mtac/basic_block.hpp"
 
 namespace eddic {
 
 namespace mtac {
 
+/*!
+ * \class basic_block_base_iterator
+ * \brief An iterator over the layout of the basic blocks of a function.
+ *
+ * The iterator points to a block and not to a position, it remains valid when blocks are inserted or removed elsewhere in the function.
+ */
 template<typename BB>
 class basic_block_base_iterator : public std::iterator<std::bidirectional_iterator_tag, BB> {
     public:
-        basic_block_base_iterator(BB current, BB prev) : current(current), prev(prev) {}
-        basic_block_base_iterator(const basic_block_base_iterator<BB>& it) : current(it.current), prev(it.prev) {}
+        basic_block_base_iterator(const block_pool* pool, BB current) : pool(pool), current(current) {}
 
         basic_block_base_iterator<BB>& operator++() {
-            prev = current;
-            current = current->next;
+            auto position = pool->position(current->id());
+            current = position == block_pool::npos ? nullptr : pool->at(position + 1);
             return *this;
         }
 
@@ -35,10 +41,12 @@ class basic_block_base_iterator : public std::iterator<std::bidirectional_iterat
         }
         
         basic_block_base_iterator<BB>& operator--() {
-            current = prev;
             if(current){
-                prev = current->prev;
+                current = pool->at(pool->position(current->id()) - 1);
+            } else {
+                current = pool->at(pool->size() - 1);
             }
+
             return *this;
         }
 
@@ -61,8 +69,8 @@ class basic_block_base_iterator : public std::iterator<std::bidirectional_iterat
         }
             
     private:
+        const block_pool* pool;
         BB current;
-        BB prev;
 };
 
 typedef basic_block_base_iterator<mtac::basic_block_p> basic_block_iterator;
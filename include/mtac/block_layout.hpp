@@ -0,0 +1,45 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_BLOCK_LAYOUT_H
+#define MTAC_BLOCK_LAYOUT_H
+
+#include "Options.hpp"
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \brief Reorder the basic blocks of each function to make the most likely successor of each block its fall through.
+ *
+ * The blocks are placed in chains following the most frequent edges, estimated from the profile if there is one
+ * or from the loop depth otherwise. The blocks never executed during profiling are moved at the end of the
+ * function. The branches are inverted or completed with jumps so that the semantics is not changed. This pass
+ * must be run after all the other optimizations.
+ */
+struct block_layout {
+    bool gate(std::shared_ptr<Configuration> configuration);
+    bool operator()(mtac::Program& program);
+};
+
+template<>
+struct pass_traits<block_layout> {
+    STATIC_CONSTANT(pass_type, type, pass_type::IPA);
+    STATIC_STRING(name, "block_layout");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
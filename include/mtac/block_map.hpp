@@ -0,0 +1,55 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_BLOCK_MAP_H
+#define MTAC_BLOCK_MAP_H
+
+#include <deque>
+
+#include "mtac/basic_block.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \class block_map
+ * \brief A map from the basic blocks of a function to values, stored in a flat container indexed by the block ids.
+ *
+ * The container grows on demand so that the blocks created after its construction can still be used as keys. As
+ * with std::unordered_map, the references to the values remain valid when new blocks are added.
+ */
+template<typename T>
+class block_map {
+    public:
+        block_map() = default;
+
+        /*!
+         * Create a map with room for the given number of block ids.
+         * \param capacity The number of ids to reserve.
+         */
+        explicit block_map(std::size_t capacity) : values(capacity) {}
+
+        T& operator[](const mtac::basic_block_p& block){
+            auto id = block->id();
+
+            if(id >= values.size()){
+                values.resize(id + 1);
+            }
+
+            return values[id];
+        }
+
+    private:
+        std::deque<T> values;
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -0,0 +1,255 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_BLOCK_POOL_H
+#define MTAC_BLOCK_POOL_H
+
+#include <deque>
+#include <vector>
+#include <iterator>
+#include <unordered_map>
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \class block_pool
+ * \brief The storage of the basic blocks of a function.
+ *
+ * The blocks are stored by id, the graph and the dominance tree only refer to them by id. The order of the blocks
+ * in the instruction stream is kept in a layout array with the position of each block, so that the neighbours
+ * and the position of a block are found in O(1). The pool also indexes the MTAC statements of the blocks by uid.
+ */
+class block_pool {
+    public:
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        typedef std::pair<std::size_t, std::size_t> statement_position;    //!< The id of the block and the index of the statement inside it
+
+        block_pool() = default;
+
+        //The blocks keep a pointer to their pool
+        block_pool(const block_pool& rhs) = delete;
+        block_pool& operator=(const block_pool& rhs) = delete;
+
+        ~block_pool();
+
+        /*!
+         * \brief Return the block with the given id, null if it has been removed.
+         */
+        const basic_block_p& operator[](std::size_t id) const {
+            return id < blocks.size() ? blocks[id] : null_block;
+        }
+
+        /*!
+         * \brief Add a new block to the pool, it is not part of the layout until it is inserted.
+         */
+        void add(const basic_block_p& block);
+
+        /*!
+         * \brief Insert a block of the pool in the layout at the given position.
+         *
+         * The position of the following blocks is updated, this runs in O(n).
+         */
+        void insert(std::size_t position, const basic_block_p& block);
+
+        /*!
+         * \brief Remove the block from the layout and release it from the pool.
+         */
+        void release(const basic_block_p& block);
+
+        /*!
+         * \brief Replace the layout with the given order of the blocks.
+         */
+        void relayout(const std::vector<basic_block_p>& order);
+
+        /*!
+         * \brief Return the position of the block with the given id in the layout, npos if it is not laid out.
+         */
+        std::size_t position(std::size_t id) const {
+            return id < positions.size() ? positions[id] : npos;
+        }
+
+        /*!
+         * \brief Return the block at the given position in the layout, null if there are none.
+         */
+        const basic_block_p& at(std::size_t position) const {
+            return position < layout.size() ? blocks[layout[position]] : null_block;
+        }
+
+        /*!
+         * \brief Return the number of blocks in the layout.
+         */
+        std::size_t size() const {
+            return layout.size();
+        }
+
+        /*!
+         * \brief Return the position of the statement with the given uid, null if it is not indexed.
+         */
+        const statement_position* find(std::size_t uid) const {
+            auto it = uids.find(uid);
+            return it == uids.end() ? nullptr : &it->second;
+        }
+
+        void index(std::size_t uid, std::size_t id, std::size_t i){
+            //The statements that have been moved from have no uid
+            if(uid){
+                uids[uid] = std::make_pair(id, i);
+            }
+        }
+
+        /*!
+         * \brief Remove the statement from the index if it is still indexed in the given block.
+         */
+        void unindex(std::size_t uid, std::size_t id){
+            auto it = uids.find(uid);
+
+            if(it != uids.end() && it->second.first == id){
+                uids.erase(it);
+            }
+        }
+
+    private:
+        std::deque<basic_block_p> blocks;
+        std::vector<std::size_t> layout;
+        std::vector<std::size_t> positions;
+        std::unordered_map<std::size_t, statement_position> uids;
+
+        static const basic_block_p null_block;
+
+        void renumber(std::size_t first);
+};
+
+/*!
+ * \class block_list
+ * \brief A list of basic blocks of the same function, stored by id.
+ *
+ * This is used for the edges of the control flow graph. The blocks cannot be modified through the iterators, set() must be used.
+ */
+class block_list {
+    public:
+        class const_iterator : public std::iterator<std::bidirectional_iterator_tag, basic_block_p, std::ptrdiff_t, const basic_block_p*, const basic_block_p&> {
+            public:
+                const_iterator(const block_pool* pool, std::vector<std::size_t>::const_iterator it) : pool(pool), it(it) {}
+
+                const basic_block_p& operator*() const {
+                    return (*pool)[*it];
+                }
+
+                const basic_block_p* operator->() const {
+                    return &(*pool)[*it];
+                }
+
+                const_iterator& operator++(){
+                    ++it;
+                    return *this;
+                }
+
+                const_iterator operator++(int){
+                    const_iterator tmp(*this);
+                    ++it;
+                    return tmp;
+                }
+
+                const_iterator& operator--(){
+                    --it;
+                    return *this;
+                }
+
+                const_iterator operator--(int){
+                    const_iterator tmp(*this);
+                    --it;
+                    return tmp;
+                }
+
+                bool operator==(const const_iterator& rhs) const {
+                    return it == rhs.it;
+                }
+
+                bool operator!=(const const_iterator& rhs) const {
+                    return it != rhs.it;
+                }
+
+            private:
+                const block_pool* pool;
+                std::vector<std::size_t>::const_iterator it;
+        };
+
+        typedef const_iterator iterator;
+
+        block_list() = default;
+        explicit block_list(const block_pool* pool) : pool(pool) {}
+
+        const_iterator begin() const {
+            return const_iterator(pool, ids.begin());
+        }
+
+        const_iterator end() const {
+            return const_iterator(pool, ids.end());
+        }
+
+        const basic_block_p& operator[](std::size_t i) const {
+            return (*pool)[ids[i]];
+        }
+
+        const basic_block_p& front() const {
+            return (*pool)[ids.front()];
+        }
+
+        const basic_block_p& back() const {
+            return (*pool)[ids.back()];
+        }
+
+        std::size_t size() const {
+            return ids.size();
+        }
+
+        bool empty() const {
+            return ids.empty();
+        }
+
+        void push_back(const basic_block_p& block);
+
+        void pop_back(){
+            ids.pop_back();
+        }
+
+        /*!
+         * \brief Replace the i-th block of the list.
+         */
+        void set(std::size_t i, const basic_block_p& block);
+
+        /*!
+         * \brief Replace all the occurrences of a block by another one.
+         */
+        void replace(const basic_block_p& block, const basic_block_p& replacement);
+
+        /*!
+         * \brief Remove all the occurrences of the block from the list.
+         */
+        void remove(const basic_block_p& block);
+
+        bool contains(const basic_block_p& block) const;
+
+        void clear(){
+            ids.clear();
+        }
+
+    private:
+        const block_pool* pool = nullptr;
+        std::vector<std::size_t> ids;
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
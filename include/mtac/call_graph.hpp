@@ -44,9 +44,10 @@ typedef std::shared_ptr<call_graph_node> call_graph_node_p;
 struct call_graph_edge {
     call_graph_node_p source;
     call_graph_node_p target;
-    std::size_t count;
+    std::size_t count;      /*!< The number of call sites of target in source */
+    std::size_t frequency;  /*!< The number of executed calls, only meaningful when the program has been profiled */
 
-    call_graph_edge(call_graph_node_p source, call_graph_node_p target) : source(source), target(target), count(0){
+    call_graph_edge(call_graph_node_p source, call_graph_node_p target) : source(source), target(target), count(0), frequency(0){
         //Nothing to init
     }
 };
@@ -87,6 +88,16 @@ class call_graph {
          */
         std::vector<std::reference_wrapper<eddic::Function>> topological_order();
 
+        /*!
+         * \brief Compute the strongly connected components of the functions reachable from the entry.
+         *
+         * The components are computed with Tarjan's algorithm in O(|V| + |E|). A component is returned
+         * only after all the components it calls, so the list goes from the callees to the callers.
+         *
+         * \return The list of strongly connected components, from the bottom to the top of the call graph.
+         */
+        std::vector<std::vector<std::reference_wrapper<eddic::Function>>> strongly_connected_components();
+
         bool is_reachable(eddic::Function& function);
 
     private:
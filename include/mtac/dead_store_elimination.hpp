@@ -5,35 +5,40 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
-#ifndef MTAC_GLOBAL_CSE_H
-#define MTAC_GLOBAL_CSE_H
+#ifndef MTAC_DEAD_STORE_ELIMINATION_H
+#define MTAC_DEAD_STORE_ELIMINATION_H
 
 #include <memory>
+#include <unordered_set>
 
 #include <boost/utility.hpp>
 
 #define STATIC_CONSTANT(type,name,value) BOOST_STATIC_CONSTANT(type, name = value)
 
-#include "mtac/cse.hpp"
 #include "mtac/pass_traits.hpp"
 #include "mtac/DataFlowProblem.hpp"
 #include "mtac/forward.hpp"
-#include "mtac/Quadruple.hpp"
-#include "mtac/EscapeAnalysis.hpp"
+#include "mtac/Offset.hpp"
 
 namespace eddic {
 
 namespace mtac {
 
-typedef std::set<expression> Expressions;
+typedef std::unordered_set<mtac::Offset, mtac::OffsetHash> Stores;
 
-class global_cse {
+/*!
+ * \brief Remove the stores into the local aggregates that are overwritten before being read. 
+ *
+ * The data-flow problem computes backward the offsets of the non-escaping aggregates that are stored
+ * again on every path before any read of them.
+ */
+class dead_store_elimination {
     public:
         //The type of data managed
-        typedef Domain<Expressions> ProblemDomain;
+        typedef Domain<Stores> ProblemDomain;
 
         //The direction
-        STATIC_CONSTANT(DataFlowType, Type, DataFlowType::Fast_Forward_Block);
+        STATIC_CONSTANT(DataFlowType, Type, DataFlowType::Fast_Backward_Block);
         STATIC_CONSTANT(bool, Low, false);
         
         ProblemDomain Init(mtac::Function& function);
@@ -41,28 +46,23 @@ class global_cse {
 
         void meet(ProblemDomain& in, const ProblemDomain& out);
         void transfer(mtac::basic_block_p basic_block, ProblemDomain& in);
+        void transfer(mtac::Quadruple& quadruple, ProblemDomain& in);
         bool optimize(mtac::Function& function, std::shared_ptr<DataFlowResults<ProblemDomain>> results);
 
-        boost::optional<Expressions> init;
-
     private:
-        std::unordered_set<std::size_t> optimized;
-        mtac::Function* function;
-
-        std::unordered_map<mtac::basic_block_p, std::set<mtac::expression>> Eval;
-        std::unordered_map<mtac::basic_block_p, std::set<mtac::expression>> Kill;
+        std::unordered_set<std::shared_ptr<Variable>> candidates;
 };
 
 template<>
-struct pass_traits<global_cse> {
+struct pass_traits<dead_store_elimination> {
     STATIC_CONSTANT(pass_type, type, pass_type::DATA_FLOW);
-    STATIC_STRING(name, "common_subexpression_elimination");
+    STATIC_STRING(name, "dead_store_elimination");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
 };
 
-bool operator==(const mtac::Domain<Expressions>& lhs, const mtac::Domain<Expressions>& rhs);
-bool operator!=(const mtac::Domain<Expressions>& lhs, const mtac::Domain<Expressions>& rhs);
+bool operator==(const mtac::Domain<Stores>& lhs, const mtac::Domain<Stores>& rhs);
+bool operator!=(const mtac::Domain<Stores>& lhs, const mtac::Domain<Stores>& rhs);
 
 } //end of mtac
 
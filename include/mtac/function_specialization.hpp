@@ -0,0 +1,54 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_FUNCTION_SPECIALIZATION_H
+#define MTAC_FUNCTION_SPECIALIZATION_H
+
+#include <memory>
+
+#include "Options.hpp"
+#include "Platform.hpp"
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \brief Clone the functions called with constant arguments from hot call sites.
+ *
+ * The call sites passing the same integer constants are redirected to a copy of the function where the
+ * constants replace the parameters, the other optimizations then specialize the body of the copy. The size
+ * of the copies is limited by a budget relative to the size of the program.
+ */
+struct specialize_functions {
+    bool gate(std::shared_ptr<Configuration> configuration);
+    bool operator()(mtac::Program& program);
+
+    void set_platform(Platform platform);
+    void set_configuration(std::shared_ptr<Configuration> configuration);
+
+    private:
+        Platform platform;
+        std::shared_ptr<Configuration> configuration;
+};
+
+template<>
+struct pass_traits<specialize_functions> {
+    STATIC_CONSTANT(pass_type, type, pass_type::IPA);
+    STATIC_STRING(name, "specialize_functions");
+    STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_PLATFORM | PROPERTY_CONFIGURATION);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
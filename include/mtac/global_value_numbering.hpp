@@ -0,0 +1,41 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_GLOBAL_VALUE_NUMBERING_H
+#define MTAC_GLOBAL_VALUE_NUMBERING_H
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \brief Eliminate the redundant expressions with a value numbering over the dominator tree.
+ *
+ * The constants, the copies, the commutative operators and the DOT loads from the non-escaping aggregates
+ * are numbered. A computation whose value is already held by a variable is replaced by a copy of it,
+ * otherwise the dominating computation is saved in a new temporary.
+ */
+struct global_value_numbering {
+    bool operator()(mtac::Function& function);
+};
+
+template<>
+struct pass_traits<global_value_numbering> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "global_value_numbering");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
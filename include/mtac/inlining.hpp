@@ -17,16 +17,27 @@ namespace eddic {
 
 namespace mtac {
 
+/*!
+ * \brief Inline the call sites of the call graph from the bottom to the top.
+ *
+ * The strongly connected components of the call graph are processed from the callees to the callers and the
+ * call sites of each function are inlined by decreasing benefit. The growth of each function and of the whole
+ * program is limited by the inline-function-growth and inline-unit-growth options.
+ */
 struct inline_functions {
     bool gate(std::shared_ptr<Configuration> configuration);
+    void set_configuration(std::shared_ptr<Configuration> configuration);
     bool operator()(mtac::Program& program);
+
+    private:
+        std::shared_ptr<Configuration> configuration;
 };
 
 template<>
 struct pass_traits<inline_functions> {
     STATIC_CONSTANT(pass_type, type, pass_type::IPA);
     STATIC_STRING(name, "inline_functions");
-    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_CONFIGURATION);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
 };
 
@@ -0,0 +1,54 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_LAZY_CODE_MOTION_H
+#define MTAC_LAZY_CODE_MOTION_H
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/DataFlowDomain.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+//One bit for each candidate expression of the function
+typedef boost::dynamic_bitset<> ExpressionBits;
+
+/*!
+ * \brief Partial redundancy elimination by lazy code motion.
+ *
+ * The computations are placed on the edges where they are earliest anticipated and then postponed as far as
+ * possible to keep the live ranges of the temporaries short. The computations that become redundant are
+ * replaced by copies of the temporaries. An expression that would need to be inserted on a critical edge
+ * is left untouched.
+ *
+ * Reference: A Variation of Knoop, Ruthing, and Steffen's Lazy Code Motion by Karl-Heinz Drechsler and
+ * Manfred P. Stadel
+ */
+struct lazy_code_motion {
+    bool operator()(mtac::Function& function);
+};
+
+template<>
+struct pass_traits<lazy_code_motion> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "lazy_code_motion");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+};
+
+bool operator==(const mtac::Domain<ExpressionBits>& lhs, const mtac::Domain<ExpressionBits>& rhs);
+bool operator!=(const mtac::Domain<ExpressionBits>& lhs, const mtac::Domain<ExpressionBits>& rhs);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
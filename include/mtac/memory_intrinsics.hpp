@@ -0,0 +1,72 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_MEMORY_INTRINSICS_H
+#define MTAC_MEMORY_INTRINSICS_H
+
+#include <memory>
+
+#include "Function.hpp"
+#include "Type.hpp"
+
+#include "mtac/Argument.hpp"
+#include "mtac/Operator.hpp"
+#include "mtac/Quadruple.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+//Mangled names of the runtime helpers behind the memcpy and memset intrinsics
+static const char* const memcpy_helper = "_F6memcpyPIPIIII";
+static const char* const memset_helper = "_F6memsetPIIIII";
+
+//Constant sizes up to this number of elements are expanded inline instead of calling the helper
+static const int memory_intrinsic_unroll_limit = 8;
+
+inline bool is_memory_intrinsic(const eddic::Function& function){
+    return function.standard() && (function.mangled_name() == memcpy_helper || function.mangled_name() == memset_helper);
+}
+
+/*!
+ * \brief Emit a call to the memcpy helper.
+ *
+ * The offsets are in bytes from the start of the arrays (size slot included). The copy is done forward, byte per byte.
+ * \param target The function, basic block or statements vector where the call is emitted.
+ */
+template<typename Target>
+void emit_memcpy(Target& target, eddic::Function& helper, mtac::Argument dest, mtac::Argument dest_offset, mtac::Argument src, mtac::Argument src_offset, mtac::Argument bytes){
+    target.emplace_back(mtac::Operator::PARAM, bytes, "bytes", helper);
+    target.emplace_back(mtac::Operator::PARAM, src_offset, "src_offset", helper);
+    target.emplace_back(mtac::Operator::PARAM, dest_offset, "dest_offset", helper);
+    target.emplace_back(mtac::Operator::PPARAM, src, "src", helper);
+    target.emplace_back(mtac::Operator::PPARAM, dest, "dest", helper);
+    target.emplace_back(mtac::Operator::CALL, helper);
+}
+
+/*!
+ * \brief Emit a call to the memset helper.
+ *
+ * The offset is in bytes from the start of the array (size slot included). The value must already be an INT argument.
+ * \param target The function, basic block or statements vector where the call is emitted.
+ * \param width The size of an element, 1 means that the low byte of value is replicated.
+ */
+template<typename Target>
+void emit_memset(Target& target, eddic::Function& helper, mtac::Argument dest, mtac::Argument dest_offset, mtac::Argument value, mtac::Argument bytes, int width){
+    target.emplace_back(mtac::Operator::PARAM, width, "width", helper);
+    target.emplace_back(mtac::Operator::PARAM, bytes, "bytes", helper);
+    target.emplace_back(mtac::Operator::PARAM, value, "value", helper);
+    target.emplace_back(mtac::Operator::PARAM, dest_offset, "dest_offset", helper);
+    target.emplace_back(mtac::Operator::PPARAM, dest, "dest", helper);
+    target.emplace_back(mtac::Operator::CALL, helper);
+}
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
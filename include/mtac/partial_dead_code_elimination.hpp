@@ -5,8 +5,8 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
-#ifndef MTAC_LOCAL_CSE_H
-#define MTAC_LOCAL_CSE_H
+#ifndef MTAC_PARTIAL_DEAD_CODE_ELIMINATION_H
+#define MTAC_PARTIAL_DEAD_CODE_ELIMINATION_H
 
 #include "mtac/pass_traits.hpp"
 #include "mtac/forward.hpp"
@@ -15,14 +15,17 @@ namespace eddic {
 
 namespace mtac {
 
-struct local_cse {
+/*!
+ * \brief Sink the computations that are only live in one of the successors of a branch into this successor.
+ */
+struct partial_dead_code_elimination {
     bool operator()(mtac::Function& function);
 };
 
 template<>
-struct pass_traits<local_cse> {
+struct pass_traits<partial_dead_code_elimination> {
     STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
-    STATIC_STRING(name, "local_cse");
+    STATIC_STRING(name, "partial_dead_code_elimination");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
 };
@@ -0,0 +1,54 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_PROFILE_H
+#define MTAC_PROFILE_H
+
+#include <string>
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \brief Add a counter to each basic block of the program.
+ *
+ * The counters are stored in a global array that the program dumps to the given file when main returns. The
+ * blocks are numbered in the order of the functions and of the blocks, before any optimization, so that the
+ * same numbering can be recomputed when the profile is used.
+ * \param program The program to instrument.
+ * \param file The file where the counters are dumped.
+ */
+void instrument_profile(mtac::Program& program, const std::string& file);
+
+/*!
+ * \brief Load the counters dumped by an instrumented build of the same program.
+ *
+ * The execution count of each basic block and of each call graph edge are filled. If the profile does not match
+ * the program, a warning is emitted and the program is left unprofiled.
+ * \param program The program to annotate.
+ * \param file The profile file.
+ */
+void load_profile(mtac::Program& program, const std::string& file);
+
+/*!
+ * \brief Indicates if the given block has never been executed during profiling.
+ */
+bool cold(const mtac::Program& program, const mtac::basic_block_p& bb);
+
+/*!
+ * \brief Indicates if the given block is one of the most executed blocks of the profile.
+ */
+bool hot(const mtac::Program& program, const mtac::basic_block_p& bb);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -0,0 +1,155 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_STATEMENT_LIST_H
+#define MTAC_STATEMENT_LIST_H
+
+#include <vector>
+
+#include "mtac/block_pool.hpp"
+#include "mtac/Quadruple.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \class statement_list
+ * \brief The MTAC statements of a basic block.
+ *
+ * This has the interface of a std::vector, but each insertion and removal updates the uid index of the function
+ * with the position of the statements that are added or shifted. A statement must be replaced by another one with
+ * replace(), the statements assigned through a reference are only indexed again by the next find() in this block.
+ */
+class statement_list {
+    public:
+        typedef std::vector<mtac::Quadruple> container_type;
+
+        typedef container_type::value_type value_type;
+        typedef container_type::size_type size_type;
+        typedef container_type::difference_type difference_type;
+        typedef container_type::reference reference;
+        typedef container_type::const_reference const_reference;
+        typedef container_type::iterator iterator;
+        typedef container_type::const_iterator const_iterator;
+        typedef container_type::reverse_iterator reverse_iterator;
+        typedef container_type::const_reverse_iterator const_reverse_iterator;
+
+        statement_list() = default;
+        statement_list(block_pool* pool, std::size_t id) : pool(pool), id(id) {}
+
+        //A copy is not part of any block
+        statement_list(const statement_list& rhs) : statements(rhs.statements) {}
+
+        statement_list(statement_list&& rhs) {
+            rhs.unindex(0);
+            statements = std::move(rhs.statements);
+        }
+
+        statement_list& operator=(const statement_list& rhs);
+        statement_list& operator=(statement_list&& rhs);
+        statement_list& operator=(container_type&& rhs);
+
+        iterator begin(){ return statements.begin(); }
+        iterator end(){ return statements.end(); }
+        const_iterator begin() const { return statements.begin(); }
+        const_iterator end() const { return statements.end(); }
+
+        reverse_iterator rbegin(){ return statements.rbegin(); }
+        reverse_iterator rend(){ return statements.rend(); }
+        const_reverse_iterator rbegin() const { return statements.rbegin(); }
+        const_reverse_iterator rend() const { return statements.rend(); }
+
+        reference operator[](size_type i){ return statements[i]; }
+        const_reference operator[](size_type i) const { return statements[i]; }
+
+        reference front(){ return statements.front(); }
+        const_reference front() const { return statements.front(); }
+        reference back(){ return statements.back(); }
+        const_reference back() const { return statements.back(); }
+
+        size_type size() const { return statements.size(); }
+        bool empty() const { return statements.empty(); }
+        size_type capacity() const { return statements.capacity(); }
+
+        void reserve(size_type capacity){ statements.reserve(capacity); }
+        void shrink_to_fit(){ statements.shrink_to_fit(); }
+
+        void push_back(const mtac::Quadruple& quadruple){
+            statements.push_back(quadruple);
+            index(statements.size() - 1);
+        }
+
+        void push_back(mtac::Quadruple&& quadruple){
+            statements.push_back(std::move(quadruple));
+            index(statements.size() - 1);
+        }
+
+        template< class... Args >
+        void emplace_back(Args&&... args){
+            statements.emplace_back(std::forward<Args>(args)...);
+            index(statements.size() - 1);
+        }
+
+        void pop_back();
+
+        iterator insert(const_iterator position, const mtac::Quadruple& quadruple);
+        iterator insert(const_iterator position, mtac::Quadruple&& quadruple);
+
+        template<typename InputIt>
+        iterator insert(const_iterator position, InputIt first, InputIt last){
+            auto offset = position - statements.cbegin();
+            statements.insert(position, first, last);
+            reindex(offset);
+            return statements.begin() + offset;
+        }
+
+        iterator erase(const_iterator position);
+        iterator erase(const_iterator first, const_iterator last);
+
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last){
+            unindex(0);
+            statements.assign(first, last);
+            reindex(0);
+        }
+
+        void clear();
+
+        /*!
+         * \brief Replace a statement of the list by another one.
+         * \param statement The statement to replace, it must be part of the list.
+         * \param replacement The new statement, it keeps its uid.
+         */
+        void replace(mtac::Quadruple& statement, mtac::Quadruple&& replacement);
+
+        /*!
+         * \brief Return an iterator to the statement with the given uid in this list, end() if it is not part of it.
+         *
+         * The statement is found with the uid index of the function, in O(1) unless the statement has been replaced
+         * through a reference since it was indexed.
+         */
+        iterator find(std::size_t uid);
+
+    private:
+        block_pool* pool = nullptr;
+        std::size_t id = 0;
+        container_type statements;
+
+        void index(std::size_t i);
+        void reindex(std::size_t first);
+        void unindex(std::size_t first);
+        iterator indexed(std::size_t uid);
+
+        friend class block_pool;
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
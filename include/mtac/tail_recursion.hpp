@@ -0,0 +1,49 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef MTAC_TAIL_RECURSION_H
+#define MTAC_TAIL_RECURSION_H
+
+#include <memory>
+
+#include "Options.hpp"
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \brief Transform the recursive calls of a function to itself in tail position into a loop.
+ *
+ * The arguments are computed in temporaries, then assigned to the parameters and the call is replaced by a jump to
+ * the beginning of the function.
+ */
+struct tail_recursion {
+    mtac::Program& program;
+
+    tail_recursion(mtac::Program& program) : program(program){}
+
+    bool gate(std::shared_ptr<Configuration> configuration);
+    bool operator()(mtac::Function& function);
+};
+
+template<>
+struct pass_traits<tail_recursion> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "tail_recursion");
+    STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_PROGRAM);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -32,6 +32,18 @@ struct SpiritParser {
      * \return true if the file was valid, false otherwise
      */
     bool parse(const std::string& file, ast::SourceFile& program, std::shared_ptr<GlobalContext> context);
+
+    /*!
+     * \brief Parse the given source file and fills the given Abstract Syntax Tree, reporting the errors on the given streams.
+     *
+     * This version can be called from several threads at the same time, it is not timed.
+     * \param file The path to the file to parse.
+     * \param program The Abstract Syntax Tree root to fill.
+     * \param out The stream where the invalid files are reported.
+     * \param err The stream where the syntax errors are reported.
+     * \return true if the file was valid, false otherwise
+     */
+    bool parse(const std::string& file, ast::SourceFile& program, std::shared_ptr<GlobalContext> context, std::ostream& out, std::ostream& err);
 };
 
 }
@@ -10,6 +10,8 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <iostream> //Temporary
 
 #include "boost_cfg.hpp"
@@ -25,6 +27,10 @@
 
 namespace boost { namespace spirit { namespace x3 {
 
+/*
+ * The position of a node in its source file. id_first and id_last are the offsets of the node in the file,
+ * the lines and the columns are only computed when an error is reported.
+ */
 struct file_position_tagged : position_tagged {
     int id_file = -1;
 
@@ -45,23 +51,24 @@ namespace x3_grammar {
     template <typename Iterator>
     using error_handler = boost::spirit::x3::error_handler<Iterator>;
 
-    typedef std::string::const_iterator iterator_type;
+    typedef const char* iterator_type;
     typedef boost::spirit::x3::phrase_parse_context<boost::spirit::x3::ascii::space_type>::type phrase_context_type;
     typedef error_handler<iterator_type> error_handler_type;
 
-    struct global_error_handler {
-        void register_handler(iterator_type it, iterator_type end, std::string file){
-            error_handlers.emplace_back(it, end, std::cerr, std::move(file));
-        }
-
-        error_handler_type& current(){
-            return error_handlers.back();
-        }
+    /*!
+     * \brief The error handler of one source file, used while this file is parsed.
+     *
+     * Each parse has its own, so that several files can be parsed at the same time.
+     */
+    struct file_error_handler {
+        error_handler_type& handler;
+        int file;
+        std::ostream& out;  //Where the syntax errors of this parse are reported
 
         template<typename AST, std::enable_if_t<std::is_base_of<boost::spirit::x3::file_position_tagged, AST>::value, int> = 42>
         void tag(AST& t, iterator_type it, iterator_type end){
-            t.id_file = error_handlers.size() - 1;
-            error_handlers[t.id_file].tag(t, it, end);
+            t.id_file = file;
+            handler.tag(t, it, end);
         }
 
         template<typename AST, std::enable_if_t<!std::is_base_of<boost::spirit::x3::file_position_tagged, AST>::value, int> = 42>
@@ -71,6 +78,17 @@ namespace x3_grammar {
 
         void operator()(iterator_type err_pos, const std::string& message);
         void operator()(iterator_type err_pos, iterator_type err_last, const std::string& message);
+    };
+
+    struct global_error_handler {
+        /*!
+         * Register the error handler of the given source file. This can be called from several threads.
+         * \param file The index of the file in the global context.
+         * \param out The stream where the syntax errors of the parse are reported.
+         * \return The error handler to use to parse the file.
+         */
+        file_error_handler register_handler(std::size_t file, iterator_type it, iterator_type end, std::string file_name, std::ostream& out);
+
         void operator()(const boost::spirit::x3::file_position_tagged& t, const std::string& message);
 
         std::string to_string(const boost::spirit::x3::file_position_tagged& t, const std::string& message = "");
@@ -78,7 +96,12 @@ namespace x3_grammar {
         void semantical_exception(const std::string& message, const boost::spirit::x3::file_position_tagged& t);
 
     private:
-        std::vector<error_handler_type> error_handlers;
+        std::mutex mutex;
+
+        //The references to the handlers must stay valid when others are added
+        std::unordered_map<std::size_t, error_handler_type> error_handlers;
+
+        error_handler_type& handler(std::size_t file);
     };
 
     // tag used to get our error handler from the context
@@ -32,12 +32,18 @@ struct error_handler {
       : err_out(err_out)
       , file(file)
       , tabs(tabs)
-      , pos_cache(first, last) {}
+      , first_(first)
+      , last_(last) {}
 
     typedef void result_type;
 
     void operator()(position_tagged pos, std::string const& message) const {
-        auto where = pos_cache.position_of(pos);
+        if(!is_tagged(pos)){
+            print_untagged(err_out, message);
+            return;
+        }
+
+        auto where = position_of(pos);
         (*this)(err_out, where.begin(), where.end(), message);
     }
 
@@ -51,14 +57,20 @@ struct error_handler {
 
     std::string to_string(position_tagged pos, std::string const& message){
         std::stringstream ss;
-        auto where = pos_cache.position_of(pos);
+
+        if(!is_tagged(pos)){
+            print_untagged(ss, message);
+            return ss.str();
+        }
+
+        auto where = position_of(pos);
         (*this)(ss, where.begin(), where.end(), message);
         return ss.str();
     }
 
     void operator()(std::ostream& stream, Iterator err_pos, std::string const& error_message) const {
-        Iterator first = pos_cache.first();
-        Iterator last = pos_cache.last();
+        Iterator first = first_;
+        Iterator last = last_;
 
         // make sure err_pos does not point to white space
         skip_whitespace(err_pos, last);
@@ -77,8 +89,8 @@ struct error_handler {
     }
 
     void operator()(std::ostream& stream, Iterator err_first, Iterator err_last, std::string const& error_message) const {
-        Iterator first = pos_cache.first();
-        Iterator last = pos_cache.last();
+        Iterator first = first_;
+        Iterator last = last_;
 
         // make sure err_pos does not point to white space
         skip_whitespace(err_first, last);
@@ -97,13 +109,25 @@ struct error_handler {
         stream << " <<-- Here" << std::endl;
     }
 
+    //The offsets are stored directly in the node, there is no cache of positions
     template <typename AST>
     void tag(AST& ast, Iterator first, Iterator last){
-        return pos_cache.annotate(ast, first, last);
+        ast.id_first = static_cast<int>(first - first_);
+        ast.id_last = static_cast<int>(last - first_);
     }
 
+    //The nodes created after the parsing (templates, transformations) have no offsets
+    bool is_tagged(position_tagged pos) const {
+        return pos.id_first >= 0 && pos.id_first <= pos.id_last && pos.id_last <= last_ - first_;
+    }
+
+    //An untagged node is mapped to the start of the file
     boost::iterator_range<Iterator> position_of(position_tagged pos) const {
-        return pos_cache.position_of(pos);
+        if(!is_tagged(pos)){
+            return boost::make_iterator_range(first_, first_);
+        }
+
+        return boost::make_iterator_range(first_ + pos.id_first, first_ + pos.id_last);
     }
 
 private:
@@ -112,6 +136,11 @@ private:
         stream << "In file " << file << ", " << "line " << line << ':' << std::endl;
     }
 
+    void print_untagged(std::ostream& stream, std::string const& message) const {
+        stream << "In file " << file << ", unknown position:" << std::endl;
+        stream << message << std::endl;
+    }
+
     void print_line(std::ostream& stream, Iterator start, Iterator last) const {
         auto end = start;
         while (end != last) {
@@ -175,7 +204,7 @@ private:
         std::size_t line { 1 };
         typename std::iterator_traits<Iterator>::value_type prev { 0 };
 
-        for (Iterator pos = pos_cache.first(); pos != i; ++pos) {
+        for (Iterator pos = first_; pos != i; ++pos) {
             auto c = *pos;
             switch (c) {
             case '\n':
@@ -196,7 +225,8 @@ private:
     std::ostream& err_out;
     std::string file;
     int tabs;
-    position_cache<std::vector<Iterator>> pos_cache;
+    Iterator first_;
+    Iterator last_;
 };
 
 }}}
@@ -19,6 +19,8 @@ class statistics {
         typedef Counters::const_iterator iterator;
 
         void inc_counter(const std::string& a);
+        void add_counter(const std::string& a, std::size_t value);
+        void set_counter(const std::string& a, std::size_t value);
         std::size_t counter(const std::string& a) const;
 
         iterator begin() const;
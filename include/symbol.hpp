@@ -0,0 +1,69 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <string>
+#include <functional>
+#include <iosfwd>
+
+namespace eddic {
+
+/*!
+ * \class symbol
+ * \brief An interned string.
+ *
+ * All the symbols with the same characters share the same storage, therefore the comparison and
+ * the hash of symbols are O(1). The characters are hashed only once, when the symbol is created.
+ */
+class symbol {
+    public:
+        symbol();
+        symbol(const std::string& value);
+        symbol(const char* value);
+
+        const std::string& str() const {
+            return *value;
+        }
+
+        operator const std::string&() const {
+            return *value;
+        }
+
+        bool operator==(const symbol& rhs) const {
+            return value == rhs.value;
+        }
+
+        bool operator!=(const symbol& rhs) const {
+            return value != rhs.value;
+        }
+
+        std::size_t hash() const {
+            return std::hash<const std::string*>()(value);
+        }
+
+    private:
+        const std::string* value;
+};
+
+std::ostream& operator<<(std::ostream& stream, const symbol& symbol);
+
+} //end of eddic
+
+namespace std {
+
+template<>
+struct hash<eddic::symbol> {
+    std::size_t operator()(const eddic::symbol& symbol) const {
+        return symbol.hash();
+    }
+};
+
+} //end of std
+
+#endif
@@ -9,6 +9,7 @@
 #define TIMING_H
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "Options.hpp"
@@ -22,6 +23,7 @@ class timing_system {
         void display();
 
     private:
+        std::mutex mutex;
         std::unordered_map<std::string, double> timings;
 };
 
@@ -30,6 +30,7 @@
 #include "mtac/RegisterAllocation.hpp"
 #include "mtac/reference_resolver.hpp"
 #include "mtac/WarningsEngine.hpp"
+#include "mtac/profile.hpp"
 
 using namespace eddic;
 
@@ -119,6 +120,11 @@ int Compiler::compile_only(const std::string& file, Platform platform, std::shar
         program->context->timing().display();
     }
 
+    //The back end releases the contexts of the functions it generates, this releases the others
+    if(program){
+        program->context->release_function_contexts();
+    }
+
     return code;
 }
 
@@ -129,6 +135,8 @@ std::unique_ptr<mtac::Program> Compiler::compile_mtac(const std::string& file, P
 
     //If program is null, it means that the user didn't wanted it
     if(program){
+        program->context->stats().set_counter("resident_memory_front_end_kb", resident_memory());
+
         mtac::resolve_references(*program);
 
         //Separate into basic blocks
@@ -143,6 +151,13 @@ std::unique_ptr<mtac::Program> Compiler::compile_mtac(const std::string& file, P
         //Build the call graph (will be used for each optimization level)
         mtac::build_call_graph(*program);
 
+        //Profile-guided optimization, the blocks must be numbered before any optimization
+        if(configuration->option_defined("profile-generate")){
+            mtac::instrument_profile(*program, configuration->option_value("output") + ".profile");
+        } else if(configuration->option_defined("profile-use")){
+            mtac::load_profile(*program, configuration->option_value("profile-use"));
+        }
+
         //Optimize MTAC
         mtac::Optimizer optimizer;
         optimizer.optimize(*program, front_end.get_string_pool(), platform, configuration);
@@ -156,6 +171,8 @@ std::unique_ptr<mtac::Program> Compiler::compile_mtac(const std::string& file, P
         if(configuration->option_defined("mtac") || configuration->option_defined("mtac-only")){
             std::cout << *program << std::endl;
         }
+
+        program->context->stats().set_counter("resident_memory_mtac_kb", resident_memory());
     }
 
     return std::move(program);
@@ -171,4 +188,6 @@ void Compiler::compile_ltac(mtac::Program& program, Platform platform, std::shar
     back_end->set_configuration(configuration);
 
     back_end->generate(program, platform);
+
+    program.context->stats().set_counter("resident_memory_back_end_kb", resident_memory());
 }
@@ -25,21 +25,25 @@ std::shared_ptr<Context> Context::parent() const  {
     return m_parent;
 }
 
-bool Context::exists(const std::string& variable) const {
-    bool found = variables.find(variable) != variables.end();
+std::shared_ptr<Variable> Context::find_variable(symbol variable) const {
+    //The name is hashed once for the whole chain of contexts
+    auto context = this;
 
-    auto parent = m_parent;
+    while(context){
+        auto iter = context->variables.find(variable);
 
-    while(!found){
-        if(parent){
-            found = parent->variables.find(variable) != parent->variables.end();
-            parent = parent->m_parent;
-        } else {
-            return false;
+        if(iter != context->variables.end()){
+            return iter->second;
         }
+
+        context = context->m_parent.get();
     }
 
-    return true;
+    return nullptr;
+}
+
+bool Context::exists(const std::string& variable) const {
+    return static_cast<bool>(find_variable(variable));
 }
 
 std::shared_ptr<Variable> Context::new_temporary(std::shared_ptr<const Type>){
@@ -51,35 +55,23 @@ std::shared_ptr<Variable> Context::operator[](const std::string& variable) const
 }
 
 std::shared_ptr<Variable> Context::getVariable(const std::string& variable) const {
-    cpp_assert(exists(variable), "The variable must exists");
-
-    auto iter = variables.find(variable);
-    auto end = variables.end();
+    auto var = find_variable(variable);
 
-    auto parent = m_parent;
+    cpp_assert(var, "The variable must exists");
 
-    while(iter == end){
-        iter = parent->variables.find(variable);
-        end = parent->variables.end();
-        parent = parent->m_parent;
-    }
-    
-    return iter->second;
+    return var;
 }
 
 void Context::removeVariable(std::shared_ptr<Variable> variable){
-    auto iter = variables.find(variable->name());
-    auto end = variables.end();
-
-    auto parent = m_parent;
-    
-    while(iter == end){
-        iter = parent->variables.find(variable->name());
-        end = parent->variables.end();
-        parent = parent->m_parent;
+    symbol name = variable->name();
+
+    auto context = this;
+
+    while(context->variables.find(name) == context->variables.end()){
+        context = context->m_parent.get();
     }
 
-    variables.erase(iter);
+    context->variables.erase(name);
 }
  
 Context::Variables::const_iterator Context::begin() const {
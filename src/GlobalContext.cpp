@@ -31,7 +31,7 @@ GlobalContext::GlobalContext(Platform platform) : Context(nullptr), platform(pla
     defineStandardFunctions();
 }
 
-std::unordered_map<std::string, std::shared_ptr<Variable>> GlobalContext::getVariables(){
+GlobalContext::Variables GlobalContext::getVariables(){
     return variables;
 }
 
@@ -91,7 +91,7 @@ bool GlobalContext::struct_exists(std::shared_ptr<const Type> type) const {
 
     cpp_assert(type->is_custom_type() || type->is_template_type(), "This type has no corresponding struct");
     
-    auto struct_name = type->mangle();
+    auto& struct_name = type->mangle();
     return struct_exists(struct_name);
 }
 
@@ -116,10 +116,26 @@ std::shared_ptr<Struct> GlobalContext::get_struct(std::shared_ptr<const Type> ty
 
     cpp_assert(type->is_custom_type() || type->is_template_type(), "This type has no corresponding struct");
     
-    auto struct_name = type->mangle();
+    auto& struct_name = type->mangle();
     return get_struct(struct_name);
 }
 
+std::shared_ptr<const Type> GlobalContext::get_type(const std::string& mangled) const {
+    auto it = m_types.find(mangled);
+
+    if(it == m_types.end()){
+        return nullptr;
+    } else {
+        return it->second;
+    }
+}
+
+void GlobalContext::add_type(const std::string& mangled, std::shared_ptr<const Type> type){
+    cpp_assert(m_types.find(mangled) == m_types.end(), "The type has already been registered");
+
+    m_types[mangled] = type;
+}
+
 int GlobalContext::member_offset(std::shared_ptr<const Struct> struct_, const std::string& member) const {
     int offset = 0;
 
@@ -227,12 +243,36 @@ void GlobalContext::defineStandardFunctions(){
     durationFunction.standard() = true;
     durationFunction.parameters().emplace_back("a", new_array_type(INT));
     durationFunction.parameters().emplace_back("b", new_array_type(INT));
+
+    //memcpy intrinsic (offsets and count in bytes)
+    auto& memcpyFunction = add_function(VOID, "memcpy", "_F6memcpyPIPIIII");
+    memcpyFunction.standard() = true;
+    memcpyFunction.parameters().emplace_back("dest", new_pointer_type(INT));
+    memcpyFunction.parameters().emplace_back("src", new_pointer_type(INT));
+    memcpyFunction.parameters().emplace_back("dest_offset", INT);
+    memcpyFunction.parameters().emplace_back("src_offset", INT);
+    memcpyFunction.parameters().emplace_back("bytes", INT);
+
+    //memset intrinsic (offset and count in bytes, width of the element in bytes)
+    auto& memsetFunction = add_function(VOID, "memset", "_F6memsetPIIIII");
+    memsetFunction.standard() = true;
+    memsetFunction.parameters().emplace_back("dest", new_pointer_type(INT));
+    memsetFunction.parameters().emplace_back("dest_offset", INT);
+    memsetFunction.parameters().emplace_back("value", INT);
+    memsetFunction.parameters().emplace_back("bytes", INT);
+    memsetFunction.parameters().emplace_back("width", INT);
 }
 
 const GlobalContext::FunctionMap& GlobalContext::functions() const {
     return m_functions;
 }
 
+void GlobalContext::release_function_contexts(){
+    for(auto& function : m_functions){
+        function.second.context() = nullptr;
+    }
+}
+
 Platform GlobalContext::target_platform() const {
     return platform;
 }
@@ -246,18 +286,27 @@ timing_system& GlobalContext::timing(){
 }
 
 std::size_t GlobalContext::new_file(const std::string& file_name){
-    int index = file_contents.size();
+    mapped_file file;
+    file.open(file_name);
+
+    std::lock_guard<std::mutex> lock(files_mutex);
+
+    std::size_t index = file_contents.size();
 
     file_names.push_back(file_name);
-    file_contents.emplace_back("");
+    file_contents.push_back(std::move(file));
 
     return index;
 }
 
-std::string& GlobalContext::get_file_content(std::size_t file){
+const mapped_file& GlobalContext::get_file_content(std::size_t file){
+    std::lock_guard<std::mutex> lock(files_mutex);
+
     return file_contents[file];
 }
 
 const std::string& GlobalContext::get_file_name(std::size_t file){
+    std::lock_guard<std::mutex> lock(files_mutex);
+
     return file_names[file];
 }
@@ -5,6 +5,8 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <unordered_set>
+
 #include "NativeBackEnd.hpp"
 #include "Utils.hpp"
 #include "Options.hpp"
@@ -21,101 +23,199 @@
 #include "ltac/prologue.hpp"
 #include "ltac/stack_offsets.hpp"
 #include "ltac/stack_space.hpp"
+#include "ltac/stack_slots.hpp"
 #include "ltac/register_allocator.hpp"
 #include "ltac/pre_alloc_cleanup.hpp"
+#include "ltac/address_folding.hpp"
+#include "ltac/scheduler.hpp"
 
 //Code generation
 #include "asm/CodeGeneratorFactory.hpp"
 
 using namespace eddic;
 
-void NativeBackEnd::generate(mtac::Program& program, Platform platform){
-    std::string output = configuration->option_value("output");
-
-    //Prepare the float pool
-    FloatPool float_pool;
-
-    //Allocate stack positions for aggregates that have not been allocated
-    ltac::allocate_aggregates(program);
+namespace {
 
+//The phases that only depend on the function itself, from the LTAC compilation to the register allocation
+void allocate_function(mtac::Program& program, mtac::Function& function, ltac::Compiler& compiler, FloatPool& float_pool, Platform platform, std::shared_ptr<Configuration> configuration){
     //Generate LTAC Code
-    ltac::Compiler ltacCompiler(platform, configuration);
-    ltacCompiler.compile(program, float_pool);
-
-    //Switch to LTAC Mode
-    program.mode = mtac::Mode::LTAC;
+    compiler.compile(function, float_pool);
 
     //Clean the code generated by the LTAC Compiler to ease the register allocation
-    ltac::pre_alloc_cleanup(program);
-    
+    ltac::pre_alloc_cleanup(function);
+
+    //Select the addressing modes while the computations are still in pseudo registers
+    if(configuration->option_defined("ffold-addresses")){
+        ltac::fold_addresses(function, platform);
+    }
+
     if(configuration->option_defined("ltac-pre")){
         ltac::Printer printer;
-        printer.print(program);
+        printer.print(function);
     }
 
     //Init the structures and arrays
     //Must be done before register allocation to profit from it
-    ltac::alloc_stack_space(program);
+    ltac::alloc_stack_space(function, platform);
+
+    //Schedule the instructions while the pseudo registers can still be moved freely
+    if(configuration->option_defined("fschedule-instructions")){
+        ltac::schedule(function, platform, false);
+    }
 
     //Allocate pseudo registers into hard registers
-    ltac::register_allocation(program, platform);
-    
-    //Generate the prologue and epilogue of each functions
-    ltac::generate_prologue_epilogue(program, configuration);
+    ltac::register_allocation(function, platform, program.profiled);
 
+    //Share the stack slots once the spilled registers are known
+    if(configuration->option_defined("fstack-slot-coloring")){
+        ltac::color_stack_slots(function, platform);
+    }
+}
+
+//The phases that follow the generation of the prologue and epilogue
+void finish_function(mtac::Function& function, Platform platform, std::shared_ptr<Configuration> configuration){
     //If specified by the configuration, replace all stack offsets using SP 
     if(configuration->option_defined("fomit-frame-pointer")){
-        ltac::fix_stack_offsets(program, platform);
+        ltac::fix_stack_offsets(function, platform);
     }
-    
+
     if(configuration->option_defined("ltac-alloc")){
         ltac::Printer printer;
-        printer.print(program);
+        printer.print(function);
     }
 
     if(configuration->option_defined("fpeephole-optimization")){
-        ltac::optimize(program, platform);
+        ltac::optimize(function, platform);
+    }
+
+    //Schedule again the spill code and the code modified by the peephole optimizer
+    if(configuration->option_defined("fschedule-instructions")){
+        ltac::schedule(function, platform, true);
     }
 
     if(configuration->option_defined("ltac") || configuration->option_defined("ltac-only")){
         ltac::Printer printer;
-        printer.print(program);
+        printer.print(function);
     }
+}
 
-    if(!configuration->option_defined("ltac-only")){
-        auto input_file_name = configuration->option_value("input");
-        auto asm_file_name = input_file_name + ".s";
-        auto object_file_name = input_file_name + ".o";
+//The LTAC code and the context are not necessary anymore once the assembly of the function has been generated
+void release_function(mtac::Function& function){
+    for(auto& bb : function){
+        bb->l_statements.clear();
+        bb->l_statements.shrink_to_fit();
+    }
 
-        {
-            timing_timer timer(program.context->timing(), "assembly_generation");
+    //The function context holds the global context, which holds the function definition
+    function.definition().context() = nullptr;
+    function.context = nullptr;
+}
 
-            //Generate assembly from TAC
-            AssemblyFileWriter writer(asm_file_name);
+} //end of anonymous namespace
 
-            as::CodeGeneratorFactory factory;
-            auto generator = factory.get(platform, writer, program, program.context);
+void NativeBackEnd::generate(mtac::Program& program, Platform platform){
+    std::string output = configuration->option_value("output");
 
-            //Generate the code from the LTAC Program
-            generator->generate(*get_string_pool(), float_pool);
+    //Prepare the float pool
+    FloatPool float_pool;
 
-            //writer's destructor flushes the file
+    //Allocate stack positions for aggregates that have not been allocated
+    ltac::allocate_aggregates(program);
+
+    //Find where the aggregates need to be cleared before their LTAC code is generated
+    if(configuration->option_defined("flazy-stack-clearing")){
+        ltac::find_clear_points(program);
+    }
+
+    //Switch to LTAC Mode
+    program.mode = mtac::Mode::LTAC;
+
+    ltac::Compiler ltacCompiler(platform, configuration);
+    ltac::PrologueGenerator prologue(program, configuration);
+
+    bool emit = !configuration->option_defined("ltac-only");
+
+    auto input_file_name = configuration->option_value("input");
+    auto asm_file_name = input_file_name + ".s";
+    auto object_file_name = input_file_name + ".o";
+
+    {
+        std::unique_ptr<AssemblyFileWriter> writer;
+        std::unique_ptr<as::CodeGenerator> generator;
+
+        if(emit){
+            writer.reset(new AssemblyFileWriter(asm_file_name));
+
+            as::CodeGeneratorFactory factory;
+            generator = factory.get(platform, *writer, program, program.context);
+
+            timing_timer timer(program.context->timing(), "assembly_generation");
+            generator->begin_program();
         }
 
-        //If it's necessary, assemble and link the assembly
-        if(!configuration->option_defined("assembly")){
-            timing_timer timer(program.context->timing(), "assemble");
+        std::unordered_set<mtac::Function*> allocated;
+
+        //The callees are finished before their callers, only the LTAC of a group of mutually recursive functions is resident
+        for(auto& component : prologue.groups()){
+            std::vector<mtac::Function*> group;
+
+            for(auto* function : component){
+                if(allocated.insert(function).second){
+                    group.push_back(function);
+                }
+            }
 
-            verify_dependencies();
+            for(std::size_t i = 0; i < group.size(); ++i){
+                allocate_function(program, *group[i], ltacCompiler, float_pool, platform, configuration);
 
-            assemble(platform, asm_file_name, object_file_name, output, configuration->option_defined("debug"), configuration->option_defined("verbose"));
+                //A call missing from the call graph brings its callee in the group
+                for(auto* callee : prologue.callees(*group[i])){
+                    if(allocated.insert(callee).second){
+                        group.push_back(callee);
+                    }
+                }
+            }
 
-            //Remove temporary files
-            if(!configuration->option_defined("keep")){
-                remove(asm_file_name.c_str());
+            if(group.empty()){
+                continue;
             }
 
-            remove(object_file_name.c_str());
+            prologue.generate(group);
+
+            for(auto* function : group){
+                finish_function(*function, platform, configuration);
+
+                if(generator){
+                    timing_timer timer(program.context->timing(), "assembly_generation");
+                    generator->generate(*function);
+                }
+
+                release_function(*function);
+            }
+        }
+
+        //The strings and floats are collected during the LTAC compilation of all the functions
+        if(generator){
+            timing_timer timer(program.context->timing(), "assembly_generation");
+            generator->end_program(*get_string_pool(), float_pool);
         }
+
+        //writer's destructor flushes the file
+    }
+
+    //If it's necessary, assemble and link the assembly
+    if(emit && !configuration->option_defined("assembly")){
+        timing_timer timer(program.context->timing(), "assemble");
+
+        verify_dependencies();
+
+        assemble(platform, asm_file_name, object_file_name, output, configuration->option_defined("debug"), configuration->option_defined("verbose"));
+
+        //Remove temporary files
+        if(!configuration->option_defined("keep")){
+            remove(asm_file_name.c_str());
+        }
+
+        remove(object_file_name.c_str());
     }
 }
@@ -60,11 +60,23 @@ void init_options(cxxopts::Options& options){
         ("fglobal-optimization", "Enable optimizer engine")
         ("fparameter-allocation", "Enable parameter allocation in register")
         ("fpeephole-optimization", "Enable peephole optimizer")
+        ("ffold-addresses", "Fold the address computations into the memory operands and use LEA for small multiplications")
         ("fomit-frame-pointer", "Omit frame pointer from functions")
         ("finline-functions", "Enable inlining")
         ("fno-inline-functions", "Disable inlining")
+        ("inline-unit-growth", "Maximal growth of the program by inlining, in percent", cxxopts::value<std::string>()->default_value("50"))
+        ("inline-function-growth", "Maximal growth of a function by inlining, in percent", cxxopts::value<std::string>()->default_value("100"))
+        ("fspecialize-functions", "Specialize copies of the functions called with constant arguments from hot call sites")
         ("funroll-loops", "Enable Loop Unrolling")
         ("fcomplete-peel-loops", "Enable Complete Loop Peeling")
+        ("fmemory-idioms", "Replace copy and fill loops by memcpy and memset")
+        ("ftail-calls", "Transform tail recursion into loops and tail calls into jumps")
+        ("fschedule-instructions", "Reorder the instructions of the basic blocks to hide the latencies")
+        ("fblock-layout", "Reorder the basic blocks to make the likely branches fall through")
+        ("flazy-stack-clearing", "Clear the structures and arrays on the stack only when needed and where they are first used")
+        ("fstack-slot-coloring", "Share the stack slots of the variables and spilled registers whose lifetimes do not overlap")
+        ("profile-generate", "Instrument the program to dump the execution counts of its basic blocks into <output>.profile")
+        ("profile-use", "Use the execution counts of the given profile to guide the optimizations", cxxopts::value<std::string>())
         ;
 
     options.add_options("Backend")
@@ -103,9 +115,9 @@ std::shared_ptr<Configuration> eddic::parseOptions(int argc, const char* argv[])
         add_trigger(triggers, "warning-all", {"warning-unused", "warning-cast", "warning-effects", "warning-includes"});
 
         //Special triggers for optimization levels
-        add_trigger(triggers, "__1", {"fpeephole-optimization"});
-        add_trigger(triggers, "__2", {"fglobal-optimization", "fomit-frame-pointer", "fparameter-allocation", "finline-functions"});
-        add_trigger(triggers, "__3", {"funroll-loops", "fcomplete-peel-loops", "funswitch-loops"});
+        add_trigger(triggers, "__1", {"fpeephole-optimization", "ffold-addresses"});
+        add_trigger(triggers, "__2", {"fglobal-optimization", "fomit-frame-pointer", "fparameter-allocation", "finline-functions", "fmemory-idioms", "fblock-layout", "ftail-calls", "flazy-stack-clearing", "fstack-slot-coloring"});
+        add_trigger(triggers, "__3", {"funroll-loops", "fcomplete-peel-loops", "funswitch-loops", "fschedule-instructions", "fspecialize-functions"});
 
         cxxopts::Options options("eddic", "  source.eddi");
 
@@ -83,6 +83,14 @@ struct X86Descriptor : public PlatformDescriptor {
     unsigned short d_register() const {
         return 3;
     }
+
+    unsigned short c_register() const {
+        return 2;
+    }
+
+    unsigned short di_register() const {
+        return 5;
+    }
 };
 
 struct X86_64Descriptor : public PlatformDescriptor {
@@ -156,6 +164,14 @@ struct X86_64Descriptor : public PlatformDescriptor {
     unsigned short d_register() const {
         return 3;
     }
+
+    unsigned short c_register() const {
+        return 2;
+    }
+
+    unsigned short di_register() const {
+        return 5;
+    }
 };
 
 static const X86Descriptor x86Descriptor;
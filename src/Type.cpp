@@ -96,11 +96,20 @@ BaseType Type::base() const {
     cpp_unreachable("Not a standard type");
 }
 
-std::string Type::mangle() const {
-    return ::mangle(shared_from_this());
+const std::string& Type::mangle() const {
+    if(m_mangled.empty()){
+        m_mangled = ::mangle(shared_from_this());
+    }
+
+    return m_mangled;
 }
 
 bool eddic::operator==(std::shared_ptr<const Type> lhs, std::shared_ptr<const Type> rhs){
+    //The types are unique, except for constness and array sizes
+    if(lhs.get() == rhs.get()){
+        return true;
+    }
+
     if(lhs->is_array()){
         return rhs->is_array() && lhs->data_type() == rhs->data_type() ;//&& lhs->elements() == rhs->elements();
     }
@@ -109,20 +118,10 @@ bool eddic::operator==(std::shared_ptr<const Type> lhs, std::shared_ptr<const Ty
         return rhs->is_pointer() && lhs->data_type() == rhs->data_type();
     }
 
-    if(lhs->is_custom_type()){
-        return rhs->is_custom_type() && lhs->type() == rhs->type();
-    }
-
     if(lhs->is_standard_type()){
         return rhs->is_standard_type() && lhs->base() == rhs->base();
     }
 
-    if(lhs->is_template_type()){
-        if(rhs->is_template_type() && lhs->type() == rhs->type()){
-            return lhs->template_types() == rhs->template_types();
-        }
-    }
-
     return false;
 }
 
@@ -165,7 +164,8 @@ bool CustomType::is_custom_type() const {
 }
 
 unsigned int CustomType::size(Platform) const {
-    return context->total_size_of_struct(context->get_struct(shared_from_this()));
+    auto global_context = context.lock();
+    return global_context->total_size_of_struct(global_context->get_struct(shared_from_this()));
 }
 
 /* Implementation of ArrayType  */
@@ -233,7 +233,8 @@ bool TemplateType::is_template_type() const {
 }
 
 unsigned int TemplateType::size(Platform) const {
-    return context->total_size_of_struct(context->get_struct(shared_from_this()));
+    auto global_context = context.lock();
+    return global_context->total_size_of_struct(global_context->get_struct(shared_from_this()));
 }
 
 /* Implementation of factories  */
@@ -272,24 +273,61 @@ std::shared_ptr<const Type> eddic::new_type(std::shared_ptr<GlobalContext> conte
         }
     } else {
         cpp_assert(!const_, "Only standard type can be const");
-        return std::make_shared<CustomType>(context, type);
+
+        auto mangled = mangle_custom_type(type);
+
+        if(auto custom_type = context->get_type(mangled)){
+            return custom_type;
+        }
+
+        auto custom_type = std::make_shared<CustomType>(context, type);
+        context->add_type(mangled, custom_type);
+        return custom_type;
     }
 }
 
 std::shared_ptr<const Type> eddic::new_array_type(std::shared_ptr<const Type> data_type){
-    return std::make_shared<ArrayType>(data_type);
+    if(auto array_type = data_type->m_array.lock()){
+        return array_type;
+    }
+
+    std::shared_ptr<const Type> array_type = std::make_shared<ArrayType>(data_type);
+    data_type->m_array = array_type;
+    return array_type;
 }
 
 std::shared_ptr<const Type> eddic::new_array_type(std::shared_ptr<const Type> data_type, int size){
-    return std::make_shared<ArrayType>(data_type, size);
+    auto& cached = data_type->m_sized_arrays[size];
+
+    if(auto array_type = cached.lock()){
+        return array_type;
+    }
+
+    std::shared_ptr<const Type> array_type = std::make_shared<ArrayType>(data_type, size);
+    cached = array_type;
+    return array_type;
 }
 
 std::shared_ptr<const Type> eddic::new_pointer_type(std::shared_ptr<const Type> data_type){
-    return std::make_shared<PointerType>(data_type);
+    if(auto pointer_type = data_type->m_pointer.lock()){
+        return pointer_type;
+    }
+
+    std::shared_ptr<const Type> pointer_type = std::make_shared<PointerType>(data_type);
+    data_type->m_pointer = pointer_type;
+    return pointer_type;
 }
 
 std::shared_ptr<const Type> eddic::new_template_type(std::shared_ptr<GlobalContext> context, std::string data_type, std::vector<std::shared_ptr<const Type>> template_types){
-    return std::make_shared<TemplateType>(context, data_type, template_types);
+    auto mangled = mangle_template_type(data_type, template_types);
+
+    if(auto template_type = context->get_type(mangled)){
+        return template_type;
+    }
+
+    auto template_type = std::make_shared<TemplateType>(context, data_type, template_types);
+    context->add_type(mangled, template_type);
+    return template_type;
 }
 
 bool eddic::is_standard_type(const std::string& type){
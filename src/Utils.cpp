@@ -7,6 +7,8 @@
 
 #include <fstream>
 
+#include <unistd.h>
+
 #include "Utils.hpp"
 
 bool eddic::has_extension(const std::string& file, const std::string& extension){
@@ -34,6 +36,20 @@ std::string eddic::execCommand(const std::string& command) {
     return output.str();
 }
 
+std::size_t eddic::resident_memory(){
+    std::ifstream statm("/proc/self/statm");
+
+    std::size_t size = 0;
+    std::size_t resident = 0;
+
+    //The second field is the number of resident pages
+    if(!(statm >> size >> resident)){
+        return 0;
+    }
+
+    return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
 bool eddic::isPowerOfTwo (int x){
     return ((x > 0) && !(x & (x - 1)));
 }
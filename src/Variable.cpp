@@ -20,7 +20,7 @@ Variable::Variable(std::string name, std::shared_ptr<const Type> type, Position
 Variable::Variable(std::string name, std::shared_ptr<const Type> type, std::shared_ptr<Variable> reference, Offset offset)
     : m_name(std::move(name)), m_type(std::move(type)), m_position(PositionType::TEMPORARY), m_reference(std::move(reference)), m_offset(std::move(offset)) {}
 
-std::string Variable::name() const  {
+const std::string& Variable::name() const  {
     return m_name;
 }
 
@@ -7,8 +7,20 @@
 
 #include "asm/CodeGenerator.hpp"
 
+#include "mtac/Program.hpp"
+
 using namespace eddic;
 
 as::CodeGenerator::CodeGenerator(AssemblyFileWriter& w, mtac::Program& program) : writer(w), program(program) {
     //Nothing to init
 }
+
+void as::CodeGenerator::generate(StringPool& pool, FloatPool& float_pool){
+    begin_program();
+
+    for(auto& function : program){
+        generate(function);
+    }
+
+    end_program(pool, float_pool);
+}
@@ -23,15 +23,17 @@ using namespace eddic;
 
 as::IntelCodeGenerator::IntelCodeGenerator(AssemblyFileWriter& w, mtac::Program& program, std::shared_ptr<GlobalContext> context) : CodeGenerator(w, program), context(context) {}
 
-void as::IntelCodeGenerator::generate(StringPool& pool, FloatPool& float_pool){
+void as::IntelCodeGenerator::begin_program(){
     resetNumbering();
 
     writeRuntimeSupport();
+}
 
-    for(auto& function : program){
-        compile(function);
-    }
+void as::IntelCodeGenerator::generate(mtac::Function& function){
+    compile(function);
+}
 
+void as::IntelCodeGenerator::end_program(StringPool& pool, FloatPool& float_pool){
     addStandardFunctions();
 
     addGlobalVariables(pool, float_pool);
@@ -78,6 +80,11 @@ void as::IntelCodeGenerator::addGlobalVariables(StringPool& pool, FloatPool& flo
         }
     }
 
+    //The instrumented program needs the name of its profile file
+    if(!program.profile_file.empty()){
+        writer.stream() << "V__profile_file db \"" << program.profile_file << "\", 0" << '\n';
+    }
+
     for (auto it : pool.getPool()){
         declareString(it.second, it.first);
     }
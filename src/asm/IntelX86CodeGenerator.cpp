@@ -303,12 +303,18 @@ void compile_statement(AssemblyFileWriter& writer, ltac::Instruction& instructio
         case ltac::Operator::MOVDQU:
             writer.stream() << "movdqu " << *instruction.arg1 << ", " << *instruction.arg2 << '\n';
             break;
+        case ltac::Operator::REP_STOS:
+            writer.stream() << "rep stosd" << '\n';
+            break;
         case ltac::Operator::NOP:
             //Nothing to output for a nop
             break;
         case ltac::Operator::CALL:
             writer.stream() << "call " << instruction.label << '\n';
             break;
+        case ltac::Operator::TAIL_CALL:
+            writer.stream() << "jmp " << instruction.label << '\n';
+            break;
         case ltac::Operator::ALWAYS:
             writer.stream() << "jmp " << "." << instruction.label << '\n';
             break;
@@ -423,6 +429,11 @@ void as::IntelX86CodeGenerator::writeRuntimeSupport(){
         writer.stream() << "call _F4main" << '\n';
     }
 
+    //Dump the counters of the instrumented program
+    if(!program.profile_file.empty()){
+        writer.stream() << "call _F12profile_dump" << '\n';
+    }
+
     /* Exit the program */
     writer.stream() << "mov eax, 1" << '\n';
     writer.stream() << "xor ebx, ebx" << '\n';
@@ -505,4 +516,16 @@ void as::IntelX86CodeGenerator::addStandardFunctions(){
     if(program.cg.is_reachable(context->getFunction("_F9read_char"))){
         output_function("x86_32_read_char");
     }
+
+    if(program.cg.is_reachable(context->getFunction("_F6memcpyPIPIIII"))){
+        output_function("x86_32_memcpy");
+    }
+
+    if(program.cg.is_reachable(context->getFunction("_F6memsetPIIIII"))){
+        output_function("x86_32_memset");
+    }
+
+    if(!program.profile_file.empty()){
+        output_function("x86_32_profile_dump");
+    }
 }
@@ -333,12 +333,18 @@ void compile_statement(AssemblyFileWriter& writer, ltac::Instruction& instructio
         case ltac::Operator::MOVDQU:
             writer.stream() << "movdqu " << *instruction.arg1 << ", " << *instruction.arg2 << '\n';
             break;
+        case ltac::Operator::REP_STOS:
+            writer.stream() << "rep stosq" << '\n';
+            break;
         case ltac::Operator::NOP:
             //Nothing to output for a nop
             break;
         case ltac::Operator::CALL:
             writer.stream() << "call " << instruction.label << '\n';
             break;
+        case ltac::Operator::TAIL_CALL:
+            writer.stream() << "jmp " << instruction.label << '\n';
+            break;
         case ltac::Operator::ALWAYS:
             writer.stream() << "jmp " << "." << instruction.label << '\n';
             break;
@@ -456,6 +462,11 @@ void as::IntelX86_64CodeGenerator::writeRuntimeSupport(){
         writer.stream() << "call _F4main" << '\n';
     }
 
+    //Dump the counters of the instrumented program
+    if(!program.profile_file.empty()){
+        writer.stream() << "call _F12profile_dump" << '\n';
+    }
+
     //Exit from the program
     writer.stream() << "mov rax, 60" << '\n';  //syscall 60 is exit
     writer.stream() << "xor rdi, rdi" << '\n'; //exit code (0 = success)
@@ -538,4 +549,16 @@ void as::IntelX86_64CodeGenerator::addStandardFunctions(){
     if(program.cg.is_reachable(context->getFunction("_F9read_char"))){
         output_function("x86_64_read_char");
     }
+
+    if(program.cg.is_reachable(context->getFunction("_F6memcpyPIPIIII"))){
+        output_function("x86_64_memcpy");
+    }
+
+    if(program.cg.is_reachable(context->getFunction("_F6memsetPIIIII"))){
+        output_function("x86_64_memset");
+    }
+
+    if(!program.profile_file.empty()){
+        output_function("x86_64_profile_dump");
+    }
 }
@@ -28,45 +28,34 @@ std::string as::StringConverter::register_to_string(eddic::ltac::AddressRegister
 }
 
 std::string as::StringConverter::address_to_string(eddic::ltac::Address& address) const {
-    if(address.absolute){
-        if(address.displacement){
-            return "[" + *address.absolute + " + " + std::to_string(*address.displacement) + "]";
-        }
+    //The folded addresses may combine any of the parts
+    std::string value;
 
-        if(address.base_register){
-            return "[" + *address.absolute + " + " + register_to_string(*address.base_register) + "]";
-        }
+    auto append = [&value](const std::string& part){
+        value += value.empty() ? part : " + " + part;
+    };
 
-        return "[" + *address.absolute + "]";
+    if(address.absolute){
+        append(*address.absolute);
     }
-        
+
     if(address.base_register){
-        if(address.scaled_register){
-            if(address.scale){
-                if(address.displacement){
-                    return "[" + register_to_string(*address.base_register) + " + " + register_to_string(*address.scaled_register) + " * " + std::to_string(*address.scale) + " + " + std::to_string(*address.displacement) + "]";
-                }
-                
-                return "[" + register_to_string(*address.base_register) + " + " + register_to_string(*address.scaled_register) + " * " + std::to_string(*address.scale) + "]";
-            }
-                
-            if(address.displacement){
-                return "[" + register_to_string(*address.base_register) + " + " + register_to_string(*address.scaled_register) + " + " + std::to_string(*address.displacement) + "]";
-            }
-            
-            return "[" + register_to_string(*address.base_register) + " + " + register_to_string(*address.scaled_register) + "]";
-        }
-                
-        if(address.displacement){
-            return "[" + register_to_string(*address.base_register) + " + " + std::to_string(*address.displacement) + "]";
-        }
+        append(register_to_string(*address.base_register));
+    }
 
-        return "[" + register_to_string(*address.base_register) + "]";
+    if(address.scaled_register){
+        if(address.scale){
+            append(register_to_string(*address.scaled_register) + " * " + std::to_string(*address.scale));
+        } else {
+            append(register_to_string(*address.scaled_register));
+        }
     }
 
     if(address.displacement){
-        return "[" + std::to_string(*address.displacement) + "]";
+        append(std::to_string(*address.displacement));
     }
 
-    cpp_unreachable("Invalid address type");
+    cpp_assert(!value.empty(), "Invalid address type");
+
+    return "[" + value + "]";
 }
@@ -7,6 +7,15 @@
 
 #include<string>
 #include<unordered_set>
+#include<unordered_map>
+#include<vector>
+#include<thread>
+#include<atomic>
+#include<algorithm>
+#include<exception>
+#include<memory>
+#include<sstream>
+#include<iostream>
 
 #include "ast/DependenciesResolver.hpp"
 #include "ast/SourceFile.hpp"
@@ -15,20 +24,167 @@
 #include "SemanticalException.hpp"
 #include "VisitorUtils.hpp"
 #include "Utils.hpp"
+#include "GlobalContext.hpp"
+#include "timing.hpp"
 
 #include "parser_x3/SpiritParser.hpp"
 
 using namespace eddic;
 
+namespace {
+
+//The path of the file of a standard import
+std::string standard_file(const std::string& header){
+    return "stdlib/" + header + ".eddi";
+}
+
+struct parsed_file {
+    ast::SourceFile program;
+    bool valid = false;
+    bool merged = false;
+
+    //Reported when the file is merged, so that the output does not depend on the threads
+    std::ostringstream out;
+    std::ostringstream err;
+    std::exception_ptr error;
+};
+
+typedef std::unordered_map<std::string, parsed_file> ParsedFiles;
+
+//Collect the files imported by a source file
+class ImportCollector : public boost::static_visitor<> {
+    public:
+        std::vector<std::string> files;
+
+        AUTO_RECURSE_PROGRAM()
+
+        void operator()(ast::StandardImport& import){
+            files.push_back(standard_file(import.header));
+        }
+
+        void operator()(ast::Import& import){
+            files.push_back(import.file);
+        }
+
+        AUTO_FORWARD()
+        AUTO_IGNORE_OTHERS()
+};
+
+/*
+ * Parse all the files imported by the program, directly or not. The closure is discovered level by
+ * level and the files of a level are parsed in parallel, each one in its own SourceFile.
+ */
+void parse_imports(ast::SourceFile& program, parser_x3::SpiritParser& parser, ParsedFiles& parsed){
+    std::unordered_set<std::string> scheduled;
+    std::vector<std::string> level;
+
+    auto schedule = [&](ast::SourceFile& source){
+        ImportCollector collector;
+        collector(source);
+
+        //The missing files are reported when the imports are resolved
+        for(auto& file : collector.files){
+            if(file_exists(file) && scheduled.insert(file).second){
+                level.push_back(file);
+            }
+        }
+    };
+
+    schedule(program);
+
+    while(!level.empty()){
+        //The whole level is timed, the parses overlap
+        timing_timer timer(program.context->timing(), "parsing");
+
+        //All the entries are created before the threads start
+        for(auto& file : level){
+            parsed[file];
+        }
+
+        std::atomic<std::size_t> next(0);
+
+        auto worker = [&](){
+            std::size_t i;
+            while((i = next++) < level.size()){
+                auto& file = parsed.find(level[i])->second;
+
+                try {
+                    file.valid = parser.parse(level[i], file.program, program.context, file.out, file.err);
+                } catch (...) {
+                    file.valid = false;
+                    file.error = std::current_exception();
+                }
+            }
+        };
+
+        std::size_t threads = std::min<std::size_t>(level.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+        std::vector<std::thread> pool;
+        for(std::size_t i = 1; i < threads; ++i){
+            pool.emplace_back(worker);
+        }
+
+        worker();
+
+        for(auto& thread : pool){
+            thread.join();
+        }
+
+        std::vector<std::string> current;
+        std::swap(current, level);
+
+        for(auto& file : current){
+            auto& parsed_file = parsed[file];
+
+            if(parsed_file.valid){
+                schedule(parsed_file.program);
+            }
+        }
+    }
+}
+
+//Merge the parsed files into the program, in the order of a depth-first traversal of the imports
 class DependencyVisitor : public boost::static_visitor<> {
     private:
         parser_x3::SpiritParser& parser;
         ast::SourceFile& source_program;
+        ParsedFiles& parsed;
 
         std::unordered_set<std::string> imported;
 
+        //Each import is merged in its own copy of the file, a file imported again is parsed again
+        std::unique_ptr<ast::SourceFile> dependency(const std::string& file){
+            auto it = parsed.find(file);
+
+            if(it == parsed.end() || it->second.merged){
+                std::unique_ptr<ast::SourceFile> dependency(new ast::SourceFile());
+
+                if(parser.parse(file, *dependency, source_program.context)){
+                    return dependency;
+                }
+
+                return nullptr;
+            }
+
+            auto& parsed_file = it->second;
+            parsed_file.merged = true;
+
+            std::cerr << parsed_file.err.str();
+            std::cout << parsed_file.out.str();
+
+            if(parsed_file.error){
+                std::rethrow_exception(parsed_file.error);
+            }
+
+            if(parsed_file.valid){
+                return std::unique_ptr<ast::SourceFile>(new ast::SourceFile(std::move(parsed_file.program)));
+            }
+
+            return nullptr;
+        }
+
     public:
-        DependencyVisitor(parser_x3::SpiritParser& p, ast::SourceFile& source_program) : parser(p), source_program(source_program) {}
+        DependencyVisitor(parser_x3::SpiritParser& parser, ast::SourceFile& source_program, ParsedFiles& parsed) : parser(parser), source_program(source_program), parsed(parsed) {}
 
         std::vector<ast::SourceFileBlock> blocks;
 
@@ -41,14 +197,15 @@ class DependencyVisitor : public boost::static_visitor<> {
 
             imported.insert(import.header);
 
-            auto headerFile = "stdlib/" + import.header + ".eddi";
+            auto headerFile = standard_file(import.header);
 
             if(!file_exists(headerFile)){
                 throw SemanticalException("The header " + import.header + " does not exist");
             }
 
-            ast::SourceFile dependency;
-            if(parser.parse(headerFile, dependency, source_program.context)){
+            if(auto dependency_ptr = dependency(headerFile)){
+                auto& dependency = *dependency_ptr;
+
                 (*this)(dependency);
 
                 for(ast::SourceFileBlock& block : dependency.blocks){
@@ -62,7 +219,7 @@ class DependencyVisitor : public boost::static_visitor<> {
                         ptr->header = import.header;
                     }
 
-                    blocks.push_back(block);
+                    blocks.push_back(std::move(block));
                 }
             } else {
                 throw SemanticalException("The header " + import.header + " cannot be imported");
@@ -76,8 +233,9 @@ class DependencyVisitor : public boost::static_visitor<> {
                 throw SemanticalException("The file " + file + " does not exist");
             }
 
-            ast::SourceFile dependency;
-            if(parser.parse(file, dependency, source_program.context)){
+            if(auto dependency_ptr = dependency(file)){
+                auto& dependency = *dependency_ptr;
+
                 (*this)(dependency);
 
                 for(ast::SourceFileBlock& block : dependency.blocks){
@@ -89,7 +247,7 @@ class DependencyVisitor : public boost::static_visitor<> {
                         ptr->header = import.file;
                     }
 
-                    blocks.push_back(block);
+                    blocks.push_back(std::move(block));
                 }
             } else {
                 throw SemanticalException("The file " + file + " cannot be imported");
@@ -100,8 +258,13 @@ class DependencyVisitor : public boost::static_visitor<> {
         AUTO_IGNORE_OTHERS()
 };
 
+} //end of anonymous namespace
+
 void ast::resolveDependencies(ast::SourceFile& program, parser_x3::SpiritParser& parser){
-    DependencyVisitor visitor(parser, program);
+    ParsedFiles parsed;
+    parse_imports(program, parser, parsed);
+
+    DependencyVisitor visitor(parser, program, parsed);
     visitor(program);
 
     program.blocks.reserve(program.blocks.size() + visitor.blocks.size());
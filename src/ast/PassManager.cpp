@@ -166,7 +166,7 @@ void ast::PassManager::init_passes(){
     passes.push_back(make_pass<ast::WarningsPass>("Warnings", template_engine, platform, configuration, pool));
 }
 
-void ast::PassManager::function_instantiated(ast::TemplateFunctionDeclaration& function, const std::string& context){
+void ast::PassManager::function_instantiated(ast::TemplateFunctionDeclaration&& function, const std::string& context){
     LOG<Info>("Passes") << "Apply passes to instantiated function \"" << function.functionName << "\"" << " in context " << context << log::endl;
 
     for(auto& pass : applied_passes){
@@ -196,10 +196,10 @@ void ast::PassManager::function_instantiated(ast::TemplateFunctionDeclaration& f
 
     LOG<Info>("Passes") << "Passes applied to instantiated function \"" << function.functionName << "\"" << " in context " << context << log::endl;
 
-    functions_instantiated.push_back(std::make_pair(context, function));
+    functions_instantiated.emplace_back(context, std::move(function));
 }
 
-void ast::PassManager::struct_instantiated(ast::struct_definition& struct_){
+void ast::PassManager::struct_instantiated(ast::struct_definition&& struct_){
     cpp_assert(struct_.is_template_instantation(), "Must be called with a template instantiation");
 
     LOG<Info>("Passes") << "Apply passes to instantiated struct \"" << struct_.name << "\"" << log::endl;
@@ -221,7 +221,7 @@ void ast::PassManager::struct_instantiated(ast::struct_definition& struct_){
 
     LOG<Info>("Passes") << "Passes applied to instantiated struct \"" << struct_.name << "\"" << log::endl;
 
-    class_instantiated.push_back(struct_);
+    class_instantiated.push_back(std::move(struct_));
 }
 
 void ast::PassManager::inc_depth(){
@@ -261,8 +261,9 @@ void ast::PassManager::run_passes(){
 
             //Add the instantiated class and function templates to the actual program
 
+            //The instantiations are moved, they are cleared just after
             for(auto& struct_ : class_instantiated){
-                program_.blocks.emplace_back(struct_);
+                program_.blocks.emplace_back(std::move(struct_));
             }
 
             for(auto& function_pair : functions_instantiated){
@@ -270,12 +271,12 @@ void ast::PassManager::run_passes(){
                 auto& function = function_pair.second;
 
                 if(context.empty()){
-                    program_.blocks.emplace_back(function);
+                    program_.blocks.emplace_back(std::move(function));
                 } else {
                     for(auto& block : program_.blocks){
                         if(auto* struct_type = boost::get<ast::struct_definition>(&block)){
                             if(!struct_type->is_template_declaration() && struct_type->struct_type->mangle() == context){
-                                struct_type->blocks.emplace_back(function);
+                                struct_type->blocks.emplace_back(std::move(function));
                                 break;
                             }
                         }
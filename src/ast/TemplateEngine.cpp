@@ -801,7 +801,7 @@ void ast::TemplateEngine::instantiate_function(ast::TemplateFunctionDeclaration&
         //Mark it as instantiated
         function_template_instantiations[context].insert(ast::TemplateEngine::LocalFunctionInstantiationMap::value_type(name, template_types));
 
-        pass_manager.function_instantiated(declaration, context);
+        pass_manager.function_instantiated(std::move(declaration), context);
     }
 
     return;
@@ -919,7 +919,7 @@ void ast::TemplateEngine::check_type(ast::Type& type, x3::file_position_tagged&
                     //Mark it as instantiated
                     class_template_instantiations.insert(ast::TemplateEngine::ClassInstantiationMap::value_type(name, template_types));
 
-                    pass_manager.struct_instantiated(declaration);
+                    pass_manager.struct_instantiated(std::move(declaration));
                 }
 
                 return;
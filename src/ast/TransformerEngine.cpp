@@ -189,6 +189,14 @@ struct ValueTransformer : public boost::static_visitor<ast::Value> {
     }
 };
 
+//An initializer list would copy the whole subtree of the instruction
+template<typename T>
+std::vector<ast::Instruction> single_instruction(T&& instruction){
+    std::vector<ast::Instruction> instructions;
+    instructions.emplace_back(std::forward<T>(instruction));
+    return instructions;
+}
+
 struct InstructionTransformer : public boost::static_visitor<std::vector<ast::Instruction>> {
     result_type operator()(ast::Assignment& compound) const {
         if(compound.op == ast::Operator::ASSIGN || compound.op == ast::Operator::SWAP){
@@ -205,7 +213,7 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
         assignment.left_value = compound.left_value;
         assignment.value = composed;
 
-        return {ast::Instruction(assignment)};
+        return single_instruction(std::move(assignment));
     }
 
     //Transform while in do while loop as an optimization (less jumps)
@@ -216,12 +224,12 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
 
         ast::DoWhile do_while;
         do_while.context = while_.context;
-        do_while.condition = while_.condition;
-        do_while.instructions = while_.instructions;
+        do_while.condition = std::move(while_.condition);
+        do_while.instructions = std::move(while_.instructions);
 
-        if_.instructions.emplace_back(do_while);
+        if_.instructions.emplace_back(std::move(do_while));
 
-        return {ast::Instruction(if_)};
+        return single_instruction(std::move(if_));
     }
 
     //Transform foreach loop in do while loop
@@ -266,7 +274,7 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
         ast::DoWhile do_while;
         do_while.context = foreach.context;
         do_while.condition = while_condition;
-        do_while.instructions = foreach.instructions;
+        do_while.instructions = std::move(foreach.instructions);
 
         ast::Integer inc;
         inc.value = 1;
@@ -283,9 +291,9 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
 
         do_while.instructions.emplace_back(repeat_assign);
 
-        if_.instructions.emplace_back(do_while);
+        if_.instructions.emplace_back(std::move(do_while));
 
-        return {ast::Instruction(if_)};
+        return single_instruction(std::move(if_));
     }
 
     //Transform foreach loop in do while loop
@@ -361,7 +369,7 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
         do_while.instructions.emplace_back(variable_declaration);
 
         //Insert all the instructions of the foreach
-        std::copy(foreach.instructions.begin(), foreach.instructions.end(), std::back_inserter(do_while.instructions));
+        std::move(foreach.instructions.begin(), foreach.instructions.end(), std::back_inserter(do_while.instructions));
 
         ast::Integer inc;
         inc.value = 1;
@@ -378,9 +386,9 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
 
         do_while.instructions.emplace_back(repeat_assign);
 
-        if_.instructions.emplace_back(do_while);
+        if_.instructions.emplace_back(std::move(do_while));
 
-        instructions.emplace_back(if_);
+        instructions.emplace_back(std::move(if_));
 
         return instructions;
     }
@@ -390,45 +398,46 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
         result_type instructions;
 
         if(for_.start){
-            instructions.push_back(*for_.start);
+            instructions.push_back(std::move(*for_.start));
         }
 
         if(for_.condition){
             ast::DoWhile do_while;
             do_while.context = for_.context;
             do_while.condition = *for_.condition;
-            do_while.instructions = for_.instructions;
+            do_while.instructions = std::move(for_.instructions);
 
             if(for_.repeat){
-                do_while.instructions.push_back(*for_.repeat);
+                do_while.instructions.push_back(std::move(*for_.repeat));
             }
 
             ast::If if_;
             if_.context = for_.context;
-            if_.condition = *for_.condition;
-            if_.instructions.emplace_back(do_while);
+            if_.condition = std::move(*for_.condition);
+            if_.instructions.emplace_back(std::move(do_while));
 
-            instructions.emplace_back(if_);
+            instructions.emplace_back(std::move(if_));
         } else {
             ast::Boolean condition{true};
 
             ast::DoWhile do_while;
             do_while.context = for_.context;
             do_while.condition = condition;
-            do_while.instructions = for_.instructions;
+            do_while.instructions = std::move(for_.instructions);
 
             if(for_.repeat){
-                do_while.instructions.push_back(*for_.repeat);
+                do_while.instructions.push_back(std::move(*for_.repeat));
             }
 
-            instructions.emplace_back(do_while);
+            instructions.emplace_back(std::move(do_while));
         }
 
         return instructions;
     }
 
     result_type operator()(ast::Switch& switch_) const {
-        auto cases = switch_.cases;
+        //The switch is replaced, its cases can be moved
+        auto& cases = switch_.cases;
         auto value_type = visit(ast::GetTypeVisitor(), switch_.value);
 
         if(value_type == INT){
@@ -440,9 +449,12 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
             ast::If if_;
             if_.context = switch_.context;
             if_.condition = first_condition;
-            if_.instructions = cases[0].instructions;
+            if_.instructions = std::move(cases[0].instructions);
+
+            //The first case is already handled by the if
+            for(std::size_t i = 1; i < cases.size(); ++i){
+                auto& case_ = cases[i];
 
-            for(const auto& case_ : cases){
                 ast::Expression condition;
                 condition.context = switch_.context;
                 condition.first = ast::Value(switch_.value);
@@ -451,20 +463,20 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
                 ast::ElseIf else_if;
                 else_if.context = case_.context;
                 else_if.condition = condition;
-                else_if.instructions = case_.instructions;
+                else_if.instructions = std::move(case_.instructions);
 
-                if_.elseIfs.push_back(else_if);
+                if_.elseIfs.push_back(std::move(else_if));
             }
 
             if(switch_.default_case){
                 ast::Else else_;
                 else_.context = (*switch_.default_case).context;
-                else_.instructions = (*switch_.default_case).instructions;
+                else_.instructions = std::move((*switch_.default_case).instructions);
 
-                if_.else_ = else_;
+                if_.else_ = std::move(else_);
             }
 
-            return {ast::Instruction(if_)};
+            return single_instruction(std::move(if_));
         } else if(value_type == STRING){
             ast::FunctionCall first_condition;
             first_condition.context = switch_.context;
@@ -477,9 +489,12 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
             ast::If if_;
             if_.context = switch_.context;
             if_.condition = first_condition;
-            if_.instructions = cases[0].instructions;
+            if_.instructions = std::move(cases[0].instructions);
+
+            //The first case is already handled by the if
+            for(std::size_t i = 1; i < cases.size(); ++i){
+                auto& case_ = cases[i];
 
-            for(const auto& case_ : cases){
                 ast::FunctionCall condition;
                 condition.context = switch_.context;
                 (x3::file_position_tagged&) condition = case_;
@@ -491,20 +506,20 @@ struct InstructionTransformer : public boost::static_visitor<std::vector<ast::In
                 ast::ElseIf else_if;
                 else_if.context = case_.context;
                 else_if.condition = condition;
-                else_if.instructions = case_.instructions;
+                else_if.instructions = std::move(case_.instructions);
 
-                if_.elseIfs.push_back(else_if);
+                if_.elseIfs.push_back(std::move(else_if));
             }
 
             if(switch_.default_case){
                 ast::Else else_;
                 else_.context = (*switch_.default_case).context;
-                else_.instructions = (*switch_.default_case).instructions;
+                else_.instructions = std::move((*switch_.default_case).instructions);
 
-                if_.else_ = else_;
+                if_.else_ = std::move(else_);
             }
 
-            return {ast::Instruction(if_)};
+            return single_instruction(std::move(if_));
         } else {
             cpp_unreachable("Unhandled switch value type");
         }
@@ -700,7 +715,7 @@ struct TransformerVisitor : public boost::static_visitor<> {
             auto transformed = visit(instructionTransformer, *start);
 
             if(transformed.size() == 1){
-                *start = transformed[0];
+                *start = std::move(transformed[0]);
             } else if(transformed.size() > 1){
                 //Replace the current instruction with a scope of instructions
                 *start = ast::Scope{{std::move(transformed)}};
@@ -111,6 +111,63 @@ class FunctionCheckerVisitor : public boost::static_visitor<> {
             return variable_value;
         }
 
+        //memcpy and memset are resolved on the element type of the arrays and not on the exact types of the arguments
+        bool check_memory_intrinsic(ast::FunctionCall& functionCall, std::vector<std::shared_ptr<const Type>>& types){
+            auto& name = functionCall.function_name;
+
+            if(name == "memcpy"){
+                std::shared_ptr<const Type> dest;
+                std::shared_ptr<const Type> src;
+
+                if(types.size() == 3 && types[2] == INT){
+                    dest = types[0];
+                    src = types[1];
+                } else if(types.size() == 5 && types[1] == INT && types[3] == INT && types[4] == INT){
+                    dest = types[0];
+                    src = types[2];
+                } else {
+                    return false;
+                }
+
+                if(!dest->is_array() || !src->is_array()){
+                    this->context->error_handler.semantical_exception("memcpy can only copy between arrays", functionCall);
+                } else if(dest->data_type() != src->data_type()){
+                    this->context->error_handler.semantical_exception("memcpy needs arrays of the same type", functionCall);
+                } else {
+                    functionCall.mangled_name = "_F6memcpyPIPIIII";
+                }
+
+                return true;
+            } else if(name == "memset"){
+                std::shared_ptr<const Type> dest;
+                std::shared_ptr<const Type> value;
+
+                if(types.size() == 3 && types[2] == INT){
+                    dest = types[0];
+                    value = types[1];
+                } else if(types.size() == 4 && types[1] == INT && types[3] == INT){
+                    dest = types[0];
+                    value = types[2];
+                } else {
+                    return false;
+                }
+
+                if(!dest->is_array()){
+                    this->context->error_handler.semantical_exception("memset can only fill arrays", functionCall);
+                } else if(dest->data_type() != INT && dest->data_type() != CHAR && dest->data_type() != BOOL){
+                    this->context->error_handler.semantical_exception("memset can only fill arrays of int, char or bool", functionCall);
+                } else if(dest->data_type() != value){
+                    this->context->error_handler.semantical_exception("The value of memset must be of the type of the array elements", functionCall);
+                } else {
+                    functionCall.mangled_name = "_F6memsetPIIIII";
+                }
+
+                return true;
+            }
+
+            return false;
+        }
+
         template<typename V>
         void check_value(V& value){
             if(auto* ptr = boost::smart_relaxed_get<ast::FunctionCall>(&value)){
@@ -177,6 +234,10 @@ class FunctionCheckerVisitor : public boost::static_visitor<> {
                         } while(struct_type);
                     }
 
+                    if(check_memory_intrinsic(functionCall, types)){
+                        return;
+                    }
+
                     this->context->error_handler.semantical_exception("The function \"" + unmangle(original_mangled) + "\" does not exists", functionCall);
                 }
             } else if(auto* ptr = boost::smart_relaxed_get<ast::VariableValue>(&value)){
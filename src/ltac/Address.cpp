@@ -65,45 +65,43 @@ bool ltac::operator!=(ltac::Address& lhs, ltac::Address& rhs){
 }
 
 std::ostream& ltac::operator<<(std::ostream& out, const ltac::Address& address){
-    if(address.absolute){
-        if(address.displacement){
-            return out << "[" << *address.absolute << " + " << *address.displacement << "]";
-        }
+    bool first = true;
 
-        if(address.base_register){
-            return out << "[" << *address.absolute << " + " << *address.base_register << "]";
+    auto separator = [&out, &first](){
+        if(!first){
+            out << " + ";
         }
 
-        return out << "[" << *address.absolute << "]";
-    }
+        first = false;
+    };
 
-    if(address.base_register){
-        if(address.scaled_register){
-            if(address.scale){
-                if(address.displacement){
-                    return out << "[" << *address.base_register << " + " << *address.scaled_register << " * " << *address.scale << " + " << *address.displacement << "]";
-                }
+    out << "[";
 
-                return out << "[" << *address.base_register << " + " << *address.scaled_register << " * " << *address.scale << "]";
-            }
+    if(address.absolute){
+        separator();
+        out << *address.absolute;
+    }
 
-            if(address.displacement){
-                return out << "[" << *address.base_register << " + " << *address.scaled_register << " + " << *address.displacement << "]";
-            }
+    if(address.base_register){
+        separator();
+        out << *address.base_register;
+    }
 
-            return out << "[" << *address.base_register << " + " << *address.scaled_register << "]";
-        }
+    if(address.scaled_register){
+        separator();
+        out << *address.scaled_register;
 
-        if(address.displacement){
-            return out << "[" << *address.base_register << " + " << *address.displacement << "]";
+        if(address.scale){
+            out << " * " << *address.scale;
         }
-
-        return out << "[" << *address.base_register << "]";
     }
 
     if(address.displacement){
-        return out << "[" << *address.displacement << "]";
+        separator();
+        out << *address.displacement;
     }
 
-    cpp_unreachable("Invalid address type");
+    cpp_assert(!first, "Invalid address type");
+
+    return out << "]";
 }
@@ -28,17 +28,18 @@ using namespace eddic;
 ltac::Compiler::Compiler(Platform platform, std::shared_ptr<Configuration> configuration) : platform(platform), configuration(configuration) {}
 
 void ltac::Compiler::compile(mtac::Program& source, FloatPool& float_pool){
-    timing_timer timer(source.context->timing(), "ltac_compilation");
-
     for(auto& function : source.functions){
         compile(function, float_pool);
     }
 }
 
 void ltac::Compiler::compile(mtac::Function& function, FloatPool& float_pool){
+    timing_timer timer(function.context->global()->timing(), "ltac_compilation");
+
     log::emit<Trace>("Compiler") << "Compile LTAC for function " << function.get_name() << log::endl;
     
     //Compute the block usage (in order to know if we have to output the label)
+    block_usage.clear();
     mtac::computeBlockUsage(function, block_usage);
 
     resetNumbering();
@@ -73,7 +74,9 @@ void ltac::Compiler::compile(mtac::Function& function, FloatPool& float_pool){
            compiler.compile(quadruple); 
         }
 
+        //The MTAC statements are not used after this point
         block->statements.clear();
+        block->statements.shrink_to_fit();
 
         compiler.end_bb();
     }
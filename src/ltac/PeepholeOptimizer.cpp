@@ -429,7 +429,9 @@ bool basic_optimizations(mtac::Function& function, Platform platform){
     return optimized;
 }
 
-bool constant_propagation(mtac::Function& function){
+bool constant_propagation(mtac::Function& function, Platform platform){
+    auto descriptor = getPlatformDescriptor(platform);
+
     bool optimized = false;
 
     for(auto& bb : function){
@@ -443,6 +445,12 @@ bool constant_propagation(mtac::Function& function){
                 constants.erase(reg1);
             }
 
+            //The string instructions consume their registers
+            if(instruction.op == ltac::Operator::REP_STOS){
+                constants.erase(ltac::Register(descriptor->c_register()));
+                constants.erase(ltac::Register(descriptor->di_register()));
+            }
+
             //Collect constants
             if(instruction.op == ltac::Operator::XOR){
                 if(ltac::is_reg(*instruction.arg1) && ltac::is_reg(*instruction.arg2)){
@@ -516,6 +524,11 @@ bool copy_propagation(mtac::Function& function, Platform platform){
                 remove_reg(copies, ltac::Register(descriptor->d_register()));
             }
 
+            if(instruction.op == ltac::Operator::REP_STOS){
+                remove_reg(copies, ltac::Register(descriptor->c_register()));
+                remove_reg(copies, ltac::Register(descriptor->di_register()));
+            }
+
             //Collect copies
             if(instruction.op == ltac::Operator::MOV){
                 if(ltac::is_reg(*instruction.arg1)){
@@ -884,27 +897,31 @@ bool debug(const std::string& name, bool b, mtac::Function& function){
 
 } //end of anonymous namespace
 
-void eddic::ltac::optimize(mtac::Program& program, Platform platform){
-    timing_timer timer(program.context->timing(), "peephole_optimization");
+void eddic::ltac::optimize(mtac::Function& function, Platform platform){
+    timing_timer timer(function.context->global()->timing(), "peephole_optimization");
 
-    for(auto& function : program.functions){
-        if(log::enabled<Debug>()){
-            LOG<Debug>("Peephole") << "Start optimizations on " << function.get_name() << log::endl;
+    if(log::enabled<Debug>()){
+        LOG<Debug>("Peephole") << "Start optimizations on " << function.get_name() << log::endl;
 
-            //Print the function
-            ltac::Printer printer;
-            printer.print(function);
-        }
+        //Print the function
+        ltac::Printer printer;
+        printer.print(function);
+    }
 
-        bool optimized;
-        do {
-            optimized = false;
-            
-            optimized |= debug("Basic optimizations", basic_optimizations(function, platform), function);
-            optimized |= debug("Constant propagation", constant_propagation(function), function);
-            optimized |= debug("Copy propagation", copy_propagation(function, platform), function);
-            optimized |= debug("Dead-Code Elimination", dead_code_elimination(function), function);
-            optimized |= debug("Conditional move", conditional_move(function, platform), function);
-        } while(optimized);
+    bool optimized;
+    do {
+        optimized = false;
+        
+        optimized |= debug("Basic optimizations", basic_optimizations(function, platform), function);
+        optimized |= debug("Constant propagation", constant_propagation(function, platform), function);
+        optimized |= debug("Copy propagation", copy_propagation(function, platform), function);
+        optimized |= debug("Dead-Code Elimination", dead_code_elimination(function), function);
+        optimized |= debug("Conditional move", conditional_move(function, platform), function);
+    } while(optimized);
+}
+
+void eddic::ltac::optimize(mtac::Program& program, Platform platform){
+    for(auto& function : program.functions){
+        eddic::ltac::optimize(function, platform);
     }
 }
@@ -113,8 +113,12 @@ std::string to_string(ltac::Operator op){
             return "XORPS"; 
         case ltac::Operator::MOVDQU:
             return "MOVDQU"; 
+        case ltac::Operator::REP_STOS:
+            return "REP_STOS"; 
         case ltac::Operator::CALL:
             return "call";
+        case ltac::Operator::TAIL_CALL:
+            return "tail_call";
         case ltac::Operator::ALWAYS:
             return "always";
         case ltac::Operator::NE:
@@ -0,0 +1,425 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "logging.hpp"
+#include "timing.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+
+#include "mtac/Program.hpp"
+
+#include "ltac/address_folding.hpp"
+#include "ltac/Instruction.hpp"
+#include "ltac/Address.hpp"
+#include "ltac/Operator.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//base + index * scale + displacement
+struct Expression {
+    boost::optional<ltac::PseudoRegister> base;
+    boost::optional<ltac::PseudoRegister> index;
+    unsigned int scale = 1;
+    int displacement = 0;
+
+    bool depends(const ltac::PseudoRegister& reg) const {
+        return (base && *base == reg) || (index && *index == reg);
+    }
+};
+
+typedef std::unordered_map<ltac::PseudoRegister, Expression> Expressions;
+
+//The bytes of the variables addressed from BP
+typedef std::vector<std::pair<int, int>> Ranges;
+
+bool valid_scale(unsigned int scale){
+    return scale == 1 || scale == 2 || scale == 4 || scale == 8;
+}
+
+const ltac::PseudoRegister* pseudo_reg(const boost::optional<ltac::AddressRegister>& reg){
+    if(reg){
+        if(auto* ptr = boost::get<ltac::PseudoRegister>(&*reg)){
+            if(!ptr->bound){
+                return ptr;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+const ltac::PseudoRegister* pseudo_reg(const boost::optional<ltac::Argument>& arg){
+    if(arg){
+        if(auto* ptr = boost::get<ltac::PseudoRegister>(&*arg)){
+            if(!ptr->bound){
+                return ptr;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+bool is_bp(const boost::optional<ltac::AddressRegister>& reg){
+    if(reg){
+        if(auto* ptr = boost::get<ltac::Register>(&*reg)){
+            return *ptr == ltac::BP;
+        }
+    }
+
+    return false;
+}
+
+Ranges frame_ranges(mtac::Function& function, Platform platform){
+    Ranges ranges;
+
+    for(auto& variable : function.context->stored_variables()){
+        auto position = variable->position();
+
+        if(!variable->is_reference() && (position.isStack() || position.isParameter())){
+            ranges.emplace_back(position.offset(), position.offset() + static_cast<int>(variable->type()->size(platform)));
+        }
+    }
+
+    return ranges;
+}
+
+//An index on the stack must stay relative to the same variable
+bool same_variable(const Ranges& ranges, int lhs, int rhs){
+    for(auto& range : ranges){
+        if(lhs >= range.first && lhs < range.second){
+            return rhs >= range.first && rhs < range.second;
+        }
+    }
+
+    return false;
+}
+
+bool fold(ltac::Address& address, const Expressions& expressions, const Ranges& ranges){
+    if(!address.base_register && !address.scaled_register){
+        return false;
+    }
+
+    auto displacement = address.displacement ? *address.displacement : 0;
+    auto folded = address;
+    bool changed = false;
+
+    if(!address.scaled_register){
+        if(auto* base = pseudo_reg(address.base_register)){
+            auto it = expressions.find(*base);
+
+            if(it != expressions.end()){
+                auto& expression = it->second;
+
+                folded.base_register.reset();
+                if(expression.base){
+                    folded.base_register = ltac::AddressRegister(*expression.base);
+                }
+
+                if(expression.index){
+                    folded.scaled_register = ltac::AddressRegister(*expression.index);
+
+                    if(expression.scale != 1){
+                        folded.scale = expression.scale;
+                    }
+                }
+
+                displacement += expression.displacement;
+                changed = true;
+            }
+        }
+    } else if(auto* scaled = pseudo_reg(address.scaled_register)){
+        auto scale = address.scale ? *address.scale : 1;
+        auto it = expressions.find(*scaled);
+
+        if(it != expressions.end()){
+            auto& expression = it->second;
+
+            if(!expression.base && valid_scale(scale * expression.scale)){
+                folded.scaled_register = ltac::AddressRegister(*expression.index);
+                folded.scale.reset();
+
+                if(scale * expression.scale != 1){
+                    folded.scale = scale * expression.scale;
+                }
+
+                displacement += scale * expression.displacement;
+                changed = true;
+            } else if(expression.base && !expression.index && scale == 1){
+                folded.scaled_register = ltac::AddressRegister(*expression.base);
+                displacement += expression.displacement;
+                changed = true;
+            }
+        }
+
+        if(!changed){
+            if(auto* base = pseudo_reg(address.base_register)){
+                auto it = expressions.find(*base);
+
+                if(it != expressions.end() && it->second.base && !it->second.index){
+                    folded.base_register = ltac::AddressRegister(*it->second.base);
+                    displacement += it->second.displacement;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    if(!changed){
+        return false;
+    }
+
+    auto old_displacement = address.displacement ? *address.displacement : 0;
+
+    if(is_bp(address.base_register) && displacement != old_displacement && !same_variable(ranges, old_displacement, displacement)){
+        return false;
+    }
+
+    folded.displacement.reset();
+    if(displacement){
+        folded.displacement = displacement;
+    }
+
+    address = folded;
+
+    return true;
+}
+
+boost::optional<Expression> expression_of(ltac::Instruction& instruction){
+    if(!pseudo_reg(instruction.arg1)){
+        return boost::none;
+    }
+
+    if(instruction.op == ltac::Operator::MUL3){
+        auto* source = pseudo_reg(instruction.arg2);
+        auto* constant = boost::get<int>(&*instruction.arg3);
+
+        if(source && constant){
+            Expression expression;
+
+            if(*constant > 0 && valid_scale(*constant)){
+                expression.index = *source;
+                expression.scale = *constant;
+
+                return expression;
+            } else if(*constant > 1 && valid_scale(*constant - 1)){
+                expression.base = *source;
+                expression.index = *source;
+                expression.scale = *constant - 1;
+
+                return expression;
+            }
+        }
+    } else if(instruction.op == ltac::Operator::LEA){
+        auto& address = boost::get<ltac::Address>(*instruction.arg2);
+
+        if(address.absolute || (!address.base_register && !address.scaled_register)){
+            return boost::none;
+        }
+
+        auto* base = pseudo_reg(address.base_register);
+        auto* index = pseudo_reg(address.scaled_register);
+
+        if((address.base_register && !base) || (address.scaled_register && !index)){
+            return boost::none;
+        }
+
+        Expression expression;
+
+        if(base){
+            expression.base = *base;
+        }
+
+        if(index){
+            expression.index = *index;
+            expression.scale = address.scale ? *address.scale : 1;
+        }
+
+        expression.displacement = address.displacement ? *address.displacement : 0;
+
+        return expression;
+    }
+
+    return boost::none;
+}
+
+//Use LEA instead of IMUL for the small constants
+bool multiply_with_lea(ltac::Instruction& instruction, const Expression& expression){
+    if(instruction.op != ltac::Operator::MUL3 || expression.scale == 1){
+        return false;
+    }
+
+    ltac::Address address;
+
+    if(expression.base){
+        address.base_register = ltac::AddressRegister(*expression.base);
+    }
+
+    address.scaled_register = ltac::AddressRegister(*expression.index);
+
+    //[reg + reg] is shorter than [reg * 2]
+    if(!expression.base && expression.scale == 2){
+        address.base_register = ltac::AddressRegister(*expression.index);
+    } else {
+        address.scale = expression.scale;
+    }
+
+    instruction.op = ltac::Operator::LEA;
+    instruction.arg2 = address;
+    instruction.arg3.reset();
+
+    return true;
+}
+
+bool written_first(ltac::Operator op){
+    return op != ltac::Operator::CMP_INT && op != ltac::Operator::CMP_FLOAT && op != ltac::Operator::PUSH;
+}
+
+bool read_first(ltac::Operator op){
+    return !ltac::erase_result_complete(op) && op != ltac::Operator::MOVDQU;
+}
+
+void invalidate(Expressions& expressions, const ltac::PseudoRegister& reg){
+    expressions.erase(reg);
+
+    auto it = expressions.begin();
+    while(it != expressions.end()){
+        if(it->second.depends(reg)){
+            it = expressions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void count_uses(std::unordered_map<ltac::PseudoRegister, std::size_t>& uses, const boost::optional<ltac::Argument>& arg, bool read){
+    if(arg){
+        if(auto* ptr = boost::get<ltac::PseudoRegister>(&*arg)){
+            if(read){
+                ++uses[*ptr];
+            }
+        } else if(auto* ptr = boost::get<ltac::Address>(&*arg)){
+            if(ptr->base_register){
+                if(auto* reg = boost::get<ltac::PseudoRegister>(&*ptr->base_register)){
+                    ++uses[*reg];
+                }
+            }
+
+            if(ptr->scaled_register){
+                if(auto* reg = boost::get<ltac::PseudoRegister>(&*ptr->scaled_register)){
+                    ++uses[*reg];
+                }
+            }
+        }
+    }
+}
+
+//The computations folded into all their uses are not necessary anymore
+void remove_folded(mtac::Function& function, std::unordered_set<std::size_t>& computations){
+    bool removed = true;
+
+    while(removed){
+        removed = false;
+
+        std::unordered_map<ltac::PseudoRegister, std::size_t> uses;
+
+        for(auto& bb : function){
+            for(auto& instruction : bb->l_statements){
+                count_uses(uses, instruction.arg1, read_first(instruction.op));
+                count_uses(uses, instruction.arg2, true);
+                count_uses(uses, instruction.arg3, true);
+
+                for(auto& reg : instruction.uses){
+                    ++uses[reg];
+                }
+            }
+        }
+
+        for(auto& bb : function){
+            auto& statements = bb->l_statements;
+
+            auto end = std::remove_if(statements.begin(), statements.end(), [&uses, &computations](ltac::Instruction& instruction){
+                return computations.count(instruction.uid()) && !uses.count(boost::get<ltac::PseudoRegister>(*instruction.arg1));
+            });
+
+            if(end != statements.end()){
+                statements.erase(end, statements.end());
+                removed = true;
+            }
+        }
+    }
+}
+
+} //end of anonymous namespace
+
+void ltac::fold_addresses(mtac::Function& function, Platform platform){
+    if(!function.context){
+        return;
+    }
+
+    timing_timer timer(function.context->global()->timing(), "address_folding");
+
+    auto ranges = frame_ranges(function, platform);
+
+    std::unordered_set<std::size_t> computations;
+
+    for(auto& bb : function){
+        Expressions expressions;
+
+        for(auto& instruction : bb->l_statements){
+            for(auto* arg : {&instruction.arg1, &instruction.arg2, &instruction.arg3}){
+                if(*arg){
+                    if(auto* address = boost::get<ltac::Address>(&**arg)){
+                        while(fold(*address, expressions, ranges)){
+                            function.context->global()->stats().inc_counter("addresses_folded");
+                        }
+                    }
+                }
+            }
+
+            auto expression = expression_of(instruction);
+
+            if(auto* reg = pseudo_reg(instruction.arg1)){
+                if(written_first(instruction.op)){
+                    invalidate(expressions, *reg);
+                }
+            }
+
+            for(auto& reg : instruction.kills){
+                invalidate(expressions, reg);
+            }
+
+            if(expression){
+                auto reg = boost::get<ltac::PseudoRegister>(*instruction.arg1);
+
+                if(multiply_with_lea(instruction, *expression)){
+                    function.context->global()->stats().inc_counter("lea_multiplications");
+                }
+
+                if(!expression->depends(reg)){
+                    expressions[reg] = *expression;
+                    computations.insert(instruction.uid());
+                }
+            }
+        }
+    }
+
+    remove_folded(function, computations);
+}
+
+void ltac::fold_addresses(mtac::Program& program, Platform platform){
+    for(auto& function : program.functions){
+        ltac::fold_addresses(function, platform);
+    }
+}
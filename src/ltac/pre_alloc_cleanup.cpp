@@ -6,6 +6,7 @@
 //=======================================================================
 
 #include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
 
 #include "mtac/Program.hpp"
 
@@ -23,32 +24,36 @@ bool is_float_pseudo_reg(Variant& var){
     return boost::get<ltac::PseudoFloatRegister>(&*var);
 }
 
-void ltac::pre_alloc_cleanup(mtac::Program& program){
-    timing_timer timer(program.context->timing(), "pre_alloc_cleanup");
+void ltac::pre_alloc_cleanup(mtac::Function& function){
+    timing_timer timer(function.context->global()->timing(), "pre_alloc_cleanup");
 
-    for(auto& function : program.functions){
-        for(auto& bb : function){
-            bb->l_statements.erase(std::remove_if(bb->l_statements.begin(), bb->l_statements.end(), [](auto& instruction){
-                if(instruction.op == ltac::Operator::MOV && is_pseudo_reg(instruction.arg1) && is_pseudo_reg(instruction.arg2)){
-                    auto reg1 = boost::get<ltac::PseudoRegister>(*instruction.arg1);
-                    auto reg2 = boost::get<ltac::PseudoRegister>(*instruction.arg2);
-
-                    if(reg1 == reg2){
-                        return true;
-                    }
+    for(auto& bb : function){
+        bb->l_statements.erase(std::remove_if(bb->l_statements.begin(), bb->l_statements.end(), [](auto& instruction){
+            if(instruction.op == ltac::Operator::MOV && is_pseudo_reg(instruction.arg1) && is_pseudo_reg(instruction.arg2)){
+                auto reg1 = boost::get<ltac::PseudoRegister>(*instruction.arg1);
+                auto reg2 = boost::get<ltac::PseudoRegister>(*instruction.arg2);
+
+                if(reg1 == reg2){
+                    return true;
                 }
+            }
 
-                if(instruction.op == ltac::Operator::FMOV && is_float_pseudo_reg(instruction.arg1) && is_float_pseudo_reg(instruction.arg2)){
-                    auto reg1 = boost::get<ltac::PseudoFloatRegister>(*instruction.arg1);
-                    auto reg2 = boost::get<ltac::PseudoFloatRegister>(*instruction.arg2);
+            if(instruction.op == ltac::Operator::FMOV && is_float_pseudo_reg(instruction.arg1) && is_float_pseudo_reg(instruction.arg2)){
+                auto reg1 = boost::get<ltac::PseudoFloatRegister>(*instruction.arg1);
+                auto reg2 = boost::get<ltac::PseudoFloatRegister>(*instruction.arg2);
 
-                    if(reg1 == reg2){
-                        return true;
-                    }
+                if(reg1 == reg2){
+                    return true;
                 }
+            }
+
+            return false;
+        }), bb->l_statements.end());
+    }
+}
 
-                return false;
-            }), bb->l_statements.end());
-        }
+void ltac::pre_alloc_cleanup(mtac::Program& program){
+    for(auto& function : program.functions){
+        ltac::pre_alloc_cleanup(function);
     }
 }
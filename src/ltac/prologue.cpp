@@ -19,6 +19,9 @@
 #include "ltac/Address.hpp"
 #include "ltac/Instruction.hpp"
 #include "ltac/prologue.hpp"
+#include "ltac/LiveRegistersProblem.hpp"
+
+#include "mtac/GlobalOptimizations.hpp"
 
 using namespace eddic;
 
@@ -66,16 +69,30 @@ std::set<ltac::FloatRegister> float_parameter_registers(eddic::Function& functio
     return overriden_float_registers;
 }
 
-bool callee_save(Function& definition, ltac::Register reg, Platform platform, std::shared_ptr<Configuration> configuration){
+bool return_register(eddic::Function& definition, ltac::Register reg, Platform platform){
     auto return_type = definition.return_type();
     auto descriptor = getPlatformDescriptor(platform);
 
-    //Do not save the return registers
     if((return_type == INT || return_type == BOOL || return_type == CHAR) && reg.reg == descriptor->int_return_register1()){
-        return false;
+        return true;
     } else if(return_type == STRING && (reg.reg == descriptor->int_return_register1() || reg.reg == descriptor->int_return_register2())){
-        return false;
+        return true;
     } else if(return_type->is_pointer() && reg.reg == descriptor->int_return_register1()){ 
+        return true;
+    }
+
+    return false;
+}
+
+bool return_register(eddic::Function& definition, ltac::FloatRegister reg, Platform platform){
+    auto descriptor = getPlatformDescriptor(platform);
+
+    return definition.return_type() == FLOAT && reg.reg == descriptor->float_return_register();
+}
+
+bool callee_save(Function& definition, ltac::Register reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    //Do not save the return registers
+    if(return_register(definition, reg, platform)){
         return false;
     }
 
@@ -90,11 +107,8 @@ bool callee_save(Function& definition, ltac::Register reg, Platform platform, st
 }
 
 bool callee_save(eddic::Function& definition, ltac::FloatRegister reg, Platform platform, std::shared_ptr<Configuration> configuration){
-    auto return_type = definition.return_type();
-    auto descriptor = getPlatformDescriptor(platform);
-
     //Do not save the return register
-    if(return_type == FLOAT && reg.reg == descriptor->float_return_register()){
+    if(return_register(definition, reg, platform)){
         return false;
     } 
 
@@ -209,8 +223,105 @@ bool caller_save(mtac::Function& source, eddic::Function& target_definition, lta
     return false;
 }
 
+typedef std::unordered_map<std::string, mtac::Function*> Functions;
+typedef std::shared_ptr<mtac::DataFlowResults<ltac::LiveRegistersProblem::ProblemDomain>> Liveness;
+
+//The registers that may be modified by a call to the target
+bool clobbers(Functions& functions, eddic::Function& target, ltac::Register reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    //The arguments are passed in the parameters registers
+    if(contains(parameter_registers(target, platform, configuration), reg)){
+        return true;
+    }
+
+    auto it = functions.find(target.mangled_name());
+
+    if(it != functions.end()){
+        return contains(it->second->clobbered_registers(), reg);
+    }
+
+    //The standard functions only modify their parameters and return registers
+    return return_register(target, reg, platform);
+}
+
+bool clobbers(Functions& functions, eddic::Function& target, ltac::FloatRegister reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    //The arguments are passed in the parameters registers
+    if(contains(float_parameter_registers(target, platform, configuration), reg)){
+        return true;
+    }
+
+    auto it = functions.find(target.mangled_name());
+
+    if(it != functions.end()){
+        return contains(it->second->clobbered_float_registers(), reg);
+    }
+
+    //The standard functions only modify their parameters and return registers
+    return return_register(target, reg, platform);
+}
+
+bool killed(const ltac::Instruction& call, ltac::Register reg){
+    return std::find(call.hard_kills.begin(), call.hard_kills.end(), reg) != call.hard_kills.end();
+}
+
+bool killed(const ltac::Instruction& call, ltac::FloatRegister reg){
+    return std::find(call.hard_float_kills.begin(), call.hard_float_kills.end(), reg) != call.hard_float_kills.end();
+}
+
+template<typename Values>
+bool live(Values& values, ltac::Register reg){
+    return values.find(reg) != values.end();
+}
+
+template<typename Values>
+bool live(Values& values, ltac::FloatRegister reg){
+    return values.find(reg) != values.fend();
+}
+
+struct CallerSaves {
+    std::vector<ltac::Register> registers;
+    std::vector<ltac::FloatRegister> float_registers;
+};
+
+template<typename Reg, typename Values>
+bool caller_save(mtac::Function& function, ltac::Instruction& call, Values* values, Functions& functions, Reg reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    auto& target = *call.target_function;
+
+    //Without liveness information, only the registers holding variables are saved
+    if(!values){
+        return caller_save(function, target, reg, platform, configuration);
+    }
+
+    //Only the values still needed after the call and modified by the callee are saved
+    return live(*values, reg) && clobbers(functions, target, reg, platform, configuration) && !killed(call, reg) && !return_register(target, reg, platform);
+}
+
+CallerSaves caller_saves(mtac::Function& function, ltac::Instruction& call, Liveness& liveness, Functions& functions, Platform platform, std::shared_ptr<Configuration> configuration){
+    CallerSaves saves;
+
+    ltac::LiveRegistersProblem::ProblemDomain::Values* values = nullptr;
+    if(liveness->OUT_S.count(call.uid()) && !liveness->OUT_S[call.uid()].top()){
+        values = &liveness->OUT_S[call.uid()].values();
+    }
+
+    for(auto& reg : function.use_registers()){
+        if(caller_save(function, call, values, functions, reg, platform, configuration)){
+            saves.registers.push_back(reg);
+            function.context->global()->stats().inc_counter("caller_saved_registers");
+        }
+    }
+
+    for(auto& float_reg : function.use_float_registers()){
+        if(caller_save(function, call, values, functions, float_reg, platform, configuration)){
+            saves.float_registers.push_back(float_reg);
+            function.context->global()->stats().inc_counter("caller_saved_registers");
+        }
+    }
+
+    return saves;
+}
+
 template<typename It>
-void caller_save_registers(mtac::Function& function, eddic::Function& target_function, mtac::basic_block_p bb, It it, Platform platform, std::shared_ptr<Configuration> configuration){
+void caller_save_registers(const CallerSaves& saves, mtac::basic_block_p bb, It it, Platform platform){
     auto pre_it = it.it;
 
     while(true){
@@ -222,24 +333,20 @@ void caller_save_registers(mtac::Function& function, eddic::Function& target_fun
             if(statement.op == ltac::Operator::PRE_PARAM){
                 statement.op = ltac::Operator::NOP;
 
-                for(auto& float_reg : boost::adaptors::reverse(function.use_float_registers())){
-                    if(caller_save(function, target_function, float_reg, platform, configuration)){
-                        pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::FMOV, ltac::Address(ltac::SP, 0), float_reg));
-                        pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::SUB, ltac::SP, static_cast<int>(FLOAT->size(platform))));
-                    }
+                for(auto& float_reg : boost::adaptors::reverse(saves.float_registers)){
+                    pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::FMOV, ltac::Address(ltac::SP, 0), float_reg));
+                    pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::SUB, ltac::SP, static_cast<int>(FLOAT->size(platform))));
                 }
 
-                for(auto& reg : boost::adaptors::reverse(function.use_registers())){
-                    if(caller_save(function, target_function, reg, platform, configuration)){
-                        pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::PUSH, reg));
-                    }
+                for(auto& reg : boost::adaptors::reverse(saves.registers)){
+                    pre_it = bb->l_statements.insert(pre_it, ltac::Instruction(ltac::Operator::PUSH, reg));
                 }
 
                 return;
             }
         }
 
-        bb = bb->prev;
+        bb = bb->prev();
         pre_it = bb->l_statements.end();
     }
 }
@@ -255,15 +362,26 @@ void find(It& it, std::size_t uid){
     }
 }
 
+//The instructions are only inserted before the searched one, it cannot be before its old position
 template<typename It>
-void caller_cleanup(mtac::Function& function, eddic::Function& target_function, mtac::basic_block_p bb, It it, Platform platform, std::shared_ptr<Configuration> configuration){
+void find(It& it, std::size_t uid, std::size_t position){
+    it.restart();
+    it.it += position;
+
+    find(it, uid);
+}
+
+template<typename It>
+void caller_cleanup(mtac::Function& function, Liveness& liveness, Functions& functions, mtac::basic_block_p bb, It it, Platform platform, std::shared_ptr<Configuration> configuration){
     auto call_uid = it->uid();
+    auto call_position = it.it - it.container.begin();
+
+    auto saves = caller_saves(function, *it, liveness, functions, platform, configuration);
 
-    caller_save_registers(function, target_function, bb, it, platform, configuration);
+    caller_save_registers(saves, bb, it, platform);
 
     //The iterator has been invalidated by the save, find the call again
-    it.restart();
-    find(it, call_uid);
+    find(it, call_uid, call_position);
 
     if(it.has_next()){
         ++it;
@@ -285,37 +403,413 @@ void caller_cleanup(mtac::Function& function, eddic::Function& target_function,
         }
     }
 
-    for(auto& float_reg : boost::adaptors::reverse(function.use_float_registers())){
-        if(caller_save(function, target_function, float_reg, platform, configuration)){
-            it.insert_after(ltac::Instruction(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
-            it.insert_after(ltac::Instruction(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
-        }
+    for(auto& float_reg : boost::adaptors::reverse(saves.float_registers)){
+        it.insert_after(ltac::Instruction(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
+        it.insert_after(ltac::Instruction(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
     }
     
-    for(auto& reg : boost::adaptors::reverse(function.use_registers())){
-        if(caller_save(function, target_function, reg, platform, configuration)){
-            it.insert_after(ltac::Instruction(ltac::Operator::POP, reg));
+    for(auto& reg : boost::adaptors::reverse(saves.registers)){
+        it.insert_after(ltac::Instruction(ltac::Operator::POP, reg));
+    }
+
+}
+
+bool is_stack_register(const ltac::Argument& arg){
+    if(auto* ptr = boost::get<ltac::Register>(&arg)){
+        return *ptr == ltac::BP || *ptr == ltac::SP;
+    }
+
+    return false;
+}
+
+//A pointer to the stack frame of the function may be passed to the callee
+bool frame_escapes(mtac::Function& function){
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(statement.op == ltac::Operator::LEA){
+                auto& address = boost::get<ltac::Address>(*statement.arg2);
+
+                auto* base = address.base_register ? boost::get<ltac::Register>(&*address.base_register) : nullptr;
+
+                if(base && (*base == ltac::BP || *base == ltac::SP)){
+                    return true;
+                }
+            }
+
+            if((statement.arg2 && is_stack_register(*statement.arg2)) || (statement.arg3 && is_stack_register(*statement.arg3))){
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool stack_arguments(eddic::Function& target, Platform platform, std::shared_ptr<Configuration> configuration){
+    auto registers = parameter_registers(target, platform, configuration).size() + float_parameter_registers(target, platform, configuration).size();
+
+    return registers != target.parameters().size();
+}
+
+//The epilogue must not restore a register holding an argument of the callee
+bool restores_arguments(mtac::Function& function, eddic::Function& target, Platform platform, std::shared_ptr<Configuration> configuration){
+    for(auto& reg : parameter_registers(target, platform, configuration)){
+        if(function.use_registers().count(reg) && callee_save(function.definition(), reg, platform, configuration)){
+            return true;
+        }
+    }
+
+    for(auto& reg : float_parameter_registers(target, platform, configuration)){
+        if(function.use_float_registers().count(reg) && callee_save(function.definition(), reg, platform, configuration)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool useless_after_call(const ltac::Instruction& statement){
+    if(statement.op == ltac::Operator::NOP){
+        return true;
+    }
+
+    //Deallocation of the (empty) stack arguments
+    if(statement.op == ltac::Operator::ADD && is_stack_register(*statement.arg1) && mtac::equals<int>(*statement.arg2, 0)){
+        return true;
+    }
+
+    //Copy of the result in the return register
+    if(statement.op == ltac::Operator::MOV){
+        auto* lhs = boost::get<ltac::Register>(&*statement.arg1);
+        auto* rhs = boost::get<ltac::Register>(&*statement.arg2);
+
+        return lhs && rhs && *lhs == *rhs;
+    }
+
+    if(statement.op == ltac::Operator::FMOV){
+        auto* lhs = boost::get<ltac::FloatRegister>(&*statement.arg1);
+        auto* rhs = boost::get<ltac::FloatRegister>(&*statement.arg2);
+
+        return lhs && rhs && *lhs == *rhs;
+    }
+
+    return false;
+}
+
+//The call must be directly followed by the return of the function, end is set to the end of the dead instructions
+bool tail_position(mtac::Function& function, mtac::basic_block_p bb, std::size_t call, std::size_t& end){
+    for(std::size_t i = call + 1; i < bb->l_statements.size(); ++i){
+        auto& statement = bb->l_statements[i];
+
+        if(statement.op == ltac::Operator::PRE_RET){
+            end = i + 1;
+            return true;
+        }
+
+        if(!useless_after_call(statement)){
+            return false;
+        }
+    }
+
+    end = bb->l_statements.size();
+
+    if(bb->next() != function.exit_bb()){
+        return false;
+    }
+
+    for(auto& statement : function.exit_bb()->l_statements){
+        if(statement.op != ltac::Operator::NOP && !statement.is_label()){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//No registers have to be saved before a tail call
+void remove_pre_param(mtac::basic_block_p bb, std::size_t call){
+    auto i = call;
+
+    while(bb){
+        while(i > 0){
+            --i;
+
+            if(bb->l_statements[i].op == ltac::Operator::PRE_PARAM){
+                bb->l_statements[i].op = ltac::Operator::NOP;
+                return;
+            }
+        }
+
+        bb = bb->prev();
+
+        if(bb){
+            i = bb->l_statements.size();
+        }
+    }
+}
+
+/*!
+ * \brief Replace the calls directly followed by a return by a jump to the callee after the epilogue.
+ *
+ * Only the calls without arguments on the stack are transformed, the callee then returns directly to the caller
+ * of the function.
+ */
+void sibling_calls(mtac::Function& function, int size, bool omit_fp, Platform platform, std::shared_ptr<Configuration> configuration){
+    if(function.is_main() || frame_escapes(function)){
+        return;
+    }
+
+    for(auto& bb : function){
+        for(std::size_t i = 0; i < bb->l_statements.size(); ++i){
+            auto& statement = bb->l_statements[i];
+
+            if(statement.op != ltac::Operator::CALL){
+                continue;
+            }
+
+            auto& target = *statement.target_function;
+
+            std::size_t end;
+            if(!tail_position(function, bb, i, end) || stack_arguments(target, platform, configuration) || restores_arguments(function, target, platform, configuration)){
+                continue;
+            }
+
+            statement.op = ltac::Operator::TAIL_CALL;
+            auto uid = statement.uid();
+
+            bb->l_statements.erase(bb->l_statements.begin() + i + 1, bb->l_statements.begin() + end);
+
+            remove_pre_param(bb, i);
+
+            //The frame is destroyed before the jump
+            auto it = iterate(bb->l_statements);
+            find(it, uid);
+
+            if(!omit_fp){
+                it.insert(ltac::Instruction(ltac::Operator::LEAVE));
+            }
+
+            it.insert(ltac::Instruction(ltac::Operator::ADD, ltac::SP, size));
+
+            callee_restore_registers(function, it, platform, configuration);
+
+            function.context->global()->stats().inc_counter("sibling_calls");
+
+            break;
         }
     }
 }
 
+//The registers modified by the function itself and not restored by its epilogue
+void local_clobbers(mtac::Function& function, Platform platform, std::shared_ptr<Configuration> configuration){
+    for(auto& reg : function.use_registers()){
+        if(function.is_main() || !callee_save(function.definition(), reg, platform, configuration)){
+            function.clobber(reg);
+        }
+    }
+
+    for(auto& float_reg : function.use_float_registers()){
+        if(function.is_main() || !callee_save(function.definition(), float_reg, platform, configuration)){
+            function.clobber(float_reg);
+        }
+    }
+}
+
+//The callee saved registers are already restored when a tail call is done
+bool saved(mtac::Function& function, ltac::Instruction& call, ltac::Register reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    return call.op == ltac::Operator::CALL && !function.is_main() 
+        && contains(function.use_registers(), reg) && callee_save(function.definition(), reg, platform, configuration);
+}
+
+bool saved(mtac::Function& function, ltac::Instruction& call, ltac::FloatRegister reg, Platform platform, std::shared_ptr<Configuration> configuration){
+    return call.op == ltac::Operator::CALL && !function.is_main() 
+        && contains(function.use_float_registers(), reg) && callee_save(function.definition(), reg, platform, configuration);
+}
+
+//The registers modified by the callees and not saved by the function
+bool callees_clobbers(mtac::Function& function, Functions& functions, Platform platform, std::shared_ptr<Configuration> configuration){
+    bool changes = false;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(statement.op != ltac::Operator::CALL && statement.op != ltac::Operator::TAIL_CALL){
+                continue;
+            }
+
+            auto& target = *statement.target_function;
+            auto it = functions.find(target.mangled_name());
+
+            if(it != functions.end()){
+                for(auto& reg : it->second->clobbered_registers()){
+                    if(!saved(function, statement, reg, platform, configuration)){
+                        changes |= function.clobber(reg);
+                    }
+                }
+
+                for(auto& float_reg : it->second->clobbered_float_registers()){
+                    if(!saved(function, statement, float_reg, platform, configuration)){
+                        changes |= function.clobber(float_reg);
+                    }
+                }
+            } else {
+                //The standard functions only modify their parameters and return registers
+                for(auto& reg : parameter_registers(target, platform, configuration)){
+                    if(!saved(function, statement, reg, platform, configuration)){
+                        changes |= function.clobber(reg);
+                    }
+                }
+
+                for(auto& float_reg : float_parameter_registers(target, platform, configuration)){
+                    if(!saved(function, statement, float_reg, platform, configuration)){
+                        changes |= function.clobber(float_reg);
+                    }
+                }
+
+                for(auto& reg : statement.hard_kills){
+                    if(!saved(function, statement, reg, platform, configuration)){
+                        changes |= function.clobber(reg);
+                    }
+                }
+
+                for(auto& float_reg : statement.hard_float_kills){
+                    if(!saved(function, statement, float_reg, platform, configuration)){
+                        changes |= function.clobber(float_reg);
+                    }
+                }
+            }
+        }
+    }
+
+    return changes;
+}
+
+//The registers clobbered by a group of functions, only a recursive group needs to be iterated
+void compute_clobbers(const std::vector<mtac::Function*>& group, Functions& functions, Platform platform, std::shared_ptr<Configuration> configuration){
+    for(auto* function : group){
+        local_clobbers(*function, platform, configuration);
+    }
+
+    bool recursive = group.size() > 1;
+
+    for(auto& bb : *group.front()){
+        for(auto& statement : bb->l_statements){
+            if((statement.op == ltac::Operator::CALL || statement.op == ltac::Operator::TAIL_CALL) && statement.target_function == &group.front()->definition()){
+                recursive = true;
+            }
+        }
+    }
+
+    bool changes = true;
+    while(changes){
+        changes = false;
+
+        for(auto* function : group){
+            changes |= callees_clobbers(*function, functions, platform, configuration);
+        }
+
+        changes &= recursive;
+    }
+}
+
+int frame_size(mtac::Function& function, Platform platform){
+    auto size = function.context->size();
+
+    //Align stack pointer to the size of an INT
+
+    if(size % INT->size(platform) != 0){
+        int padding = INT->size(platform) - (size % INT->size(platform));
+        size += padding;
+    }
+
+    return size;
+}
+
 } //End of anonymous
 
-void ltac::generate_prologue_epilogue(mtac::Program& program, std::shared_ptr<Configuration> configuration){
+ltac::PrologueGenerator::PrologueGenerator(mtac::Program& program, std::shared_ptr<Configuration> configuration) : program(program), configuration(configuration) {
+    for(auto& function : program.functions){
+        functions[function.definition().mangled_name()] = &function;
+    }
+}
+
+std::vector<std::vector<mtac::Function*>> ltac::PrologueGenerator::groups(){
+    std::vector<std::vector<mtac::Function*>> groups;
+    std::unordered_set<mtac::Function*> grouped;
+
+    if(program.cg.entry){
+        for(auto& component : program.cg.strongly_connected_components()){
+            std::vector<mtac::Function*> group;
+
+            for(auto& definition : component){
+                auto it = functions.find(definition.get().mangled_name());
+
+                if(it != functions.end() && grouped.insert(it->second).second){
+                    group.push_back(it->second);
+                }
+            }
+
+            if(!group.empty()){
+                groups.push_back(std::move(group));
+            }
+        }
+    }
+
+    std::vector<mtac::Function*> rest;
+
+    for(auto& function : program.functions){
+        if(grouped.insert(&function).second){
+            rest.push_back(&function);
+        }
+    }
+
+    if(!rest.empty()){
+        groups.push_back(std::move(rest));
+    }
+
+    return groups;
+}
+
+std::vector<mtac::Function*> ltac::PrologueGenerator::callees(mtac::Function& function){
+    std::vector<mtac::Function*> callees;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(statement.op == ltac::Operator::CALL || statement.op == ltac::Operator::TAIL_CALL){
+                auto it = functions.find(statement.target_function->mangled_name());
+
+                if(it != functions.end()){
+                    callees.push_back(it->second);
+                }
+            }
+        }
+    }
+
+    return callees;
+}
+
+void ltac::PrologueGenerator::generate(const std::vector<mtac::Function*>& group){
     timing_timer timer(program.context->timing(), "prologue_generation");
 
     bool omit_fp = configuration->option_defined("fomit-frame-pointer");
     auto platform = program.context->target_platform();
 
-    for(auto& function : program.functions){
-        auto size = function.context->size();
+    //Transform the calls in tail position before the generation of their epilogue
+    if(configuration->option_defined("ftail-calls")){
+        for(auto* function : group){
+            sibling_calls(*function, frame_size(*function, platform), omit_fp, platform, configuration);
+        }
+    }
 
-        //Align stack pointer to the size of an INT
+    //The registers saved around a call depend on the registers modified by the callee
+    compute_clobbers(group, functions, platform, configuration);
 
-        if(size % INT->size(platform) != 0){
-            int padding = INT->size(platform) - (size % INT->size(platform));
-            size += padding;
-        }
+    for(auto* function_ptr : group){
+        auto& function = *function_ptr;
+        auto size = frame_size(function, platform);
+
+        //The restores of the epilogue would keep the callee saved registers live
+        ltac::LiveRegistersProblem problem;
+        auto liveness = mtac::data_flow(function, problem);
 
         //1. Generate prologue
         
@@ -382,13 +876,13 @@ void ltac::generate_prologue_epilogue(mtac::Program& program, std::shared_ptr<Co
             while(it.has_next()){
                 auto& statement = *it;
                 auto uid = it->uid();
+                auto position = it.it - it.container.begin();
 
                 if(statement.op == ltac::Operator::CALL){
-                    caller_cleanup(function, *statement.target_function, bb, it, platform, configuration);
+                    caller_cleanup(function, liveness, functions, bb, it, platform, configuration);
 
                     //The iterator is invalidated by the cleanup, necessary to find the call again
-                    it.restart();
-                    find(it, uid);
+                    find(it, uid, position);
                 }
 
                 ++it;
@@ -396,3 +890,11 @@ void ltac::generate_prologue_epilogue(mtac::Program& program, std::shared_ptr<Co
         }
     }
 }
+
+void ltac::generate_prologue_epilogue(mtac::Program& program, std::shared_ptr<Configuration> configuration){
+    PrologueGenerator generator(program, configuration);
+
+    for(auto& group : generator.groups()){
+        generator.generate(group);
+    }
+}
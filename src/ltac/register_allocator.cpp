@@ -24,14 +24,16 @@
 #include "ltac/Printer.hpp"
 
 /*
- * Register allocation using Chaitin-style graph coloring allocation. 
+ * Register allocation using Chaitin-Briggs optimistic graph coloring allocation. 
  *
  * The renumber and coalescing are simplified by renumbering coalescing 
  * only pseudo registers that are local to a basic block. 
  *
+ * The spill decisions are deferred to the select phase. The pseudo registers 
+ * defined only by a constant or by a constant address are recomputed at their
+ * uses instead of being spilled. 
+ *
  * TODO:
- *  - Use Chaitin-Briggs optimistic coloring
- *  - Implement rematerialization
  *  - Use UD-chains and make renumber and coalescing complete
  */
 
@@ -485,6 +487,72 @@ bool coalesce(ltac::interference_graph<Pseudo>& graph, mtac::Function& function)
 
 static const std::size_t store_cost = 5;
 static const std::size_t load_cost = 3;
+static const std::size_t rematerialization_cost = 1;
+
+bool killed(ltac::Instruction& statement, const ltac::PseudoRegister& reg){
+    return std::find(statement.kills.begin(), statement.kills.end(), reg) != statement.kills.end();
+}
+
+bool killed(ltac::Instruction& statement, const ltac::PseudoFloatRegister& reg){
+    return std::find(statement.float_kills.begin(), statement.float_kills.end(), reg) != statement.float_kills.end();
+}
+
+//The address does not depend on any register except the frame
+bool constant_address(const ltac::Address& address){
+    if(address.scaled_register){
+        return false;
+    }
+
+    if(address.base_register){
+        auto* reg = boost::get<ltac::Register>(&*address.base_register);
+        return reg && *reg == ltac::BP;
+    }
+
+    return true;
+}
+
+bool constant_value(ltac::Instruction& statement){
+    if(statement.op == ltac::Operator::MOV){
+        return boost::get<int>(&*statement.arg2) || boost::get<std::string>(&*statement.arg2);
+    } else if(statement.op == ltac::Operator::LEA){
+        return constant_address(boost::get<ltac::Address>(*statement.arg2));
+    }
+
+    return false;
+}
+
+//The pseudo registers with a single definition computing a constant value can be recomputed at each use
+template<typename Pseudo>
+std::unordered_map<Pseudo, ltac::Instruction> rematerializable_registers(mtac::Function& function){
+    std::unordered_map<Pseudo, std::size_t> definitions;
+    std::unordered_map<Pseudo, ltac::Instruction> values;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(ltac::erase_result(statement.op) && statement.arg1){
+                if(auto* reg_ptr = boost::get<Pseudo>(&*statement.arg1)){
+                    if(++definitions[*reg_ptr] == 1 && !reg_ptr->bound && is_store_complete(statement, *reg_ptr) && constant_value(statement)){
+                        values.emplace(*reg_ptr, statement);
+                    }
+                }
+            }
+
+            for(auto& pair : values){
+                if(killed(statement, pair.first)){
+                    ++definitions[pair.first];
+                }
+            }
+        }
+    }
+
+    for(auto& pair : definitions){
+        if(pair.second > 1){
+            values.erase(pair.first);
+        }
+    }
+
+    return values;
+}
 
 std::size_t depth_cost(unsigned int depth){
     unsigned int cost = 1;
@@ -498,41 +566,65 @@ std::size_t depth_cost(unsigned int depth){
     return cost;
 }
 
+//With a profile, the real execution count of the block replaces the guess from the loop depth
+std::size_t block_cost(const mtac::basic_block_p& bb, bool profiled){
+    if(profiled){
+        return 1 + bb->frequency;
+    }
+
+    return depth_cost(bb->depth);
+}
+
+template<typename Pseudo>
+using Rematerializable = std::unordered_map<Pseudo, ltac::Instruction>;
+
+template<typename Pseudo>
+std::size_t use_cost(const Pseudo& reg, const Rematerializable<Pseudo>& rematerializable){
+    return rematerializable.count(reg) ? rematerialization_cost : load_cost;
+}
+
 template<typename Opt, typename Pseudo>
-void update_cost_reg(Opt& reg, ltac::interference_graph<Pseudo>& graph, unsigned int depth){
+void update_cost_reg(Opt& reg, ltac::interference_graph<Pseudo>& graph, std::size_t cost, const Rematerializable<Pseudo>& rematerializable){
     if(reg){
         if(auto* ptr = boost::get<Pseudo>(&*reg)){
-            graph.spill_cost(graph.convert(*ptr)) += load_cost * depth_cost(depth);
+            graph.spill_cost(graph.convert(*ptr)) += use_cost(*ptr, rematerializable) * cost;
         }
     }
 }
 
 template<typename Opt, typename Pseudo>
-void update_cost(Opt& arg, ltac::interference_graph<Pseudo>& graph, unsigned int depth){
+void update_cost(Opt& arg, ltac::interference_graph<Pseudo>& graph, std::size_t cost, const Rematerializable<Pseudo>& rematerializable){
     if(arg){
         if(auto* ptr = boost::get<Pseudo>(&*arg)){
-            graph.spill_cost(graph.convert(*ptr)) += load_cost * depth_cost(depth);
+            graph.spill_cost(graph.convert(*ptr)) += use_cost(*ptr, rematerializable) * cost;
         } else if(auto* ptr = boost::get<ltac::Address>(&*arg)){
-            update_cost_reg(ptr->base_register, graph, depth);
-            update_cost_reg(ptr->scaled_register, graph, depth);
+            update_cost_reg(ptr->base_register, graph, cost, rematerializable);
+            update_cost_reg(ptr->scaled_register, graph, cost, rematerializable);
         }
     }
 }
 
 template<typename Pseudo>
-void estimate_spill_costs(mtac::Function& function, ltac::interference_graph<Pseudo>& graph){
+void estimate_spill_costs(mtac::Function& function, ltac::interference_graph<Pseudo>& graph, bool profiled){
+    auto rematerializable = rematerializable_registers<Pseudo>(function);
+
     for(auto& bb : function){
+        auto cost = block_cost(bb, profiled);
+
         for(auto& statement : bb->l_statements){
             if(ltac::erase_result(statement.op)){
+                //The definition of a rematerialized register is removed
                 if(auto* reg_ptr = boost::get<Pseudo>(&*statement.arg1)){
-                    graph.spill_cost(graph.convert(*reg_ptr)) += store_cost * depth_cost(bb->depth);
+                    if(!rematerializable.count(*reg_ptr)){
+                        graph.spill_cost(graph.convert(*reg_ptr)) += store_cost * cost;
+                    }
                 }
             } else {
-                update_cost(statement.arg1, graph, bb->depth);
+                update_cost(statement.arg1, graph, cost, rematerializable);
             }
 
-            update_cost(statement.arg2, graph, bb->depth);
-            update_cost(statement.arg3, graph, bb->depth);
+            update_cost(statement.arg2, graph, cost, rematerializable);
+            update_cost(statement.arg3, graph, cost, rematerializable);
         }
     }
 }
@@ -600,7 +692,7 @@ double spill_heuristic(ltac::interference_graph<Pseudo>& graph, std::size_t reg,
 }
 
 template<typename Pseudo>
-void simplify(ltac::interference_graph<Pseudo>& graph, Platform platform, std::vector<std::size_t>& spilled, std::list<std::size_t>& order){
+void simplify(ltac::interference_graph<Pseudo>& graph, Platform platform, std::list<std::size_t>& order){
     std::set<std::size_t> n;
     for(std::size_t r = 0; r < graph.size(); ++r){
         if(graph.convert(r).bound){
@@ -638,9 +730,10 @@ void simplify(ltac::interference_graph<Pseudo>& graph, Platform platform, std::v
                 }
             }
 
-            LOG<Trace>("registers") << "Mark pseudo " << node << "(" << graph.convert(node) << ") to be spilled" << log::endl;
+            //The node may still get a color if some of its neighbors share the same
+            LOG<Trace>("registers") << "Optimistically put pseudo " << node << "(" << graph.convert(node) << ") on the stack" << log::endl;
 
-            spilled.push_back(node);
+            order.push_back(node);
         } else {
             LOG<Trace>("registers") << "Put pseudo " << graph.convert(node) << " on the stack" << log::endl;
 
@@ -668,7 +761,7 @@ void replace_registers(mtac::Function& function, std::unordered_map<std::size_t,
 }
 
 template<typename Pseudo, typename Hard>
-void select(ltac::interference_graph<Pseudo>& graph, mtac::Function& function, Platform platform, std::list<std::size_t>& order){
+void select(ltac::interference_graph<Pseudo>& graph, mtac::Function& function, Platform platform, std::list<std::size_t>& order, std::vector<std::size_t>& spilled){
     std::unordered_map<std::size_t, std::size_t> allocation;
     std::set<std::size_t> variable_allocated;
     
@@ -709,18 +802,17 @@ void select(ltac::interference_graph<Pseudo>& graph, mtac::Function& function, P
         }
 
         if(!allocation.count(reg)){
-            std::cout << "Error allocating " << graph.convert(reg) << std::endl;
+            cpp_assert(!graph.convert(reg).bound, "A bound register must always be allocated");
 
-            for(auto neighbor : graph.neighbors(reg)){
-                if(allocation.count(neighbor)){
-                    std::cout << "neighbor " << graph.convert(neighbor) << " of color " << allocation[neighbor] << std::endl;
-                } else {
-                    std::cout << "uncolored neighbor " << graph.convert(neighbor) << " of color " << std::endl;
-                }
-            }
+            LOG<Trace>("registers") << "Mark pseudo " << reg << "(" << graph.convert(reg) << ") to be spilled" << log::endl;
+
+            spilled.push_back(reg);
         }
+    }
 
-        cpp_assert(allocation.count(reg), "The register must have been allocated a color");
+    //The spilled registers are rewritten and the allocation restarts
+    if(!spilled.empty()){
+        return;
     }
 
     for(auto& alloc : allocation){
@@ -756,13 +848,53 @@ void spill_store(ltac::PseudoFloatRegister& pseudo, unsigned int position, It& i
     it.insert_after(ltac::Instruction(ltac::Operator::FMOV, ltac::Address(ltac::BP, position), pseudo));
 }
 
+//The value is recomputed before each use instead of being stored and loaded
+template<typename Pseudo>
+void rematerialize(mtac::Function& function, const Pseudo& pseudo_reg, const ltac::Instruction& definition, std::size_t& current_reg){
+    for(auto& bb : function){
+        auto it = iterate(bb->l_statements);
+
+        while(it.has_next()){
+            auto& statement = *it;
+
+            if(is_store_complete(statement, pseudo_reg)){
+                ltac::transform_to_nop(statement);
+            } else if(is_load(statement, pseudo_reg)){
+                Pseudo new_pseudo_reg(++current_reg);
+
+                replace_register(statement, pseudo_reg, new_pseudo_reg);
+
+                ltac::Instruction value(definition);
+                value.arg1 = new_pseudo_reg;
+                it.insert(std::move(value));
+
+                ++it;
+            }
+
+            ++it;
+        }
+    }
+
+    function.context->global()->stats().inc_counter("rematerialized_registers");
+}
+
 template<typename Pseudo>
 void spill_code(ltac::interference_graph<Pseudo>& graph, mtac::Function& function, std::vector<std::size_t>& spilled){
     auto current_reg = last_register<Pseudo>(function);
+    auto rematerializable = rematerializable_registers<Pseudo>(function);
     
     for(auto reg : spilled){
         auto pseudo_reg = graph.convert(reg);
 
+        auto value = rematerializable.find(pseudo_reg);
+        if(value != rematerializable.end()){
+            LOG<Trace>("registers") << "Rematerialize pseudo " << pseudo_reg << log::endl;
+
+            rematerialize(function, pseudo_reg, value->second, current_reg);
+
+            continue;
+        }
+
         //Allocate stack space for the pseudo reg
         auto position = function.context->stack_position();
         position -= INT->size(function.context->global()->target_platform());
@@ -813,7 +945,7 @@ void spill_code(ltac::interference_graph<Pseudo>& graph, mtac::Function& functio
 //Register allocation
 
 template<typename Pseudo, typename Hard>
-void register_allocation(mtac::Function& function, Platform platform){
+void register_allocation(mtac::Function& function, Platform platform, bool profiled){
     bool coalesced = false;
 
     while(true){
@@ -839,35 +971,39 @@ void register_allocation(mtac::Function& function, Platform platform){
         }
 
         //4. Spill costs
-        estimate_spill_costs(function, graph);
+        estimate_spill_costs(function, graph, profiled);
 
         //5. Simplify
-        std::vector<std::size_t> spilled;
         std::list<std::size_t> order;
-        simplify(graph, platform, spilled, order);
+        simplify(graph, platform, order);
 
-        if(!spilled.empty()){
-            //6. Spill code
-            spill_code(graph, function, spilled);
-        } else {
-            //7. Select
-            select<Pseudo, Hard>(graph, function, platform, order);
+        //6. Select
+        std::vector<std::size_t> spilled;
+        select<Pseudo, Hard>(graph, function, platform, order, spilled);
 
+        if(spilled.empty()){
             return;
         }
+
+        //7. Spill code
+        spill_code(graph, function, spilled);
     }
 }
 
 } //end of anonymous namespace
 
-void ltac::register_allocation(mtac::Program& program, Platform platform){
-    timing_timer timer(program.context->timing(), "register_allocation");
+void ltac::register_allocation(mtac::Function& function, Platform platform, bool profiled){
+    timing_timer timer(function.context->global()->timing(), "register_allocation");
 
+    LOG<Trace>("registers") << "Allocate integer registers for function " << function.get_name() << log::endl;
+    ::register_allocation<ltac::PseudoRegister, ltac::Register>(function, platform, profiled);
+
+    LOG<Trace>("registers") << "Allocate float registers for function " << function.get_name() << log::endl;
+    ::register_allocation<ltac::PseudoFloatRegister, ltac::FloatRegister>(function, platform, profiled);
+}
+
+void ltac::register_allocation(mtac::Program& program, Platform platform){
     for(auto& function : program.functions){
-        LOG<Trace>("registers") << "Allocate integer registers for function " << function.get_name() << log::endl;
-        ::register_allocation<ltac::PseudoRegister, ltac::Register>(function, platform);
-        
-        LOG<Trace>("registers") << "Allocate float registers for function " << function.get_name() << log::endl;
-        ::register_allocation<ltac::PseudoFloatRegister, ltac::FloatRegister>(function, platform);
+        ltac::register_allocation(function, platform, program.profiled);
     }
 }
@@ -0,0 +1,679 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cpp_utils/assert.hpp"
+
+#include "logging.hpp"
+#include "timing.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+
+#include "mtac/Program.hpp"
+
+#include "ltac/scheduler.hpp"
+#include "ltac/Instruction.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//A register or the flags, the memory is handled separately
+typedef unsigned int Resource;
+
+enum ResourceKind : unsigned int {
+    HARD = 0,
+    HARD_FLOAT = 1,
+    PSEUDO = 2,
+    PSEUDO_FLOAT = 3,
+    FLAGS = 4
+};
+
+Resource resource(ResourceKind kind, unsigned short reg){
+    return (static_cast<unsigned int>(kind) << 16) | reg;
+}
+
+ResourceKind kind(Resource resource){
+    return static_cast<ResourceKind>(resource >> 16);
+}
+
+//Bound pseudo registers are always allocated to their hard register
+Resource resource(const ltac::PseudoRegister& reg){
+    return reg.bound ? resource(HARD, reg.binding) : resource(PSEUDO, reg.reg);
+}
+
+Resource resource(const ltac::PseudoFloatRegister& reg){
+    return reg.bound ? resource(HARD_FLOAT, reg.binding) : resource(PSEUDO_FLOAT, reg.reg);
+}
+
+Resource resource(const ltac::Register& reg){
+    return resource(HARD, reg.reg);
+}
+
+Resource resource(const ltac::FloatRegister& reg){
+    return resource(HARD_FLOAT, reg.reg);
+}
+
+struct Node {
+    std::vector<Resource> defs;
+    std::vector<Resource> uses;
+
+    bool load = false;
+    bool store = false;
+    const ltac::Address* address = nullptr;
+    unsigned int width = 0;
+
+    unsigned int latency = 1;
+    unsigned int height = 0;
+    unsigned int earliest = 0;
+
+    std::size_t predecessors = 0;
+    std::vector<std::pair<std::size_t, unsigned int>> successors;
+};
+
+//The instructions that cannot be moved and that no instruction can cross
+bool is_barrier(const ltac::Instruction& instruction){
+    switch(instruction.op){
+        case ltac::Operator::LABEL:
+        case ltac::Operator::ENTER:
+        case ltac::Operator::LEAVE:
+        case ltac::Operator::RET:
+        case ltac::Operator::PRE_RET:
+        case ltac::Operator::PRE_PARAM:
+        case ltac::Operator::PUSH:
+        case ltac::Operator::POP:
+        case ltac::Operator::DIV:           //Implicitly writes the a and d registers
+        case ltac::Operator::REP_STOS:      //Implicitly writes the memory
+            return true;
+        default:
+            return instruction.is_jump();
+    }
+}
+
+bool is_conditional_jump(const ltac::Instruction& instruction){
+    return instruction.is_jump() && instruction.op != ltac::Operator::ALWAYS
+        && instruction.op != ltac::Operator::CALL && instruction.op != ltac::Operator::TAIL_CALL;
+}
+
+bool writes_first(ltac::Operator op){
+    return ltac::erase_result(op) || op == ltac::Operator::XORPS || op == ltac::Operator::MOVDQU;
+}
+
+bool reads_first(ltac::Operator op){
+    return !ltac::erase_result_complete(op) && op != ltac::Operator::MOVDQU;
+}
+
+bool is_register(const ltac::Argument& arg){
+    return boost::get<ltac::Register>(&arg) || boost::get<ltac::PseudoRegister>(&arg)
+        || boost::get<ltac::FloatRegister>(&arg) || boost::get<ltac::PseudoFloatRegister>(&arg);
+}
+
+bool writes_flags(const ltac::Instruction& instruction, bool allocated){
+    switch(instruction.op){
+        case ltac::Operator::ADD:
+        case ltac::Operator::SUB:
+        case ltac::Operator::MUL2:
+        case ltac::Operator::MUL3:
+        case ltac::Operator::INC:
+        case ltac::Operator::DEC:
+        case ltac::Operator::NEG:
+        case ltac::Operator::NOT:
+        case ltac::Operator::AND:
+        case ltac::Operator::OR:
+        case ltac::Operator::XOR:
+        case ltac::Operator::SHIFT_LEFT:
+        case ltac::Operator::SHIFT_RIGHT:
+        case ltac::Operator::CMP_INT:
+        case ltac::Operator::CMP_FLOAT:
+            return true;
+        case ltac::Operator::MOV:
+            //The peephole optimizer transforms MOV reg, 0 into XOR reg, reg after the allocation
+            return !allocated && is_register(*instruction.arg1) && instruction.arg2 && boost::get<int>(&*instruction.arg2) && boost::get<int>(*instruction.arg2) == 0;
+        default:
+            return false;
+    }
+}
+
+bool reads_flags(const ltac::Instruction& instruction){
+    return instruction.op >= ltac::Operator::CMOVE && instruction.op <= ltac::Operator::CMOVLE;
+}
+
+//The widest access is used when the size is not known
+unsigned int width(const ltac::Instruction& instruction){
+    if(instruction.op == ltac::Operator::MOVDQU){
+        return 16;
+    }
+
+    switch(instruction.size){
+        case tac::Size::BYTE:
+            return 1;
+        case tac::Size::WORD:
+            return 2;
+        case tac::Size::DOUBLE_WORD:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+void add_register(std::vector<Resource>& resources, const ltac::Argument& arg){
+    if(auto* ptr = boost::get<ltac::Register>(&arg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::PseudoRegister>(&arg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::FloatRegister>(&arg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::PseudoFloatRegister>(&arg)){
+        resources.push_back(resource(*ptr));
+    }
+}
+
+void add_register(std::vector<Resource>& resources, const ltac::AddressRegister& reg){
+    if(auto* ptr = boost::get<ltac::Register>(&reg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::PseudoRegister>(&reg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::FloatRegister>(&reg)){
+        resources.push_back(resource(*ptr));
+    } else if(auto* ptr = boost::get<ltac::PseudoFloatRegister>(&reg)){
+        resources.push_back(resource(*ptr));
+    }
+}
+
+void add_argument(Node& node, const ltac::Instruction& instruction, const boost::optional<ltac::Argument>& arg, bool read, bool write){
+    if(!arg){
+        return;
+    }
+
+    if(auto* ptr = boost::get<ltac::Address>(&*arg)){
+        if(ptr->base_register){
+            add_register(node.uses, *ptr->base_register);
+        }
+
+        if(ptr->scaled_register){
+            add_register(node.uses, *ptr->scaled_register);
+        }
+
+        //LEA only computes the address
+        if(instruction.op != ltac::Operator::LEA){
+            node.address = ptr;
+            node.width = width(instruction);
+            node.load |= read;
+            node.store |= write;
+        }
+    } else {
+        if(read){
+            add_register(node.uses, *arg);
+        }
+
+        if(write){
+            add_register(node.defs, *arg);
+        }
+    }
+}
+
+unsigned int latency(Platform platform, const ltac::Instruction& instruction, const Node& node){
+    if(instruction.op == ltac::Operator::NOP){
+        return 0;
+    }
+
+    unsigned int load = platform == Platform::INTEL_X86_64 ? 4 : 3;
+
+    if(node.load && (instruction.op == ltac::Operator::MOV || instruction.op == ltac::Operator::FMOV || instruction.op == ltac::Operator::MOVDQU)){
+        return load;
+    }
+
+    unsigned int operation = 1;
+
+    switch(instruction.op){
+        case ltac::Operator::MUL2:
+        case ltac::Operator::MUL3:
+        case ltac::Operator::FADD:
+        case ltac::Operator::FSUB:
+            operation = 3;
+            break;
+        case ltac::Operator::FMUL:
+            operation = platform == Platform::INTEL_X86_64 ? 4 : 5;
+            break;
+        case ltac::Operator::FDIV:
+            operation = platform == Platform::INTEL_X86_64 ? 14 : 20;
+            break;
+        case ltac::Operator::I2F:
+        case ltac::Operator::F2I:
+            operation = 4;
+            break;
+        default:
+            break;
+    }
+
+    return node.load ? load + operation : operation;
+}
+
+Node make_node(Platform platform, const ltac::Instruction& instruction, bool allocated){
+    Node node;
+
+    add_argument(node, instruction, instruction.arg1, reads_first(instruction.op), writes_first(instruction.op));
+    add_argument(node, instruction, instruction.arg2, true, false);
+    add_argument(node, instruction, instruction.arg3, true, false);
+
+    for(auto& reg : instruction.uses){
+        node.uses.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.float_uses){
+        node.uses.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.hard_uses){
+        node.uses.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.hard_float_uses){
+        node.uses.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.kills){
+        node.defs.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.float_kills){
+        node.defs.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.hard_kills){
+        node.defs.push_back(resource(reg));
+    }
+
+    for(auto& reg : instruction.hard_float_kills){
+        node.defs.push_back(resource(reg));
+    }
+
+    if(writes_flags(instruction, allocated)){
+        node.defs.push_back(resource(FLAGS, 0));
+    }
+
+    if(reads_flags(instruction)){
+        node.uses.push_back(resource(FLAGS, 0));
+    }
+
+    node.latency = latency(platform, instruction, node);
+
+    return node;
+}
+
+bool has_registers(const ltac::Address& address){
+    return address.base_register || address.scaled_register;
+}
+
+bool stack_base(const ltac::Address& address, ltac::Register& base){
+    if(address.absolute || address.scaled_register || !address.base_register){
+        return false;
+    }
+
+    if(auto* ptr = boost::get<ltac::Register>(&*address.base_register)){
+        if(*ptr == ltac::BP || *ptr == ltac::SP){
+            base = *ptr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool overlap(int lhs, unsigned int lhs_width, int rhs, unsigned int rhs_width){
+    return lhs < rhs + static_cast<int>(rhs_width) && rhs < lhs + static_cast<int>(lhs_width);
+}
+
+//Only the accesses to distinct globals or to distinct stack slots are known to be independent
+bool may_alias(const Node& lhs, const Node& rhs){
+    auto& a = *lhs.address;
+    auto& b = *rhs.address;
+
+    int a_displacement = a.displacement ? *a.displacement : 0;
+    int b_displacement = b.displacement ? *b.displacement : 0;
+
+    if(a.absolute && b.absolute){
+        if(*a.absolute != *b.absolute){
+            return false;
+        }
+
+        if(!has_registers(a) && !has_registers(b)){
+            return overlap(a_displacement, lhs.width, b_displacement, rhs.width);
+        }
+
+        return true;
+    }
+
+    ltac::Register a_base;
+    ltac::Register b_base;
+
+    bool a_stack = stack_base(a, a_base);
+    bool b_stack = stack_base(b, b_base);
+
+    //A global is never on the stack
+    if((a.absolute && b_stack) || (b.absolute && a_stack)){
+        return false;
+    }
+
+    if(a_stack && b_stack && a_base == b_base){
+        return overlap(a_displacement, lhs.width, b_displacement, rhs.width);
+    }
+
+    return true;
+}
+
+void add_edge(std::vector<Node>& nodes, std::size_t from, std::size_t to, unsigned int latency){
+    nodes[from].successors.emplace_back(to, latency);
+    ++nodes[to].predecessors;
+}
+
+void build_dependencies(std::vector<Node>& nodes){
+    std::unordered_map<Resource, std::size_t> last_writer;
+    std::unordered_map<Resource, std::vector<std::size_t>> readers;
+    std::vector<std::size_t> memory;
+
+    for(std::size_t i = 0; i < nodes.size(); ++i){
+        auto& node = nodes[i];
+
+        //True dependencies
+        for(auto resource : node.uses){
+            auto it = last_writer.find(resource);
+            if(it != last_writer.end()){
+                add_edge(nodes, it->second, i, nodes[it->second].latency);
+            }
+
+            readers[resource].push_back(i);
+        }
+
+        //Anti and output dependencies
+        for(auto resource : node.defs){
+            for(auto reader : readers[resource]){
+                if(reader != i){
+                    add_edge(nodes, reader, i, 0);
+                }
+            }
+
+            auto it = last_writer.find(resource);
+            if(it != last_writer.end() && it->second != i){
+                add_edge(nodes, it->second, i, 1);
+            }
+
+            last_writer[resource] = i;
+            readers[resource].clear();
+        }
+
+        if(node.address){
+            for(auto previous : memory){
+                auto& other = nodes[previous];
+
+                if((node.store || other.store) && may_alias(other, node)){
+                    add_edge(nodes, previous, i, other.store && node.load ? other.latency : 0);
+                }
+            }
+
+            memory.push_back(i);
+        }
+    }
+
+    //The edges always go forward, the heights can be computed in reverse order
+    for(std::size_t i = nodes.size(); i > 0; --i){
+        auto& node = nodes[i - 1];
+
+        node.height = node.latency;
+
+        for(auto& successor : node.successors){
+            node.height = std::max(node.height, successor.second + nodes[successor.first].height);
+        }
+    }
+}
+
+/*!
+ * \brief Approximation of the register pressure of the pseudo registers defined in the region.
+ */
+struct Pressure {
+    std::unordered_map<Resource, std::size_t> remaining;
+    std::unordered_set<Resource> live;
+
+    unsigned int live_int = 0;
+    unsigned int live_float = 0;
+
+    bool pseudo(Resource resource){
+        return kind(resource) == PSEUDO || kind(resource) == PSEUDO_FLOAT;
+    }
+
+    bool reads(const Node& node, Resource resource){
+        return std::find(node.uses.begin(), node.uses.end(), resource) != node.uses.end();
+    }
+
+    bool writes(const Node& node, Resource resource){
+        return std::find(node.defs.begin(), node.defs.end(), resource) != node.defs.end();
+    }
+
+    void init(const std::vector<Node>& nodes){
+        for(auto& node : nodes){
+            std::unordered_set<Resource> uses(node.uses.begin(), node.uses.end());
+
+            for(auto resource : uses){
+                if(pseudo(resource)){
+                    ++remaining[resource];
+                }
+            }
+        }
+    }
+
+    //Number of values made live minus the number of values killed by the node
+    int delta(const Node& node){
+        int delta = 0;
+
+        for(auto resource : node.defs){
+            if(pseudo(resource) && !live.count(resource) && remaining[resource] > (reads(node, resource) ? 1 : 0)){
+                ++delta;
+            }
+        }
+
+        std::unordered_set<Resource> uses(node.uses.begin(), node.uses.end());
+
+        for(auto resource : uses){
+            if(live.count(resource) && remaining[resource] == 1 && !writes(node, resource)){
+                --delta;
+            }
+        }
+
+        return delta;
+    }
+
+    void update(Resource resource, int delta){
+        if(kind(resource) == PSEUDO){
+            live_int += delta;
+        } else {
+            live_float += delta;
+        }
+    }
+
+    void schedule(const Node& node){
+        std::unordered_set<Resource> uses(node.uses.begin(), node.uses.end());
+
+        for(auto resource : uses){
+            if(pseudo(resource) && --remaining[resource] == 0 && live.count(resource)){
+                live.erase(resource);
+                update(resource, -1);
+            }
+        }
+
+        for(auto resource : node.defs){
+            if(pseudo(resource) && remaining[resource] > 0 && !live.count(resource)){
+                live.insert(resource);
+                update(resource, 1);
+            }
+        }
+    }
+};
+
+std::size_t schedule_region(std::vector<ltac::Instruction>& statements, std::size_t first, std::size_t last, Platform platform, bool allocated){
+    if(last - first < 2){
+        return 0;
+    }
+
+    std::vector<Node> nodes;
+    nodes.reserve(last - first);
+
+    for(std::size_t i = first; i < last; ++i){
+        nodes.push_back(make_node(platform, statements[i], allocated));
+    }
+
+    build_dependencies(nodes);
+
+    Pressure pressure;
+    if(!allocated){
+        pressure.init(nodes);
+    }
+
+    auto descriptor = getPlatformDescriptor(platform);
+
+    std::vector<std::size_t> ready;
+    for(std::size_t i = 0; i < nodes.size(); ++i){
+        if(!nodes[i].predecessors){
+            ready.push_back(i);
+        }
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(nodes.size());
+
+    unsigned int cycle = 0;
+
+    while(!ready.empty()){
+        bool high_pressure = !allocated &&
+            (pressure.live_int + 2 >= descriptor->number_of_registers() || pressure.live_float + 1 >= descriptor->number_of_float_registers());
+
+        std::size_t best = 0;
+
+        for(std::size_t r = 1; r < ready.size(); ++r){
+            auto& candidate = nodes[ready[r]];
+            auto& current = nodes[ready[best]];
+
+            bool candidate_available = candidate.earliest <= cycle;
+            bool current_available = current.earliest <= cycle;
+
+            bool better;
+            if(candidate_available != current_available){
+                better = candidate_available;
+            } else if(!candidate_available && candidate.earliest != current.earliest){
+                better = candidate.earliest < current.earliest;
+            } else if(high_pressure && pressure.delta(candidate) != pressure.delta(current)){
+                better = pressure.delta(candidate) < pressure.delta(current);
+            } else if(candidate.height != current.height){
+                better = candidate.height > current.height;
+            } else {
+                //Keep the original order on ties
+                better = ready[r] < ready[best];
+            }
+
+            if(better){
+                best = r;
+            }
+        }
+
+        auto index = ready[best];
+        ready.erase(ready.begin() + best);
+
+        auto& node = nodes[index];
+
+        cycle = std::max(cycle, node.earliest);
+        order.push_back(index);
+
+        if(!allocated){
+            pressure.schedule(node);
+        }
+
+        for(auto& successor : node.successors){
+            auto& next = nodes[successor.first];
+
+            next.earliest = std::max(next.earliest, cycle + successor.second);
+
+            if(--next.predecessors == 0){
+                ready.push_back(successor.first);
+            }
+        }
+
+        ++cycle;
+    }
+
+    cpp_assert(order.size() == nodes.size(), "The dependency graph must be acyclic");
+
+    std::size_t moved = 0;
+
+    std::vector<ltac::Instruction> scheduled;
+    scheduled.reserve(order.size());
+
+    for(std::size_t i = 0; i < order.size(); ++i){
+        if(order[i] != i){
+            ++moved;
+        }
+
+        scheduled.push_back(std::move(statements[first + order[i]]));
+    }
+
+    std::move(scheduled.begin(), scheduled.end(), statements.begin() + first);
+
+    return moved;
+}
+
+std::size_t schedule_block(std::vector<ltac::Instruction>& statements, Platform platform, bool allocated){
+    std::size_t moved = 0;
+    std::size_t first = 0;
+
+    for(std::size_t i = 0; i <= statements.size(); ++i){
+        if(i < statements.size() && !is_barrier(statements[i])){
+            continue;
+        }
+
+        auto last = i;
+
+        //The comparison feeding a conditional jump and what follows it stay in place
+        if(i < statements.size() && is_conditional_jump(statements[i])){
+            for(auto j = i; j > first; --j){
+                if(writes_flags(statements[j - 1], allocated)){
+                    last = j - 1;
+                    break;
+                }
+            }
+        }
+
+        moved += schedule_region(statements, first, last, platform, allocated);
+
+        first = i + 1;
+    }
+
+    return moved;
+}
+
+} //end of anonymous namespace
+
+void ltac::schedule(mtac::Function& function, Platform platform, bool allocated){
+    timing_timer timer(function.context->global()->timing(), allocated ? "post_alloc_scheduling" : "pre_alloc_scheduling");
+
+    std::size_t moved = 0;
+
+    for(auto& bb : function){
+        moved += schedule_block(bb->l_statements, platform, allocated);
+    }
+
+    if(moved){
+        LOG<Trace>("Scheduler") << "Moved " << moved << " instructions in " << function.get_name() << log::endl;
+        function.context->global()->stats().inc_counter("functions_scheduled");
+    }
+}
+
+void ltac::schedule(mtac::Program& program, Platform platform, bool allocated){
+    for(auto& function : program.functions){
+        ltac::schedule(function, platform, allocated);
+    }
+}
@@ -9,6 +9,7 @@
 
 #include "Type.hpp"
 #include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
 
 #include "mtac/Program.hpp"
 
@@ -55,49 +56,53 @@ void change_address(Arg& arg, int bp_offset){
 
 }
 
-void ltac::fix_stack_offsets(mtac::Program& program, Platform platform){
-    timing_timer timer(program.context->timing(), "stack_offsets");
-
-    for(auto& function : program.functions){
-        std::unordered_map<std::string, int> offset_labels;
-        int bp_offset = 0;
-        
-        for(auto& bb : function){
-            for(auto& instruction : bb->l_statements){
-                if(instruction.is_label()){
-                    if(offset_labels.count(instruction.label)){
-                        bp_offset = offset_labels[instruction.label];
-                        offset_labels.erase(instruction.label);
-                    }
+void ltac::fix_stack_offsets(mtac::Function& function, Platform platform){
+    timing_timer timer(function.context->global()->timing(), "stack_offsets");
+
+    std::unordered_map<std::string, int> offset_labels;
+    int bp_offset = 0;
+    
+    for(auto& bb : function){
+        for(auto& instruction : bb->l_statements){
+            if(instruction.is_label()){
+                if(offset_labels.count(instruction.label)){
+                    bp_offset = offset_labels[instruction.label];
+                    offset_labels.erase(instruction.label);
                 }
-                else if(instruction.is_jump()){
-                    if(instruction.op != ltac::Operator::CALL && instruction.op != ltac::Operator::ALWAYS){
-                        offset_labels[instruction.label] = bp_offset;
-                    }
-                } else {
-                    change_address(instruction.arg1, bp_offset);
-                    change_address(instruction.arg2, bp_offset);
-                    change_address(instruction.arg3, bp_offset);
-
-                    if(opt_variant_equals(instruction.arg1, ltac::SP)){
-                        if(instruction.op == ltac::Operator::ADD){
-                            bp_offset -= boost::get<int>(*instruction.arg2);
-                        }
-
-                        if(instruction.op == ltac::Operator::SUB){
-                            bp_offset += boost::get<int>(*instruction.arg2);
-                        }
+            }
+            else if(instruction.is_jump()){
+                if(instruction.op != ltac::Operator::CALL && instruction.op != ltac::Operator::TAIL_CALL && instruction.op != ltac::Operator::ALWAYS){
+                    offset_labels[instruction.label] = bp_offset;
+                }
+            } else {
+                change_address(instruction.arg1, bp_offset);
+                change_address(instruction.arg2, bp_offset);
+                change_address(instruction.arg3, bp_offset);
+
+                if(opt_variant_equals(instruction.arg1, ltac::SP)){
+                    if(instruction.op == ltac::Operator::ADD){
+                        bp_offset -= boost::get<int>(*instruction.arg2);
                     }
 
-                    if(instruction.op == ltac::Operator::PUSH){
-                        bp_offset += INT->size(platform);
+                    if(instruction.op == ltac::Operator::SUB){
+                        bp_offset += boost::get<int>(*instruction.arg2);
                     }
+                }
 
-                    if(instruction.op == ltac::Operator::POP){
-                        bp_offset -= INT->size(platform);
-                    }
+                if(instruction.op == ltac::Operator::PUSH){
+                    bp_offset += INT->size(platform);
                 }
-            } 
-        }
+
+                if(instruction.op == ltac::Operator::POP){
+                    bp_offset -= INT->size(platform);
+                }
+            }
+        } 
+    }
+}
+
+void ltac::fix_stack_offsets(mtac::Program& program, Platform platform){
+    for(auto& function : program.functions){
+        ltac::fix_stack_offsets(function, platform);
     }
 }
@@ -0,0 +1,564 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "logging.hpp"
+#include "timing.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+
+#include "mtac/Program.hpp"
+
+#include "ltac/stack_slots.hpp"
+#include "ltac/Instruction.hpp"
+#include "ltac/Address.hpp"
+#include "ltac/Operator.hpp"
+#include "ltac/bit_matrix.hpp"
+
+using namespace eddic;
+
+namespace {
+
+typedef boost::dynamic_bitset<> Slots;
+
+struct Slot {
+    int position;
+    int size;
+    int rounded_size;
+    std::vector<std::shared_ptr<Variable>> variables;     //Empty for a spilled register
+
+    bool fixed = false;         //The address of the slot is taken
+    int new_position = 0;
+
+    Slot(int position, int size, int rounded_size) : position(position), size(size), rounded_size(rounded_size) {}
+};
+
+struct Access {
+    std::size_t slot;
+    bool read;
+    bool write;
+    bool complete;              //All the bytes of the slot are written
+};
+
+struct Frame {
+    std::vector<Slot> slots;
+    std::map<int, std::size_t> positions;
+    std::unordered_map<const ltac::Instruction*, std::vector<Access>> accesses;
+};
+
+int round_up(int size, int alignment){
+    return ((size + alignment - 1) / alignment) * alignment;
+}
+
+bool is_bp(const ltac::AddressRegister& reg){
+    if(auto* ptr = boost::get<ltac::Register>(&reg)){
+        return *ptr == ltac::BP;
+    }
+
+    return false;
+}
+
+//Only the negative offsets are in the frame, the others are the parameters
+ltac::Address* frame_address(boost::optional<ltac::Argument>& arg){
+    if(arg){
+        if(auto* ptr = boost::get<ltac::Address>(&*arg)){
+            if(!ptr->absolute && ptr->base_register && is_bp(*ptr->base_register) && ptr->displacement && *ptr->displacement < 0){
+                return ptr;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+bool uses_bp(const boost::optional<ltac::Argument>& arg){
+    if(arg){
+        if(auto* ptr = boost::get<ltac::Register>(&*arg)){
+            return *ptr == ltac::BP;
+        }
+    }
+
+    return false;
+}
+
+unsigned int width(const ltac::Instruction& instruction, Platform platform){
+    if(instruction.op == ltac::Operator::MOVDQU){
+        return 16;
+    }
+
+    switch(instruction.size){
+        case tac::Size::BYTE:
+            return 1;
+        case tac::Size::WORD:
+            return 2;
+        case tac::Size::DOUBLE_WORD:
+            return 4;
+        case tac::Size::QUAD_WORD:
+            return 8;
+        default:
+            return instruction.op == ltac::Operator::FMOV ? FLOAT->size(platform) : INT->size(platform);
+    }
+}
+
+bool writes_first(ltac::Operator op){
+    return ltac::erase_result(op) || op == ltac::Operator::XORPS || op == ltac::Operator::MOVDQU;
+}
+
+bool reads_first(ltac::Operator op){
+    return !ltac::erase_result_complete(op) && op != ltac::Operator::MOVDQU;
+}
+
+bool is_aggregate(const std::shared_ptr<Variable>& var){
+    auto type = var->type();
+
+    return (type->is_array() && type->has_elements()) || type->is_custom_type();
+}
+
+//The offsets where a clearing sequence starts, its extent is not visible in the instruction
+std::vector<int> clear_starts(mtac::Function& function){
+    std::vector<int> starts;
+
+    for(auto& bb : function){
+        for(auto& instruction : bb->l_statements){
+            //rep stos clears from an address loaded by LEA, the loops clear 16 bytes at a time through an index
+            if(instruction.op == ltac::Operator::LEA || instruction.op == ltac::Operator::MOVDQU){
+                for(auto* arg : {&instruction.arg1, &instruction.arg2}){
+                    if(auto* address = frame_address(*arg)){
+                        if(instruction.op == ltac::Operator::LEA || address->scaled_register){
+                            starts.push_back(*address->displacement);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return starts;
+}
+
+//Return the slot containing the given offset, or slots.size() if there is none
+std::size_t find_slot(Frame& frame, int offset){
+    auto it = frame.positions.upper_bound(offset);
+
+    if(it != frame.positions.begin()){
+        --it;
+
+        auto& slot = frame.slots[it->second];
+        if(offset < slot.position + slot.size){
+            return it->second;
+        }
+    }
+
+    return frame.slots.size();
+}
+
+bool collect_slots(mtac::Function& function, Frame& frame, Platform platform){
+    auto int_size = INT->size(platform);
+
+    std::map<int, std::shared_ptr<Variable>> variables;
+
+    for(auto& variable : function.context->stored_variables()){
+        if(!variable->is_reference() && variable->position().isStack()){
+            variables[variable->position().offset()] = variable;
+        }
+    }
+
+    auto starts = clear_starts(function);
+
+    //The adjacent aggregates are cleared by a single range, a clear starting in one of them may write all the next ones.
+    //Such a run of aggregates is kept in a single slot so that its layout does not change
+    bool run = false;
+
+    for(auto& pair : variables){
+        auto offset = pair.first;
+        auto& variable = pair.second;
+        auto size = static_cast<int>(variable->type()->size(platform));
+
+        if(run && is_aggregate(variable)){
+            auto& slot = frame.slots.back();
+
+            if(offset <= slot.position + slot.rounded_size){
+                slot.size = offset + size - slot.position;
+                slot.rounded_size = round_up(slot.size, int_size);
+                slot.variables.push_back(variable);
+                continue;
+            }
+        }
+
+        run = is_aggregate(variable) && std::any_of(starts.begin(), starts.end(),
+                [offset, size](int start){ return start >= offset && start < offset + size; });
+
+        frame.positions[offset] = frame.slots.size();
+        frame.slots.emplace_back(offset, size, round_up(size, int_size));
+        frame.slots.back().variables.push_back(variable);
+    }
+
+    //The other offsets are the spilled registers
+    for(auto& bb : function){
+        for(auto& instruction : bb->l_statements){
+            if(uses_bp(instruction.arg1) || uses_bp(instruction.arg2) || uses_bp(instruction.arg3)){
+                return false;
+            }
+
+            for(auto* arg : {&instruction.arg1, &instruction.arg2, &instruction.arg3}){
+                if(auto* address = frame_address(*arg)){
+                    auto offset = *address->displacement;
+
+                    if(find_slot(frame, offset) == frame.slots.size()){
+                        auto next = frame.positions.upper_bound(offset);
+
+                        if(next != frame.positions.end() && next->first < offset + static_cast<int>(int_size)){
+                            return false;
+                        }
+
+                        frame.positions[offset] = frame.slots.size();
+                        frame.slots.emplace_back(offset, int_size, int_size);
+                    }
+                }
+            }
+        }
+    }
+
+    return !frame.slots.empty();
+}
+
+bool collect_accesses(mtac::Function& function, Frame& frame, Platform platform){
+    for(auto& bb : function){
+        for(auto& instruction : bb->l_statements){
+            auto& accesses = frame.accesses[&instruction];
+
+            for(auto* arg : {&instruction.arg1, &instruction.arg2, &instruction.arg3}){
+                if(auto* address = frame_address(*arg)){
+                    auto offset = *address->displacement;
+                    auto index = find_slot(frame, offset);
+                    auto& slot = frame.slots[index];
+
+                    //The address of the slot may be used anywhere
+                    if(instruction.op == ltac::Operator::LEA){
+                        slot.fixed = true;
+                        continue;
+                    }
+
+                    auto bytes = static_cast<int>(width(instruction, platform));
+
+                    //An index may access any byte of the slot, but a constant access must not cross slots
+                    if(!address->scaled_register && offset + bytes > slot.position + slot.size){
+                        return false;
+                    }
+
+                    Access access;
+                    access.slot = index;
+
+                    if(arg == &instruction.arg1){
+                        access.read = reads_first(instruction.op);
+                        access.write = writes_first(instruction.op);
+                    } else {
+                        access.read = true;
+                        access.write = false;
+                    }
+
+                    access.complete = access.write && !access.read && !address->scaled_register
+                        && offset == slot.position && bytes >= slot.size;
+
+                    accesses.push_back(access);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+typedef std::unordered_map<mtac::basic_block_p, Slots> BlockSlots;
+
+//A slot is reached at a point if it has been accessed on a path to this point
+BlockSlots reached_slots(mtac::Function& function, Frame& frame){
+    BlockSlots gen;
+    BlockSlots in;
+    BlockSlots out;
+
+    for(auto& bb : function){
+        gen[bb] = Slots(frame.slots.size());
+        in[bb] = Slots(frame.slots.size());
+        out[bb] = Slots(frame.slots.size());
+
+        for(auto& instruction : bb->l_statements){
+            for(auto& access : frame.accesses[&instruction]){
+                gen[bb].set(access.slot);
+            }
+        }
+    }
+
+    bool changes = true;
+    while(changes){
+        changes = false;
+
+        for(auto& bb : function){
+            for(auto& pred : bb->predecessors){
+                in[bb] |= out[pred];
+            }
+
+            auto new_out = in[bb] | gen[bb];
+
+            if(new_out != out[bb]){
+                out[bb] = new_out;
+                changes = true;
+            }
+        }
+    }
+
+    return in;
+}
+
+//A slot is live at a point if it may be read before being completely written
+BlockSlots live_slots(mtac::Function& function, Frame& frame){
+    BlockSlots use;
+    BlockSlots def;
+    BlockSlots in;
+    BlockSlots out;
+
+    for(auto& bb : function){
+        use[bb] = Slots(frame.slots.size());
+        def[bb] = Slots(frame.slots.size());
+        in[bb] = Slots(frame.slots.size());
+        out[bb] = Slots(frame.slots.size());
+
+        for(auto& instruction : bb->l_statements){
+            for(auto& access : frame.accesses[&instruction]){
+                if(access.read && !def[bb][access.slot]){
+                    use[bb].set(access.slot);
+                }
+            }
+
+            for(auto& access : frame.accesses[&instruction]){
+                if(access.complete){
+                    def[bb].set(access.slot);
+                }
+            }
+        }
+    }
+
+    bool changes = true;
+    while(changes){
+        changes = false;
+
+        for(auto& bb : function){
+            for(auto& succ : bb->successors){
+                out[bb] |= in[succ];
+            }
+
+            auto new_in = use[bb] | (out[bb] - def[bb]);
+
+            if(new_in != in[bb]){
+                in[bb] = new_in;
+                changes = true;
+            }
+        }
+    }
+
+    return out;
+}
+
+//Two slots interfere if one is written while the other holds a value
+void build_interferences(mtac::Function& function, Frame& frame, ltac::bit_matrix& interferences){
+    auto n = frame.slots.size();
+
+    auto reached_in = reached_slots(function, frame);
+    auto live_out = live_slots(function, frame);
+
+    for(auto& bb : function){
+        auto& statements = bb->l_statements;
+
+        std::vector<Slots> reached_after;
+        auto reached = reached_in[bb];
+
+        for(auto& instruction : statements){
+            for(auto& access : frame.accesses[&instruction]){
+                reached.set(access.slot);
+            }
+
+            reached_after.push_back(reached);
+        }
+
+        auto live = live_out[bb];
+
+        for(std::size_t i = statements.size(); i > 0; --i){
+            auto& accesses = frame.accesses[&statements[i - 1]];
+            auto values = live & reached_after[i - 1];
+
+            for(auto& access : accesses){
+                if(access.write){
+                    for(auto s = values.find_first(); s != Slots::npos; s = values.find_next(s)){
+                        if(s != access.slot){
+                            interferences.set(access.slot, s);
+                            interferences.set(s, access.slot);
+                        }
+                    }
+                }
+            }
+
+            for(auto& access : accesses){
+                if(access.complete){
+                    live.reset(access.slot);
+                }
+            }
+
+            for(auto& access : accesses){
+                if(access.read){
+                    live.set(access.slot);
+                }
+            }
+        }
+    }
+
+    for(std::size_t i = 0; i < n; ++i){
+        if(frame.slots[i].fixed){
+            for(std::size_t j = 0; j < n; ++j){
+                if(i != j){
+                    interferences.set(i, j);
+                    interferences.set(j, i);
+                }
+            }
+        }
+    }
+}
+
+//First fit of the slots by decreasing size, return the new size of the frame
+int place_slots(Frame& frame, ltac::bit_matrix& interferences){
+    auto n = frame.slots.size();
+
+    std::vector<std::size_t> order;
+    for(std::size_t i = 0; i < n; ++i){
+        order.push_back(i);
+    }
+
+    std::sort(order.begin(), order.end(), [&frame](std::size_t lhs, std::size_t rhs){
+        auto& a = frame.slots[lhs];
+        auto& b = frame.slots[rhs];
+        return a.rounded_size > b.rounded_size || (a.rounded_size == b.rounded_size && a.position > b.position);
+    });
+
+    //The depth of each placed slot from the start of the frame
+    std::vector<int> depths(n, -1);
+    int total = 0;
+
+    for(auto i : order){
+        auto& slot = frame.slots[i];
+
+        std::vector<std::pair<int, int>> intervals;
+        for(std::size_t j = 0; j < n; ++j){
+            if(depths[j] >= 0 && interferences.is_set(i, j)){
+                intervals.emplace_back(depths[j], depths[j] + frame.slots[j].rounded_size);
+            }
+        }
+
+        std::sort(intervals.begin(), intervals.end());
+
+        int depth = 0;
+        for(auto& interval : intervals){
+            if(interval.first < depth + slot.rounded_size && depth < interval.second){
+                depth = interval.second;
+            }
+        }
+
+        depths[i] = depth;
+        slot.new_position = -(depth + slot.rounded_size);
+        total = std::max(total, depth + slot.rounded_size);
+    }
+
+    return total;
+}
+
+void rewrite_slots(mtac::Function& function, Frame& frame){
+    for(auto& bb : function){
+        for(auto& instruction : bb->l_statements){
+            for(auto* arg : {&instruction.arg1, &instruction.arg2, &instruction.arg3}){
+                if(auto* address = frame_address(*arg)){
+                    auto& slot = frame.slots[find_slot(frame, *address->displacement)];
+                    *address->displacement += slot.new_position - slot.position;
+                }
+            }
+        }
+    }
+
+    for(auto& slot : frame.slots){
+        for(auto& variable : slot.variables){
+            auto offset = variable->position().offset() + slot.new_position - slot.position;
+            variable->setPosition(Position(PositionType::STACK, offset));
+        }
+    }
+}
+
+std::size_t shared_slots(Frame& frame){
+    std::size_t shared = 0;
+
+    for(std::size_t i = 0; i < frame.slots.size(); ++i){
+        auto& a = frame.slots[i];
+
+        for(std::size_t j = 0; j < frame.slots.size(); ++j){
+            auto& b = frame.slots[j];
+
+            if(i != j && a.new_position < b.new_position + b.rounded_size && b.new_position < a.new_position + a.rounded_size){
+                ++shared;
+                break;
+            }
+        }
+    }
+
+    return shared;
+}
+
+} //end of anonymous namespace
+
+void ltac::color_stack_slots(mtac::Function& function, Platform platform){
+    if(!function.context){
+        return;
+    }
+
+    timing_timer timer(function.context->global()->timing(), "stack_slot_coloring");
+
+    auto int_size = INT->size(platform);
+
+    Frame frame;
+
+    if(!collect_slots(function, frame, platform) || !collect_accesses(function, frame, platform)){
+        return;
+    }
+
+    ltac::bit_matrix interferences(frame.slots.size());
+    build_interferences(function, frame, interferences);
+
+    auto total = place_slots(frame, interferences);
+    auto old_total = -function.context->stack_position() - static_cast<int>(int_size);
+
+    if(total >= old_total){
+        return;
+    }
+
+    rewrite_slots(function, frame);
+    function.context->set_stack_position(-total - int_size);
+
+    auto shared = shared_slots(frame);
+    for(std::size_t i = 0; i < shared; ++i){
+        function.context->global()->stats().inc_counter("stack_slots_shared");
+    }
+
+    LOG<Trace>("Stack") << "Shrink the frame of " << function.get_name() << " from " << old_total << " to " << total << " bytes" << log::endl;
+}
+
+void ltac::color_stack_slots(mtac::Program& program, Platform platform){
+    for(auto& function : program.functions){
+        ltac::color_stack_slots(function, platform);
+    }
+}
@@ -5,16 +5,29 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "logging.hpp"
 #include "GlobalContext.hpp"
 #include "FunctionContext.hpp"
+#include "Platform.hpp"
 #include "Type.hpp"
 #include "Variable.hpp"
+#include "Labels.hpp"
 
 #include "ltac/stack_space.hpp"
 #include "ltac/Utils.hpp"
 #include "ltac/Address.hpp"
 #include "ltac/Instruction.hpp"
 
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/DefiniteInitializationProblem.hpp"
+#include "mtac/GlobalOptimizations.hpp"
+#include "mtac/dominators.hpp"
+#include "mtac/Utils.hpp"
+
 using namespace eddic;
 
 namespace {
@@ -45,94 +58,445 @@ void optimize_ranges(std::vector<std::pair<int, int>>& memset_ranges){
     }
 }
 
-} //end of anonymous namespace
+//rep stos needs the a, c and di registers, they must not hold parameters of the function
+bool rep_stos_safe(mtac::Function& function, const PlatformDescriptor* descriptor){
+    for(auto& var_pair : *function.context){
+        auto& var = var_pair.second;
 
-void ltac::alloc_stack_space(mtac::Program& program){
-    timing_timer timer(program.context->timing(), "stack_space");
+        if(var->position().isParamRegister() && mtac::is_single_int_register(var->type())){
+            auto reg = descriptor->int_param_register(var->position().offset());
 
-    auto platform = program.context->target_platform();
+            if(reg == descriptor->a_register() || reg == descriptor->c_register() || reg == descriptor->di_register()){
+                return false;
+            }
+        }
+    }
 
-    for(auto& function : program.functions){
-        auto bb = function.entry_bb();
-        auto int_size = INT->size(platform);
+    return true;
+}
 
-        //Clear the stack variables
+ltac::PseudoRegister bound_register(mtac::Function& function, unsigned short hard){
+    ltac::PseudoRegister reg(function.pseudo_registers(), hard);
+    function.set_pseudo_registers(function.pseudo_registers() + 1);
+    return reg;
+}
 
-        std::vector<std::pair<int, int>> memset_ranges;
+ltac::PseudoRegister new_register(mtac::Function& function){
+    ltac::PseudoRegister reg(function.pseudo_registers());
+    function.set_pseudo_registers(function.pseudo_registers() + 1);
+    return reg;
+}
 
-        for(auto& var_pair : *function.context){
-            auto& var = var_pair.second;
+ltac::PseudoFloatRegister new_float_register(mtac::Function& function){
+    ltac::PseudoFloatRegister reg(function.pseudo_float_registers());
+    function.set_pseudo_float_registers(function.pseudo_float_registers() + 1);
+    return reg;
+}
 
-            if(var->position().isStack()){
-                auto type = var->type();
-                int position = var->position().offset();
+bool is_aggregate(const std::shared_ptr<Variable>& var){
+    auto type = var->type();
 
-                if(type->is_array() && type->has_elements()){
-                    memset_ranges.emplace_back(position + int_size, type->data_type()->size(platform) * type->elements());
-                } else if(type->is_custom_type()){
-                    memset_ranges.emplace_back(position, type->size(platform));
-                }
+    return var->position().isStack() && ((type->is_array() && type->has_elements()) || type->is_custom_type());
+}
+
+//The bytes of the aggregate that are cleared, relative to its position
+mtac::ByteRange cleared_range(const std::shared_ptr<Variable>& var, Platform platform){
+    auto type = var->type();
+
+    if(type->is_array()){
+        int int_size = INT->size(platform);
+        return {int_size, int_size + static_cast<int>(type->data_type()->size(platform) * type->elements())};
+    }
+
+    return {0, static_cast<int>(type->size(platform))};
+}
+
+//The offsets of the sizes of the arrays inside a structure
+std::vector<std::pair<int, int>> array_sizes(mtac::Function& function, std::shared_ptr<const Type> type){
+    std::vector<std::pair<int, int>> sizes;
+
+    auto struct_type = function.context->global()->get_struct(type);
+
+    while(struct_type){
+        for(auto& member : struct_type->members){
+            if(member.type->is_array() && !member.type->is_dynamic_array()){
+                sizes.emplace_back(function.context->global()->member_offset(struct_type, member.name), static_cast<int>(member.type->elements()));
             }
         }
 
-        optimize_ranges(memset_ranges);
+        struct_type = function.context->global()->get_struct(struct_type->parent_type);
+    }
 
-        for(auto& range : memset_ranges){
-            int size = range.second / int_size;
+    return sizes;
+}
 
-            if(size < 8){
-                for(int i = 0; i < size; ++i){
-                    bb->emplace_back_low(ltac::Operator::MOV, ltac::Address(ltac::BP, range.first + i * int_size), 0);
-                }
-            } else {
-                int int_in_sse = 16 / int_size;
+mtac::basic_block_p common_dominator(mtac::basic_block_p a, mtac::basic_block_p b){
+    std::unordered_set<mtac::basic_block_p> dominators;
 
-                ltac::PseudoFloatRegister reg(function.pseudo_float_registers());
-                function.set_pseudo_float_registers(function.pseudo_float_registers() + 1);
+    while(a){
+        dominators.insert(a);
+        a = a->dominator();
+    }
 
-                bb->emplace_back_low(ltac::Operator::XORPS, reg, reg);
+    while(b && !dominators.count(b)){
+        b = b->dominator();
+    }
 
-                int normal = size % int_in_sse; 
+    return b;
+}
 
-                for(int i = 0; i < normal; ++i){
-                    bb->emplace_back_low(ltac::Operator::MOV, ltac::Address(ltac::BP, range.first + i * int_size), 0);
-                }
+bool in_cycle(mtac::basic_block_p bb){
+    std::unordered_set<mtac::basic_block_p> visited;
+    std::vector<mtac::basic_block_p> stack(bb->successors.begin(), bb->successors.end());
+
+    while(!stack.empty()){
+        auto current = stack.back();
+        stack.pop_back();
+
+        if(current == bb){
+            return true;
+        }
+
+        if(visited.insert(current).second){
+            stack.insert(stack.end(), current->successors.begin(), current->successors.end());
+        }
+    }
+
+    return false;
+}
+
+//Insert the instructions at a given position of a basic block
+struct Cursor {
+    mtac::Function& function;
+    mtac::basic_block_p bb;
+    std::size_t position;
+
+    Cursor(mtac::Function& function, mtac::basic_block_p bb, std::size_t position) : function(function), bb(bb), position(position) {}
+
+    template<typename... Args>
+    void emit(Args&&... args){
+        bb->l_statements.insert(bb->l_statements.begin() + position, ltac::Instruction(std::forward<Args>(args)...));
+        ++position;
+    }
+};
+
+Cursor cursor_at(mtac::Function& function, mtac::basic_block_p bb){
+    //The entry is cleared after its own instructions, the other blocks before them
+    if(bb == function.entry_bb()){
+        return Cursor(function, bb, bb->l_statements.size());
+    }
+
+    std::size_t position = 0;
+    while(position < bb->l_statements.size() && bb->l_statements[position].is_label()){
+        ++position;
+    }
+
+    return Cursor(function, bb, position);
+}
+
+//Large ranges are cleared by a loop when rep stos cannot be used, the block is split after the cursor
+void clear_loop(Cursor& cursor, int first, int bytes){
+    auto& function = cursor.function;
+    auto bb = cursor.bb;
+
+    auto zero = new_float_register(function);
+    auto index = new_register(function);
+
+    cursor.emit(ltac::Operator::XORPS, zero, zero);
+    cursor.emit(ltac::Operator::MOV, index, 0);
+
+    auto loop = function.new_bb();
+    loop->label = newLabel();
+    loop->depth = bb->depth + 1;
+    loop->frequency = bb->frequency;
+
+    auto rest = function.new_bb();
+    rest->label = newLabel();
+    rest->depth = bb->depth;
+    rest->frequency = bb->frequency;
+
+    auto split = bb->l_statements.begin() + cursor.position;
+    rest->l_statements.assign(std::make_move_iterator(split), std::make_move_iterator(bb->l_statements.end()));
+    bb->l_statements.erase(split, bb->l_statements.end());
+
+    loop->emplace_back_low(loop->label, ltac::Operator::LABEL);
+    loop->emplace_back_low(ltac::Operator::MOVDQU, ltac::Address(ltac::BP, index, 1, first), zero);
+    loop->emplace_back_low(ltac::Operator::ADD, index, 16);
+    loop->emplace_back_low(ltac::Operator::CMP_INT, index, bytes);
+    loop->emplace_back_low(loop->label, ltac::Operator::L);
+
+    function.insert_after(function.at(bb), loop);
+    function.insert_after(function.at(loop), rest);
+
+    auto successors = bb->successors;
+    for(auto& succ : successors){
+        mtac::remove_edge(bb, succ);
+        mtac::make_edge(rest, succ);
+    }
+
+    mtac::make_edge(bb, loop);
+    mtac::make_edge(loop, loop);
+    mtac::make_edge(loop, rest);
+
+    cursor.bb = rest;
+    cursor.position = 0;
+}
+
+void clear(Cursor& cursor, std::pair<int, int> range, bool use_rep_stos, Platform platform){
+    auto& function = cursor.function;
+    auto descriptor = getPlatformDescriptor(platform);
+
+    int int_size = INT->size(platform);
+    int size = range.second / int_size;
+
+    if(size < 8){
+        for(int i = 0; i < size; ++i){
+            cursor.emit(ltac::Operator::MOV, ltac::Address(ltac::BP, range.first + i * int_size), 0);
+        }
+    } else if(size >= 64 && use_rep_stos){
+        //Large ranges are cleared in a single string instruction
+        auto di = bound_register(function, descriptor->di_register());
+        auto c = bound_register(function, descriptor->c_register());
+        auto a = bound_register(function, descriptor->a_register());
+
+        cursor.emit(ltac::Operator::LEA, di, ltac::Address(ltac::BP, range.first));
+        cursor.emit(ltac::Operator::MOV, c, size);
+        cursor.emit(ltac::Operator::MOV, a, 0);
+        cursor.emit(ltac::Operator::REP_STOS, di, c, a);
+    } else {
+        int int_in_sse = 16 / int_size;
+        int normal = size % int_in_sse; 
+
+        for(int i = 0; i < normal; ++i){
+            cursor.emit(ltac::Operator::MOV, ltac::Address(ltac::BP, range.first + i * int_size), 0);
+        }
+
+        if(size >= 64){
+            clear_loop(cursor, range.first + normal * int_size, (size - normal) * int_size);
+        } else {
+            auto reg = new_float_register(function);
+
+            cursor.emit(ltac::Operator::XORPS, reg, reg);
+
+            for(int i = 0; i < size - normal; i += int_in_sse){
+                cursor.emit(ltac::Operator::MOVDQU, ltac::Address(ltac::BP, range.first + (i + normal) * int_size), reg);
+            }
+        }
+    }
+
+    //Char and bool arrays are not always a multiple of the word size
+    for(int i = size * int_size; i < range.second; ++i){
+        cursor.emit(ltac::Operator::MOV, ltac::Address(ltac::BP, range.first + i), 0, tac::Size::BYTE);
+    }
+}
+
+void set_sizes(Cursor& cursor, const std::shared_ptr<Variable>& var){
+    auto type = var->type();
+    int position = var->position().offset();
+
+    if(type->is_array()){
+        cursor.emit(ltac::Operator::MOV, ltac::Address(ltac::BP, position), static_cast<int>(type->elements()));
+    } else {
+        //Set lengths of arrays inside structures
+        for(auto& size : array_sizes(cursor.function, type)){
+            cursor.emit(ltac::Operator::MOV, ltac::Address(ltac::BP, position + size.first), size.second);
+        }
+    }
+}
+
+//Find where an aggregate must be cleared, null if it is always written before being read
+void find_clear_points(mtac::Function& function, Platform platform){
+    mtac::InitializedValues initial;
+    std::vector<std::shared_ptr<Variable>> aggregates;
 
-                for(int i = 0; i < size - normal; i += int_in_sse){
-                    bb->emplace_back_low(ltac::Operator::MOVDQU, ltac::Address(ltac::BP, range.first + (i +    normal) * int_size), reg);
+    for(auto& var_pair : *function.context){
+        auto& var = var_pair.second;
+
+        if(is_aggregate(var)){
+            aggregates.push_back(var);
+
+            //The sizes of the inner arrays are set with the clearing
+            auto& ranges = initial[var];
+            if(var->type()->is_custom_type()){
+                for(auto& size : array_sizes(function, var->type())){
+                    ranges.emplace_back(size.first, size.first + static_cast<int>(INT->size(platform)));
                 }
+
+                std::sort(ranges.begin(), ranges.end(), [](const mtac::ByteRange& lhs, const mtac::ByteRange& rhs){ return lhs.first < rhs.first; });
             }
         }
+    }
 
-        //Set the sizes of arrays
+    if(aggregates.empty()){
+        return;
+    }
+
+    mtac::compute_dominators(function);
+
+    mtac::DefiniteInitializationProblem problem(platform, initial);
+    auto results = mtac::data_flow(function, problem);
+
+    //Walk again through the statements to find the reads of bytes not always written
+    mtac::DefiniteInitializationProblem checker(platform, initial);
+
+    std::unordered_set<std::shared_ptr<Variable>> uninitialized;
+    std::unordered_map<std::shared_ptr<Variable>, mtac::basic_block_p> uses;
+
+    for(auto& bb : function){
+        auto& in_domain = results->IN[bb];
+
+        //The unreachable blocks are not considered
+        if(bb->statements.empty() || in_domain.top()){
+            continue;
+        }
+
+        auto in = in_domain;
+
+        for(auto& quadruple : bb->statements){
+            for(auto& var : aggregates){
+                auto access = checker.access(bb, quadruple, var);
+
+                if(!access.read && !access.write){
+                    continue;
+                }
+
+                auto it = uses.find(var);
+                if(it == uses.end()){
+                    uses[var] = bb;
+                } else {
+                    it->second = common_dominator(it->second, bb);
+                }
+
+                if(access.read){
+                    auto range = cleared_range(var, platform);
+
+                    if(!access.complete){
+                        range.first = std::max(range.first, access.range.first);
+                        range.last = std::min(range.last, access.range.last);
+                    }
 
-        for(auto& var_pair : *function.context){
-            auto& var = var_pair.second;
-
-            if(var->position().isStack()){
-                auto type = var->type();
-                int position = var->position().offset();
-
-                if(type->is_array() && type->has_elements()){
-                    bb->emplace_back_low(ltac::Operator::MOV, ltac::Address(ltac::BP, position), static_cast<int>(type->elements()));
-                } else if(type->is_custom_type()){
-                    //Set lengths of arrays inside structures
-                    auto struct_type = function.context->global()->get_struct(type);
-                    auto offset = 0;
-
-                    while(struct_type){
-                        for(auto& member : struct_type->members){
-                            if(member.type->is_array() && !member.type->is_dynamic_array()){
-                                bb->emplace_back_low(ltac::Operator::MOV, 
-                                        ltac::Address(ltac::BP, position + offset + function.context->global()->member_offset(struct_type, member.name)),
-                                        static_cast<int>(member.type->elements()));
-                            }
-                        }
-
-                        struct_type = function.context->global()->get_struct(struct_type->parent_type);
+                    if(!mtac::initialized(in.values()[var], range)){
+                        uninitialized.insert(var);
                     }
                 }
             }
+
+            checker.transfer(bb, quadruple, in);
+        }
+    }
+
+    for(auto& var : aggregates){
+        if(!uninitialized.count(var)){
+            LOG<Trace>("Stack") << var->name() << " is always written before being read in " << function.get_name() << log::endl;
+            function.context->global()->stats().inc_counter("stack_clearing_removed");
+
+            function.clear_points()[var] = nullptr;
+            continue;
         }
+
+        //The aggregate must not be cleared several times
+        auto point = uses[var];
+        while(point && in_cycle(point)){
+            point = point->dominator();
+        }
+
+        if(point && point != function.entry_bb() && point != function.entry_bb()->next()){
+            LOG<Trace>("Stack") << var->name() << " is cleared in B" << point->index << " of " << function.get_name() << log::endl;
+            function.context->global()->stats().inc_counter("stack_clearing_sunk");
+
+            function.clear_points()[var] = point;
+        }
+    }
+}
+
+} //end of anonymous namespace
+
+void ltac::find_clear_points(mtac::Program& program){
+    timing_timer timer(program.context->timing(), "stack_clear_points");
+
+    auto platform = program.context->target_platform();
+
+    for(auto& function : program.functions){
+        ::find_clear_points(function, platform);
+    }
+}
+
+void ltac::alloc_stack_space(mtac::Function& function, Platform platform){
+    timing_timer timer(function.context->global()->timing(), "stack_space");
+
+    auto descriptor = getPlatformDescriptor(platform);
+
+    auto entry = function.entry_bb();
+    auto use_rep_stos = rep_stos_safe(function, descriptor);
+
+    //Group the stack variables by the block where they are cleared
+
+    std::unordered_map<mtac::basic_block_p, std::vector<std::shared_ptr<Variable>>> cleared;
+    std::vector<std::shared_ptr<Variable>> not_cleared;
+
+    for(auto& var_pair : *function.context){
+        auto& var = var_pair.second;
+
+        if(is_aggregate(var)){
+            auto it = function.clear_points().find(var);
+
+            if(it == function.clear_points().end()){
+                cleared[entry].push_back(var);
+            } else if(it->second){
+                cleared[it->second].push_back(var);
+            } else {
+                not_cleared.push_back(var);
+            }
+        }
+    }
+
+    //The blocks are split by the clearing loops, they are collected first
+    std::vector<mtac::basic_block_p> blocks;
+    for(auto& bb : function){
+        if(cleared.count(bb)){
+            blocks.push_back(bb);
+        }
+    }
+
+    for(auto& bb : blocks){
+        auto& variables = cleared[bb];
+        auto cursor = cursor_at(function, bb);
+
+        //Clear the stack variables
+
+        std::vector<std::pair<int, int>> memset_ranges;
+
+        for(auto& var : variables){
+            auto range = cleared_range(var, platform);
+            memset_ranges.emplace_back(var->position().offset() + range.first, range.last - range.first);
+        }
+
+        optimize_ranges(memset_ranges);
+
+        for(auto& range : memset_ranges){
+            clear(cursor, range, use_rep_stos, platform);
+        }
+
+        //Set the sizes of arrays
+
+        for(auto& var : variables){
+            set_sizes(cursor, var);
+        }
+    }
+
+    if(!not_cleared.empty()){
+        auto cursor = cursor_at(function, function.entry_bb());
+
+        for(auto& var : not_cleared){
+            set_sizes(cursor, var);
+        }
+    }
+}
+
+void ltac::alloc_stack_space(mtac::Program& program){
+    auto platform = program.context->target_platform();
+
+    for(auto& function : program.functions){
+        ltac::alloc_stack_space(function, platform);
     }
 }
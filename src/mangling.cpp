@@ -47,34 +47,40 @@ std::string eddic::mangle(std::shared_ptr<const Type> type){
     } 
 
     if(type->is_custom_type()){
-        std::ostringstream ss;
-
-        ss << "U";
-        ss << type->type().length();
-        ss << type->type();
-
-        return ss.str();
+        return mangle_custom_type(type->type());
     }
 
     if(type->is_template_type()){
-        std::ostringstream ss;
+        return mangle_template_type(type->type(), type->template_types());
+    }
 
-        ss << "T";
-        ss << type->type().length();
-        ss << type->type();
+    cpp_unreachable("Invalid type");
+}
 
-        auto types = type->template_types();
+std::string eddic::mangle_custom_type(const std::string& name){
+    std::ostringstream ss;
 
-        ss << types.size();
+    ss << "U";
+    ss << name.length();
+    ss << name;
 
-        for(auto& sub_type : types){
-            ss << sub_type->mangle();
-        }
+    return ss.str();
+}
+
+std::string eddic::mangle_template_type(const std::string& name, const std::vector<std::shared_ptr<const Type>>& types){
+    std::ostringstream ss;
 
-        return ss.str();
+    ss << "T";
+    ss << name.length();
+    ss << name;
+
+    ss << types.size();
+
+    for(auto& sub_type : types){
+        ss << sub_type->mangle();
     }
 
-    cpp_unreachable("Invalid type");
+    return ss.str();
 }
 
 std::string eddic::mangle(const std::string& name, const std::vector<Parameter>& parameters, std::shared_ptr<const Type> struct_type){
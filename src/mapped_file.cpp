@@ -0,0 +1,105 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mapped_file.hpp"
+
+using namespace eddic;
+
+mapped_file::~mapped_file(){
+    close();
+}
+
+mapped_file::mapped_file(mapped_file&& rhs) noexcept : m_data(rhs.m_data), m_size(rhs.m_size), m_open(rhs.m_open) {
+    rhs.m_data = nullptr;
+    rhs.m_size = 0;
+    rhs.m_open = false;
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept {
+    if(this != &rhs){
+        close();
+
+        m_data = rhs.m_data;
+        m_size = rhs.m_size;
+        m_open = rhs.m_open;
+
+        rhs.m_data = nullptr;
+        rhs.m_size = 0;
+        rhs.m_open = false;
+    }
+
+    return *this;
+}
+
+bool mapped_file::open(const std::string& file){
+    close();
+
+    int fd = ::open(file.c_str(), O_RDONLY);
+
+    if(fd < 0){
+        return false;
+    }
+
+    struct stat infos;
+    if(fstat(fd, &infos) < 0){
+        ::close(fd);
+        return false;
+    }
+
+    m_size = infos.st_size;
+
+    //An empty file cannot be mapped
+    if(m_size > 0){
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(data == MAP_FAILED){
+            ::close(fd);
+            m_size = 0;
+            return false;
+        }
+
+        m_data = static_cast<const char*>(data);
+    }
+
+    //The mapping stays valid after the descriptor is closed
+    ::close(fd);
+
+    m_open = true;
+
+    return true;
+}
+
+void mapped_file::close(){
+    if(m_data){
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+bool mapped_file::is_open() const {
+    return m_open;
+}
+
+const char* mapped_file::begin() const {
+    return m_data;
+}
+
+const char* mapped_file::end() const {
+    return m_data + m_size;
+}
+
+std::size_t mapped_file::size() const {
+    return m_size;
+}
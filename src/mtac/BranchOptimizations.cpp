@@ -24,10 +24,10 @@ bool mtac::optimize_branches::operator()(mtac::Function& function){
                     mtac::Quadruple goto_(quadruple.label(), mtac::Operator::GOTO);
                     goto_.block = quadruple.block;
 
-                    quadruple = std::move(goto_);
+                    block->statements.replace(quadruple, std::move(goto_));
                     optimized = true;
 
-                    mtac::remove_edge(block, block->next);
+                    mtac::remove_edge(block, block->next());
                 } else if(value == 1){
                     mtac::remove_edge(block, quadruple.block);
 
@@ -46,10 +46,10 @@ bool mtac::optimize_branches::operator()(mtac::Function& function){
                     auto goto_ = mtac::Quadruple(quadruple.label(), mtac::Operator::GOTO);
                     goto_.block = quadruple.block;
 
-                    quadruple = std::move(goto_);
+                    block->statements.replace(quadruple, std::move(goto_));
                     optimized = true;
 
-                    mtac::remove_edge(block, block->next);
+                    mtac::remove_edge(block, block->next());
                 }
             }
         }
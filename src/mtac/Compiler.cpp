@@ -28,6 +28,7 @@
 #include "mtac/Program.hpp"
 #include "mtac/Utils.hpp"
 #include "mtac/Quadruple.hpp"
+#include "mtac/memory_intrinsics.hpp"
 
 #include "ast/SourceFile.hpp"
 #include "ast/GetTypeVisitor.hpp"
@@ -52,6 +53,8 @@ arguments move_to_arguments(ast::Value value, mtac::Function& function);
 
 void pass_arguments(mtac::Function& function, eddic::Function& definition, std::vector<ast::Value>& values);
 
+void compile_memory_intrinsic(mtac::Function& function, eddic::Function& definition, std::vector<ast::Value>& values);
+
 arguments compile_ternary(mtac::Function& function, ast::Ternary& ternary);
 
 mtac::Argument index_of_array(std::shared_ptr<Variable> array, ast::Value indexValue, mtac::Function& function){
@@ -761,6 +764,12 @@ struct ToArgumentsVisitor : public boost::static_visitor<arguments> {
         auto& definition = call.context->global()->getFunction(call.mangled_name);
         auto type = definition.return_type();
 
+        if(mtac::is_memory_intrinsic(definition)){
+            compile_memory_intrinsic(function, definition, call.values);
+
+            return {};
+        }
+
         if(type == VOID){
             pass_arguments(function, definition, call.values);
 
@@ -1680,6 +1689,112 @@ void pass_arguments(mtac::Function& function, eddic::Function& definition, std::
     }
 }
 
+//Compute the byte offset of the element at the given index
+mtac::Argument byte_offset(mtac::Function& function, mtac::Argument index, int element_size, int int_size){
+    if(auto* ptr = boost::get<int>(&index)){
+        return *ptr * element_size + int_size;
+    }
+
+    auto temp = function.context->new_temporary(INT);
+
+    function.emplace_back(temp, index, mtac::Operator::MUL, element_size);
+    function.emplace_back(temp, temp, mtac::Operator::ADD, int_size);
+
+    return temp;
+}
+
+mtac::Argument add_offset(mtac::Function& function, mtac::Argument offset, int value){
+    if(auto* ptr = boost::get<int>(&offset)){
+        return *ptr + value;
+    }
+
+    auto temp = function.context->new_temporary(INT);
+    function.emplace_back(temp, offset, mtac::Operator::ADD, value);
+    return temp;
+}
+
+mtac::Argument byte_count(mtac::Function& function, mtac::Argument count, int element_size){
+    if(auto* ptr = boost::get<int>(&count)){
+        return *ptr * element_size;
+    }
+
+    auto temp = function.context->new_temporary(INT);
+    function.emplace_back(temp, count, mtac::Operator::MUL, element_size);
+    return temp;
+}
+
+bool unrollable(mtac::Argument& count, std::shared_ptr<const Type> data_type){
+    if(auto* ptr = boost::get<int>(&count)){
+        return *ptr <= mtac::memory_intrinsic_unroll_limit && (data_type == INT || data_type == CHAR || data_type == BOOL || data_type == FLOAT);
+    }
+
+    return false;
+}
+
+void compile_memory_intrinsic(mtac::Function& function, eddic::Function& definition, std::vector<ast::Value>& values){
+    auto platform = function.context->global()->target_platform();
+    int int_size = INT->size(platform);
+
+    auto data_type = visit(ast::GetTypeVisitor(), values[0])->data_type();
+    int element_size = data_type->size(platform);
+    auto size = data_type == CHAR || data_type == BOOL ? tac::Size::BYTE : tac::Size::DEFAULT;
+
+    if(definition.mangled_name() == mtac::memcpy_helper){
+        //memcpy(dest, src, count) or memcpy(dest, dest_index, src, src_index, count)
+        bool indexed = values.size() == 5;
+
+        auto dest = boost::get<std::shared_ptr<Variable>>(moveToArgument(values[0], function));
+        auto dest_offset = byte_offset(function, indexed ? moveToArgument(values[1], function) : 0, element_size, int_size);
+        auto src = boost::get<std::shared_ptr<Variable>>(moveToArgument(values[indexed ? 2 : 1], function));
+        auto src_offset = byte_offset(function, indexed ? moveToArgument(values[3], function) : 0, element_size, int_size);
+        auto count = moveToArgument(values.back(), function);
+
+        if(unrollable(count, data_type)){
+            for(int i = 0; i < boost::get<int>(count); ++i){
+                auto temp = function.context->new_temporary(data_type);
+
+                function.emplace_back(temp, src, mtac::Operator::DOT, add_offset(function, src_offset, i * element_size), size);
+
+                if(data_type == FLOAT){
+                    function.emplace_back(dest, add_offset(function, dest_offset, i * element_size), mtac::Operator::DOT_FASSIGN, temp);
+                } else {
+                    function.emplace_back(dest, add_offset(function, dest_offset, i * element_size), mtac::Operator::DOT_ASSIGN, temp, size);
+                }
+            }
+        } else {
+            mtac::emit_memcpy(function, definition, dest, dest_offset, src, src_offset, byte_count(function, count, element_size));
+        }
+    } else {
+        //memset(dest, value, count) or memset(dest, dest_index, value, count)
+        bool indexed = values.size() == 4;
+
+        auto dest = boost::get<std::shared_ptr<Variable>>(moveToArgument(values[0], function));
+        auto dest_offset = byte_offset(function, indexed ? moveToArgument(values[1], function) : 0, element_size, int_size);
+        auto value = moveToArgument(values[indexed ? 2 : 1], function);
+        auto count = moveToArgument(values.back(), function);
+
+        if(unrollable(count, data_type)){
+            for(int i = 0; i < boost::get<int>(count); ++i){
+                function.emplace_back(dest, add_offset(function, dest_offset, i * element_size), mtac::Operator::DOT_ASSIGN, value, size);
+            }
+        } else {
+            //The helper always takes the value as a full integer
+            if(size == tac::Size::BYTE && mtac::isVariable(value)){
+                auto temp = function.context->new_temporary(INT);
+                function.emplace_back(temp, value, mtac::Operator::ASSIGN);
+                value = temp;
+            }
+
+            mtac::emit_memset(function, definition, dest, dest_offset, value, byte_count(function, count, element_size), element_size);
+        }
+    }
+}
+
+//The AST of a function is not necessary anymore once its MTAC has been generated
+void release_instructions(std::vector<ast::Instruction>& instructions){
+    std::vector<ast::Instruction>().swap(instructions);
+}
+
 } //end of anonymous namespace
 
 void mtac::Compiler::compile(ast::SourceFile& source, std::shared_ptr<StringPool>, mtac::Program& program) const {
@@ -1698,6 +1813,8 @@ void mtac::Compiler::compile(ast::SourceFile& source, std::shared_ptr<StringPool
 
                 visit_each(compiler, ptr->instructions);
                 compiler.issue_destructors(ptr->context);
+
+                release_instructions(ptr->instructions);
             }
         } else if(auto* struct_ptr = boost::get<ast::struct_definition>(&block)){
             if(!struct_ptr->is_template_declaration()){
@@ -1712,6 +1829,8 @@ void mtac::Compiler::compile(ast::SourceFile& source, std::shared_ptr<StringPool
 
                             visit_each(compiler, ptr->instructions);
                             compiler.issue_destructors(ptr->context);
+
+                            release_instructions(ptr->instructions);
                         }
                     } else if(auto* ptr = boost::get<ast::Constructor>(&struct_block)){
                         program.functions.emplace_back(ptr->context, ptr->mangledName, program.context->getFunction(ptr->mangledName));
@@ -1722,6 +1841,8 @@ void mtac::Compiler::compile(ast::SourceFile& source, std::shared_ptr<StringPool
 
                         visit_each(compiler, ptr->instructions);
                         compiler.issue_destructors(ptr->context);
+
+                        release_instructions(ptr->instructions);
                     } else if(auto* ptr = boost::get<ast::Destructor>(&struct_block)){
                         program.functions.emplace_back(ptr->context, ptr->mangledName, program.context->getFunction(ptr->mangledName));
                         auto& function = program.functions.back();
@@ -1731,6 +1852,8 @@ void mtac::Compiler::compile(ast::SourceFile& source, std::shared_ptr<StringPool
 
                         visit_each(compiler, ptr->instructions);
                         compiler.issue_destructors(ptr->context);
+
+                        release_instructions(ptr->instructions);
                     }
                 }
             }
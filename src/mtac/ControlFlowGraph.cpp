@@ -20,15 +20,15 @@ void mtac::make_edge(mtac::basic_block_p from, mtac::basic_block_p to){
 }
 
 void mtac::remove_edge(mtac::basic_block_p from, mtac::basic_block_p to){
-    from->successors.erase(std::remove(from->successors.begin(), from->successors.end(), to), from->successors.end());
-    to->predecessors.erase(std::remove(to->predecessors.begin(), to->predecessors.end(), from), to->predecessors.end());
+    from->successors.remove(to);
+    to->predecessors.remove(from);
 }
 
 void mtac::build_control_flow_graph(mtac::Function& function){
     //Add the edges
     for(auto& block : function){
         //Get the following block
-        auto next = block->next;
+        auto next = block->next();
         
         //ENTRY
         if(block->index == -1){
@@ -0,0 +1,256 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "Function.hpp"
+
+#include "mtac/DefiniteInitializationProblem.hpp"
+#include "mtac/memory_intrinsics.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/Quadruple.hpp"
+
+using namespace eddic;
+
+typedef mtac::DefiniteInitializationProblem::ProblemDomain ProblemDomain;
+
+namespace {
+
+bool uses(mtac::Quadruple& quadruple, const std::shared_ptr<Variable>& variable){
+    return quadruple.result == variable || quadruple.secondary == variable
+        || (quadruple.arg1 && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, variable))
+        || (quadruple.arg2 && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg2, variable));
+}
+
+int size_of(tac::Size size, int default_size){
+    switch(size){
+        case tac::Size::BYTE:
+            return 1;
+        case tac::Size::WORD:
+            return 2;
+        case tac::Size::DOUBLE_WORD:
+            return 4;
+        case tac::Size::QUAD_WORD:
+            return 8;
+        default:
+            return default_size;
+    }
+}
+
+void add(std::vector<mtac::ByteRange>& ranges, mtac::ByteRange range){
+    ranges.push_back(range);
+
+    std::sort(ranges.begin(), ranges.end(), [](const mtac::ByteRange& lhs, const mtac::ByteRange& rhs){ return lhs.first < rhs.first; });
+
+    //Merge the overlapping and adjacent ranges
+    std::vector<mtac::ByteRange> merged;
+
+    for(auto& current : ranges){
+        if(!merged.empty() && current.first <= merged.back().last){
+            merged.back().last = std::max(merged.back().last, current.last);
+        } else {
+            merged.push_back(current);
+        }
+    }
+
+    ranges = std::move(merged);
+}
+
+std::vector<mtac::ByteRange> intersection(const std::vector<mtac::ByteRange>& lhs, const std::vector<mtac::ByteRange>& rhs){
+    std::vector<mtac::ByteRange> result;
+
+    auto l = lhs.begin();
+    auto r = rhs.begin();
+
+    while(l != lhs.end() && r != rhs.end()){
+        auto first = std::max(l->first, r->first);
+        auto last = std::min(l->last, r->last);
+
+        if(first < last){
+            result.emplace_back(first, last);
+        }
+
+        if(l->last < r->last){
+            ++l;
+        } else {
+            ++r;
+        }
+    }
+
+    return result;
+}
+
+} //end of anonymous namespace
+
+std::ostream& mtac::operator<<(std::ostream& stream, const mtac::ByteRange& range){
+    return stream << "[" << range.first << ", " << range.last << "[";
+}
+
+mtac::DefiniteInitializationProblem::DefiniteInitializationProblem(Platform platform, InitializedValues initial) : platform(platform), initial(std::move(initial)) {
+    //Nothing else to init
+}
+
+ProblemDomain mtac::DefiniteInitializationProblem::Boundary(mtac::Function& /*function*/){
+    return ProblemDomain(initial);
+}
+
+ProblemDomain mtac::DefiniteInitializationProblem::Init(mtac::Function& /*function*/){
+    //By default, return the top element
+    return ProblemDomain();
+}
+
+void mtac::DefiniteInitializationProblem::meet(ProblemDomain& in, const ProblemDomain& out){
+    if(out.top()){
+        //in does not change
+        return;
+    } else if(in.top()){
+        in = out;
+        return;
+    }
+
+    for(auto& pair : in.values()){
+        auto it = out.values().find(pair.first);
+
+        if(it == out.values().end()){
+            pair.second.clear();
+        } else {
+            pair.second = intersection(pair.second, it->second);
+        }
+    }
+}
+
+void mtac::DefiniteInitializationProblem::collect(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple){
+    if(quadruple.uid() == current_uid){
+        return;
+    }
+
+    current_uid = quadruple.uid();
+
+    //The parameters of a call are never split from their call
+    if(quadruple.uid() == basic_block->statements.front().uid() || quadruple.op == mtac::Operator::CALL){
+        parameters.clear();
+    }
+
+    if(quadruple.op == mtac::Operator::PARAM && mtac::is_memory_intrinsic(quadruple.function())){
+        if(auto* ptr = boost::get<int>(&*quadruple.arg1)){
+            parameters[quadruple.std_param()] = *ptr;
+        } else {
+            parameters.erase(quadruple.std_param());
+        }
+    }
+}
+
+mtac::AggregateAccess mtac::DefiniteInitializationProblem::access(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple, const std::shared_ptr<Variable>& variable){
+    collect(basic_block, quadruple);
+
+    AggregateAccess access;
+
+    if(!uses(quadruple, variable)){
+        return access;
+    }
+
+    auto int_size = INT->size(platform);
+    auto float_size = FLOAT->size(platform);
+
+    if((quadruple.op == mtac::Operator::DOT || quadruple.op == mtac::Operator::FDOT) && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, variable)){
+        access.read = true;
+
+        if(auto* ptr = boost::get<int>(&*quadruple.arg2)){
+            //The size of the value is not always known, the largest read is considered
+            access.range = {*ptr, *ptr + size_of(quadruple.size, std::max(int_size, float_size))};
+        } else {
+            access.complete = true;
+        }
+
+        return access;
+    }
+
+    if((quadruple.op == mtac::Operator::DOT_ASSIGN || quadruple.op == mtac::Operator::DOT_FASSIGN || quadruple.op == mtac::Operator::DOT_PASSIGN)
+            && quadruple.result == variable && !mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, variable) 
+            && !mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg2, variable)){
+        access.write = true;
+
+        if(auto* ptr = boost::get<int>(&*quadruple.arg1)){
+            auto size = quadruple.op == mtac::Operator::DOT_FASSIGN ? float_size : int_size;
+            access.range = {*ptr, *ptr + size_of(quadruple.size, size)};
+        }
+
+        return access;
+    }
+
+    if(quadruple.op == mtac::Operator::PPARAM && mtac::is_memory_intrinsic(quadruple.function())){
+        if(quadruple.std_param() == "dest"){
+            access.write = true;
+
+            if(parameters.count("dest_offset") && parameters.count("bytes")){
+                access.range = {parameters["dest_offset"], parameters["dest_offset"] + parameters["bytes"]};
+            }
+
+            return access;
+        } else if(quadruple.std_param() == "src"){
+            access.read = true;
+
+            if(parameters.count("src_offset") && parameters.count("bytes")){
+                access.range = {parameters["src_offset"], parameters["src_offset"] + parameters["bytes"]};
+            } else {
+                access.complete = true;
+            }
+
+            return access;
+        }
+    }
+
+    //Any other use may read the complete aggregate
+    access.read = true;
+    access.complete = true;
+
+    return access;
+}
+
+void mtac::DefiniteInitializationProblem::transfer(mtac::basic_block_p basic_block, mtac::Quadruple& quadruple, ProblemDomain& in){
+    collect(basic_block, quadruple);
+
+    if(in.top()){
+        return;
+    }
+
+    for(auto& pair : in.values()){
+        auto access = this->access(basic_block, quadruple, pair.first);
+
+        if(access.write && access.range.first < access.range.last){
+            add(pair.second, access.range);
+        }
+    }
+}
+
+bool mtac::initialized(const std::vector<ByteRange>& ranges, ByteRange range){
+    if(range.first >= range.last){
+        return true;
+    }
+
+    for(auto& written : ranges){
+        if(written.first <= range.first && written.last >= range.last){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool mtac::operator==(const mtac::Domain<InitializedValues>& lhs, const mtac::Domain<InitializedValues>& rhs){
+    if(lhs.top() || rhs.top()){
+        return lhs.top() == rhs.top();
+    }
+
+    return lhs.values() == rhs.values();
+}
+
+bool mtac::operator!=(const mtac::Domain<InitializedValues>& lhs, const mtac::Domain<InitializedValues>& rhs){
+    return !(lhs == rhs);
+}
@@ -17,7 +17,7 @@
 
 using namespace eddic;
 
-mtac::Function::Function(std::shared_ptr<FunctionContext> c, std::string n, eddic::Function& definition) : context(c), _definition(&definition), name(std::move(n)) {
+mtac::Function::Function(std::shared_ptr<FunctionContext> c, std::string n, eddic::Function& definition) : context(c), _definition(&definition), pool(std::make_unique<block_pool>()), name(std::move(n)) {
     //Nothing to do   
 }
         
@@ -25,15 +25,15 @@ mtac::Function::Function(mtac::Function&& rhs) :
             context(std::move(rhs.context)), _definition(rhs._definition), 
             statements(std::move(rhs.statements)), 
             _pure(std::move(rhs._pure)), _standard(std::move(rhs._standard)),
-            count(std::move(rhs.count)), index(std::move(rhs.index)),
-            entry(std::move(rhs.entry)), exit(std::move(rhs.exit)), 
+            index(std::move(rhs.index)), pool(std::move(rhs.pool)),
             _use_registers(std::move(rhs._use_registers)), _use_float_registers(std::move(rhs._use_float_registers)),
             _variable_registers(std::move(rhs._variable_registers)), _variable_float_registers(std::move(rhs._variable_float_registers)),
+            _clobbered_registers(std::move(rhs._clobbered_registers)), _clobbered_float_registers(std::move(rhs._clobbered_float_registers)),
+            _clear_points(std::move(rhs._clear_points)),
             last_pseudo_registers(std::move(rhs.last_pseudo_registers)), last_float_pseudo_registers(std::move(rhs.last_float_pseudo_registers)),
             m_loops(std::move(rhs.m_loops)), name(std::move(rhs.name))
         {
     //Reset rhs
-    rhs.count = 0;
     rhs.index = 0;
     rhs.last_pseudo_registers = 0;
     rhs.last_float_pseudo_registers = 0;
@@ -45,21 +45,21 @@ mtac::Function& mtac::Function::operator=(mtac::Function&& rhs){
     statements = std::move(rhs.statements); 
     _pure = std::move(rhs._pure);
     _standard = std::move(rhs._standard);
-    count = std::move(rhs.count); 
     index = std::move(rhs.index);
-    entry = std::move(rhs.entry); 
-    exit = std::move(rhs.exit); 
+    pool = std::move(rhs.pool);
     _use_registers = std::move(rhs._use_registers); 
     _use_float_registers = std::move(rhs._use_float_registers);
     _variable_registers = std::move(rhs._variable_registers); 
     _variable_float_registers = std::move(rhs._variable_float_registers);
+    _clobbered_registers = std::move(rhs._clobbered_registers); 
+    _clobbered_float_registers = std::move(rhs._clobbered_float_registers);
+    _clear_points = std::move(rhs._clear_points);
     last_pseudo_registers = std::move(rhs.last_pseudo_registers); 
     last_float_pseudo_registers = std::move(rhs.last_float_pseudo_registers);
     m_loops = std::move(rhs.m_loops); 
     name = std::move(rhs.name);
 
     //Reset rhs
-    rhs.count = 0;
     rhs.index = 0;
     rhs.last_pseudo_registers = 0;
     rhs.last_float_pseudo_registers = 0;
@@ -68,20 +68,18 @@ mtac::Function& mtac::Function::operator=(mtac::Function&& rhs){
 }
 
 mtac::Function::~Function(){
-    auto block = exit;
-
-    while(block){
-        auto next = block->prev;
-
-        block->next = nullptr;
-        block->prev = nullptr;
-        block->successors.clear();
-        block->predecessors.clear();
-        block->dominator = nullptr;
-        block->statements.clear();
-        block->l_statements.clear();
+    if(!pool){
+        return;
+    }
 
-        block = next;
+    //The statements can refer to other blocks
+    for(std::size_t id = 0; id < bb_ids(); ++id){
+        if(auto& block = (*pool)[id]){
+            block->successors.clear();
+            block->predecessors.clear();
+            block->statements.clear();
+            block->l_statements.clear();
+        }
     }
 }
 
@@ -106,73 +104,72 @@ bool mtac::Function::standard() const {
 }
 
 mtac::Quadruple& mtac::Function::find(std::size_t uid){
-    for(auto& block : *this){
-        for(auto& quadruple : block){
-            if(quadruple.uid() == uid){
-                return quadruple;
+    auto position = pool->find(uid);
+
+    if(position){
+        if(auto& block = (*pool)[position->first]){
+            auto it = block->statements.find(uid);
+
+            if(it != block->statements.end()){
+                return *it;
             }
         }
     }
 
+    //The statement has been assigned through a reference and has never been indexed, look for it in each block
+    for(auto& block : *this){
+        auto it = block->statements.find(uid);
+
+        if(it != block->statements.end()){
+            return *it;
+        }
+    }
+
     cpp_unreachable("The given uid does not exist");
 }
 
 mtac::basic_block_iterator mtac::Function::at(std::shared_ptr<basic_block> bb){
-    if(bb){
-        return basic_block_iterator(bb, bb->prev);
-    } else {
-        return basic_block_iterator(nullptr, nullptr);
-    }
+    return basic_block_iterator(pool.get(), bb);
 }
         
 mtac::basic_block_p mtac::Function::entry_bb(){
-    return entry;
+    return pool->at(0);
 }
 
 mtac::basic_block_p mtac::Function::exit_bb(){
-    return exit;
+    return pool->at(pool->size() - 1);
 }
 
 mtac::basic_block_p mtac::Function::current_bb(){
-    return exit;
+    return exit_bb();
 }
         
 void mtac::Function::create_entry_bb(){
-    ++count;
-
-    auto new_block = std::make_shared<mtac::basic_block>(-1);
+    auto new_block = std::make_shared<mtac::basic_block>(-1, *pool);
     new_block->context = context;
 
-    entry = exit = new_block;
+    pool->add(new_block);
+    pool->insert(0, new_block);
 }
 
 void mtac::Function::create_exit_bb(){
-    ++count;
-
-    auto new_block = std::make_shared<mtac::basic_block>(-2);
+    auto new_block = std::make_shared<mtac::basic_block>(-2, *pool);
     new_block->context = context;
-    
-    exit->next = new_block;
-    new_block->prev = exit;
 
-    exit = new_block;
+    pool->add(new_block);
+    pool->insert(pool->size(), new_block);
 }
 
 mtac::basic_block_p mtac::Function::new_bb(){
-    auto bb = std::make_shared<mtac::basic_block>(++index);
+    auto bb = std::make_shared<mtac::basic_block>(++index, *pool);
     bb->context = context;
+    pool->add(bb);
     return bb;
 }
 
 mtac::basic_block_p mtac::Function::append_bb(){
     auto new_block = new_bb();
-    ++count;
-    
-    exit->next = new_block;
-    new_block->prev = exit;
-
-    exit = new_block;
-
+    pool->insert(pool->size(), new_block);
     return new_block;
 }   
         
@@ -183,13 +180,8 @@ mtac::basic_block_iterator mtac::Function::insert_before(mtac::basic_block_itera
     cpp_assert(it != begin(), "Cannot add before entry");
 
     block->context = context;
-    
-    ++count;
 
-    block->prev = bb->prev;
-    block->next = bb;
-    bb->prev->next = block;
-    bb->prev = block;
+    pool->insert(bb ? position(bb) : pool->size(), block);
     
     return at(block);
 }
@@ -200,47 +192,30 @@ mtac::basic_block_iterator mtac::Function::insert_after(mtac::basic_block_iterat
 
 mtac::basic_block_iterator mtac::Function::remove(mtac::basic_block_p block){
     cpp_assert(block, "Cannot remove null block"); 
-    cpp_assert(block != exit, "Cannot remove exit"); 
+    cpp_assert(block != exit_bb(), "Cannot remove exit"); 
 
     LOG<Debug>("CFG") << "Remove basic block B" << block->index << log::endl;
 
-    auto& next = block->next;
-
-    --count;
+    auto prev = block->prev();
+    auto next = block->next();
 
     for(auto& succ : block->successors){
-        auto& pred = succ->predecessors;
-        
-        pred.erase(std::remove_if(pred.begin(), pred.end(), [&block](auto& p){
-            return p == block;
-        }), pred.end());
+        succ->predecessors.remove(block);
     }
     
     for(auto& pred : block->predecessors){
-        auto& succ = pred->successors;
-        
-        succ.erase(std::remove_if(succ.begin(), succ.end(), [&block](auto& p){
-            return p == block;
-        }), succ.end());
+        pred->successors.remove(block);
 
         //If there is a Fall through edge, redirect it
-        if(pred == block->prev){
-            mtac::make_edge(pred, block->next);
+        if(pred == prev){
+            mtac::make_edge(pred, next);
         }
     }
 
-    //Relink the list
-    block->prev->next = next;
-    next->prev = block->prev;
-
-    //Make sure the removed block do not hold any more references to other blocks
-    block->prev = nullptr;
-    block->next = nullptr;
-    block->dominator = nullptr;
-    block->successors.clear();
-    block->predecessors.clear();
+    //Release the block from the pool, it does not hold any more references to other blocks
     block->statements.clear();
     block->l_statements.clear();
+    pool->release(block);
 
     return at(next);
 }
@@ -252,14 +227,16 @@ mtac::basic_block_iterator mtac::Function::remove(mtac::basic_block_iterator it)
 mtac::basic_block_iterator mtac::Function::merge_basic_blocks(basic_block_iterator it, std::shared_ptr<basic_block> block){
     auto source = *it; 
 
-    cpp_assert(source->next == block || source->prev == block, "Can only merge sibling blocks");
+    auto next = source->next();
+
+    cpp_assert(next == block || source->prev() == block, "Can only merge sibling blocks");
 
     LOG<Debug>("CFG") << "Merge " << source->index << " into " << block->index << log::endl;
 
     if(!source->statements.empty()){
         //B can have some new successors
         for(auto& succ : source->successors){
-            if(succ != source->next){
+            if(succ != next){
                 mtac::make_edge(block, succ);
             }
         }
@@ -268,7 +245,7 @@ mtac::basic_block_iterator mtac::Function::merge_basic_blocks(basic_block_iterat
     }
 
     //Insert the statements
-    if(source->next == block){
+    if(next == block){
         std::move(block->begin(), block->end(), std::back_inserter(source->statements));
         block->statements = std::move(source->statements);
     } else {
@@ -307,7 +284,12 @@ void mtac::Function::release_statements(){
 }
 
 std::size_t mtac::Function::bb_count() const {
-    return count;
+    return pool->size();
+}
+
+std::size_t mtac::Function::bb_ids() const {
+    //The exit and the entry blocks take the first two ids
+    return index + 3;
 }
 
 const std::set<ltac::Register>& mtac::Function::use_registers() const {
@@ -342,6 +324,26 @@ void mtac::Function::variable_use(ltac::FloatRegister reg){
     _variable_float_registers.insert(reg);
 }
 
+const std::set<ltac::Register>& mtac::Function::clobbered_registers() const {
+    return _clobbered_registers;
+}
+
+const std::set<ltac::FloatRegister>& mtac::Function::clobbered_float_registers() const {
+    return _clobbered_float_registers;
+}
+
+bool mtac::Function::clobber(ltac::Register reg){
+    return _clobbered_registers.insert(reg).second;
+}
+
+bool mtac::Function::clobber(ltac::FloatRegister reg){
+    return _clobbered_float_registers.insert(reg).second;
+}
+
+std::unordered_map<std::shared_ptr<Variable>, mtac::basic_block_p>& mtac::Function::clear_points(){
+    return _clear_points;
+}
+
 std::size_t mtac::Function::pseudo_registers() const {
     return last_pseudo_registers;
 }
@@ -387,20 +389,15 @@ std::vector<mtac::loop>& mtac::Function::loops(){
 }
 
 std::size_t mtac::Function::position(const basic_block_p& bb) const {
-    std::size_t position = 0;
+    auto position = pool->position(bb->id());
 
-    auto it = begin();
+    cpp_assert(position != block_pool::npos && pool->at(position) == bb, "This basic block is not part of the function");
 
-    while(it != end()){
-        if(*it == bb){
-            return position;
-        }
-        
-        ++position;
-        ++it;
-    }
+    return position;
+}
 
-    cpp_unreachable("This basic block is not part of the function");
+void mtac::Function::reorder(const std::vector<basic_block_p>& order){
+    pool->relayout(order);
 }
 
 bool mtac::operator==(const mtac::Function& lhs, const mtac::Function& rhs){
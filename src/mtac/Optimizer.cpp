@@ -44,13 +44,19 @@
 #include "mtac/loop_analysis.hpp"
 #include "mtac/induction_variable_optimizations.hpp"
 #include "mtac/loop_unrolling.hpp"
+#include "mtac/loop_idioms.hpp"
 #include "mtac/loop_unswitching.hpp"
 #include "mtac/complete_loop_peeling.hpp"
 #include "mtac/remove_empty_loops.hpp"
 #include "mtac/loop_invariant_code_motion.hpp"
 #include "mtac/parameter_propagation.hpp"
+#include "mtac/function_specialization.hpp"
 #include "mtac/pure_analysis.hpp"
-#include "mtac/local_cse.hpp"
+#include "mtac/global_value_numbering.hpp"
+#include "mtac/lazy_code_motion.hpp"
+#include "mtac/partial_dead_code_elimination.hpp"
+#include "mtac/block_layout.hpp"
+#include "mtac/tail_recursion.hpp"
 
 //The optimization visitors
 #include "mtac/ArithmeticIdentities.hpp"
@@ -63,7 +69,7 @@
 #include "mtac/GlobalOptimizations.hpp"
 #include "mtac/global_cp.hpp"
 #include "mtac/global_offset_cp.hpp"
-#include "mtac/global_cse.hpp"
+#include "mtac/dead_store_elimination.hpp"
 
 #include "ltac/Register.hpp"
 #include "ltac/FloatRegister.hpp"
@@ -99,16 +105,20 @@ typedef boost::mpl::vector<
         mtac::conditional_propagation*,
         mtac::ConstantPropagationProblem*,
         mtac::OffsetConstantPropagationProblem*,
-        mtac::local_cse*,
-        mtac::global_cse*,
+        mtac::global_value_numbering*,
+        mtac::lazy_code_motion*,
         mtac::PointerPropagation*,
         mtac::MathPropagation*,
         mtac::optimize_branches*,
         mtac::remove_dead_basic_blocks*,
         mtac::merge_basic_blocks*,
         mtac::dead_code_elimination*,
+        mtac::dead_store_elimination*,
+        mtac::partial_dead_code_elimination*,
         mtac::remove_aliases*,
+        mtac::tail_recursion*,
         mtac::loop_analysis*,
+        mtac::loop_idioms*,
         mtac::loop_invariant_code_motion*,
         mtac::loop_induction_variables_optimization*,
         mtac::remove_empty_loops*,
@@ -157,9 +167,14 @@ typedef boost::mpl::vector<
         mtac::remove_empty_functions*,
         mtac::inline_functions*,
         mtac::remove_unused_functions*,
-        mtac::parameter_propagation*
+        mtac::parameter_propagation*,
+        mtac::specialize_functions*
     > ipa_passes;
 
+typedef boost::mpl::vector<
+        mtac::block_layout*
+    > layout_passes;
+
 template<typename Pass>
 struct need_pool {
     static const bool value = mtac::pass_traits<Pass>::property_flags & mtac::PROPERTY_POOL;
@@ -405,6 +420,9 @@ void mtac::Optimizer::optimize(mtac::Program& program, std::shared_ptr<StringPoo
             runner.optimized = false;
             boost::mpl::for_each<ipa_passes>(boost::ref(runner));
         } while(runner.optimized);
+
+        //The blocks are placed once the control flow graph does not change anymore
+        boost::mpl::for_each<layout_passes>(boost::ref(runner));
     } else {
         //Even if global optimizations are disabled, perform basic optimization (only constant folding)
         pass_runner runner(program, string_pool, configuration, platform, program.context->timing());
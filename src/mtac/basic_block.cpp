@@ -11,16 +11,50 @@
 
 using namespace eddic;
 
-mtac::basic_block::basic_block(int i) : index(i), label("") {}
-        
-mtac::Quadruple& mtac::basic_block::find(std::size_t uid){
-    for(auto& quadruple : statements){
-        if(quadruple.uid() == uid){
-            return quadruple;
+mtac::basic_block::basic_block(int i, block_pool& pool) : index(i), label(""), statements(&pool, i + 2), successors(&pool), predecessors(&pool), pool(&pool) {}
+
+mtac::basic_block_p mtac::basic_block::next() const {
+    if(pool){
+        auto position = pool->position(id());
+
+        if(position != block_pool::npos){
+            return pool->at(position + 1);
+        }
+    }
+
+    return nullptr;
+}
+
+mtac::basic_block_p mtac::basic_block::prev() const {
+    if(pool){
+        auto position = pool->position(id());
+
+        if(position != block_pool::npos && position > 0){
+            return pool->at(position - 1);
         }
     }
 
-    cpp_unreachable("The uid should exists");
+    return nullptr;
+}
+
+mtac::basic_block_p mtac::basic_block::dominator() const {
+    if(pool && dominator_id != block_pool::npos){
+        return (*pool)[dominator_id];
+    }
+
+    return nullptr;
+}
+
+void mtac::basic_block::set_dominator(const mtac::basic_block_p& dominator){
+    dominator_id = dominator ? dominator->id() : block_pool::npos;
+}
+        
+mtac::Quadruple& mtac::basic_block::find(std::size_t uid){
+    auto it = statements.find(uid);
+
+    cpp_assert(it != statements.end(), "The uid should exists");
+
+    return *it;
 }
 
 std::size_t mtac::basic_block::size() const {
@@ -65,7 +99,7 @@ mtac::basic_block::iterator mtac::end(mtac::basic_block_p block){
     return block->end(); 
 }
     
-void pretty_print(std::vector<mtac::basic_block_p> blocks, std::ostream& stream){
+void pretty_print(const mtac::block_list& blocks, std::ostream& stream){
     if(blocks.empty()){
         stream << "{}";
     } else {
@@ -88,6 +122,7 @@ mtac::basic_block_p mtac::clone(mtac::Function& function, mtac::basic_block_p bl
 
     //Copy all the statements
     new_bb->statements = block->statements;
+    new_bb->frequency = block->frequency;
     
     return new_bb;
 }
@@ -98,7 +133,7 @@ void mtac::pretty_print(std::shared_ptr<const mtac::basic_block> block, std::ost
     stream << sep << std::endl;
     stream << *block;
 
-    stream << " prev: " << block->prev << ", next: " << block->next << ", dom: " << block->dominator << std::endl;
+    stream << " prev: " << block->prev() << ", next: " << block->next() << ", dom: " << block->dominator() << std::endl;
     stream << "successors "; ::pretty_print(block->successors, stream); stream << std::endl;;
     stream << "predecessors "; ::pretty_print(block->predecessors, stream); stream << std::endl;;
 
@@ -0,0 +1,316 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "logging.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+
+#include "mtac/block_layout.hpp"
+#include "mtac/profile.hpp"
+#include "mtac/Program.hpp"
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/Quadruple.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//The statement ending the block, NOPs excluded
+mtac::Quadruple* terminator(const mtac::basic_block_p& bb){
+    for(auto it = bb->statements.rbegin(); it != bb->statements.rend(); ++it){
+        if(it->op != mtac::Operator::NOP){
+            return &*it;
+        }
+    }
+
+    return nullptr;
+}
+
+bool is_branch(mtac::Quadruple* quadruple){
+    return quadruple && (quadruple->is_if() || quadruple->is_if_false());
+}
+
+bool is_jump(mtac::Quadruple* quadruple){
+    return quadruple && quadruple->op == mtac::Operator::GOTO;
+}
+
+bool is_return(mtac::Quadruple* quadruple){
+    return quadruple && quadruple->op == mtac::Operator::RETURN;
+}
+
+//The parameters of a call are compiled just before the call, the block cannot be separated from the call
+bool pending_parameters(const mtac::basic_block_p& bb){
+    bool pending = false;
+
+    for(auto& quadruple : bb->statements){
+        if(quadruple.op == mtac::Operator::PARAM || quadruple.op == mtac::Operator::PPARAM){
+            pending = true;
+        } else if(quadruple.op == mtac::Operator::CALL){
+            pending = false;
+        }
+    }
+
+    return pending;
+}
+
+//IF_X and IF_FALSE_X test the same condition, the two groups of operators are in the same order
+void invert(mtac::Quadruple& quadruple){
+    auto distance = static_cast<unsigned int>(mtac::Operator::IF_FALSE_UNARY) - static_cast<unsigned int>(mtac::Operator::IF_UNARY);
+
+    if(quadruple.is_if()){
+        quadruple.op = static_cast<mtac::Operator>(static_cast<unsigned int>(quadruple.op) + distance);
+    } else {
+        quadruple.op = static_cast<mtac::Operator>(static_cast<unsigned int>(quadruple.op) - distance);
+    }
+}
+
+mtac::Quadruple make_goto(mtac::basic_block_p target){
+    mtac::Quadruple goto_(target->label, mtac::Operator::GOTO);
+    goto_.block = target;
+    return goto_;
+}
+
+double depth_weight(unsigned int depth){
+    double weight = 1.0;
+
+    while(depth > 0){
+        weight *= 10.0;
+
+        --depth;
+    }
+
+    return weight;
+}
+
+//Estimation of the number of times the edge is taken
+double edge_weight(const mtac::Program& program, const mtac::basic_block_p& bb, const mtac::basic_block_p& succ, bool conditional){
+    //Only the blocks are counted, an edge is not taken more often than its ends are executed
+    if(program.profiled){
+        return static_cast<double>(std::min(bb->frequency, succ->frequency));
+    }
+
+    auto weight = depth_weight(bb->depth);
+
+    if(conditional){
+        //Leaving a loop is unlikely, entering a loop is likely
+        if(succ->depth < bb->depth){
+            weight *= 0.2;
+        } else if(succ->depth > bb->depth){
+            weight *= 0.8;
+        } else {
+            weight *= 0.5;
+        }
+    }
+
+    return weight;
+}
+
+typedef std::unordered_map<mtac::basic_block_p, mtac::basic_block_p> Successors;
+
+std::vector<mtac::basic_block_p> chains(mtac::Program& program, std::vector<mtac::basic_block_p>& blocks, Successors& fall_through, mtac::basic_block_p exit){
+    std::unordered_set<mtac::basic_block_p> placed;
+    std::vector<mtac::basic_block_p> order;
+
+    //The entry always falls through the first block
+    auto current = blocks.front();
+
+    while(current){
+        order.push_back(current);
+        placed.insert(current);
+
+        mtac::basic_block_p next = nullptr;
+
+        auto it = fall_through.find(current);
+
+        if(pending_parameters(current)){
+            if(it != fall_through.end() && !placed.count(it->second)){
+                next = it->second;
+            }
+        } else {
+            bool conditional = is_branch(terminator(current));
+            double best = -1.0;
+
+            for(auto& succ : current->successors){
+                //A hot chain is not continued in a cold block
+                if(succ == exit || placed.count(succ) || (mtac::cold(program, succ) && !mtac::cold(program, current))){
+                    continue;
+                }
+
+                auto weight = edge_weight(program, current, succ, conditional);
+
+                //On equal weights, the current fall through is kept
+                bool original = it != fall_through.end() && it->second == succ;
+
+                if(weight > best || (weight == best && original)){
+                    best = weight;
+                    next = succ;
+                }
+            }
+        }
+
+        //Start a new chain with the first remaining block, the cold blocks are sunk at the end
+        if(!next){
+            for(auto& bb : blocks){
+                if(!placed.count(bb) && !mtac::cold(program, bb)){
+                    next = bb;
+                    break;
+                }
+            }
+        }
+
+        if(!next){
+            for(auto& bb : blocks){
+                if(!placed.count(bb)){
+                    next = bb;
+                    break;
+                }
+            }
+        }
+
+        current = next;
+    }
+
+    return order;
+}
+
+//Make sure that the block still goes to target when it does not fall through it anymore
+void fix_fall_through(mtac::Function& function, mtac::basic_block_p bb, mtac::basic_block_p target){
+    auto quadruple = terminator(bb);
+
+    if(!is_branch(quadruple)){
+        bb->statements.push_back(make_goto(target));
+    } else if(quadruple->block == bb->next()){
+        invert(*quadruple);
+        quadruple->block = target;
+    } else if(quadruple->block == target){
+        //Both edges go to the same block, the condition is useless
+        *quadruple = make_goto(target);
+    } else {
+        auto jump = function.new_bb();
+        jump->depth = bb->depth;
+        jump->frequency = std::min(bb->frequency, target->frequency);
+        jump->statements.push_back(make_goto(target));
+
+        function.insert_after(function.at(bb), jump);
+
+        mtac::remove_edge(bb, target);
+        mtac::make_edge(bb, jump);
+        mtac::make_edge(jump, target);
+    }
+}
+
+bool layout(mtac::Program& program, mtac::Function& function){
+    auto entry = function.entry_bb();
+    auto exit = function.exit_bb();
+
+    std::vector<mtac::basic_block_p> blocks;
+    for(auto& bb : function){
+        if(bb != entry && bb != exit){
+            blocks.push_back(bb);
+        }
+    }
+
+    if(blocks.size() < 3){
+        return false;
+    }
+
+    //Remember the fall through of each block before moving them
+    Successors fall_through;
+    Successors after_return;
+
+    for(auto& bb : blocks){
+        auto quadruple = terminator(bb);
+
+        if(is_return(quadruple)){
+            after_return[bb] = bb->next();
+        } else if(!is_jump(quadruple)){
+            fall_through[bb] = bb->next();
+        }
+    }
+
+    auto order = chains(program, blocks, fall_through, exit);
+
+    if(order == blocks){
+        return false;
+    }
+
+    //The parameters must stay just before their call
+    for(std::size_t i = 0; i < order.size(); ++i){
+        if(pending_parameters(order[i]) && (i + 1 == order.size() || order[i + 1] != fall_through[order[i]])){
+            return false;
+        }
+    }
+
+    //Lay out the blocks in their new order
+
+    std::vector<mtac::basic_block_p> layout;
+    layout.reserve(order.size() + 2);
+
+    layout.push_back(entry);
+    layout.insert(layout.end(), order.begin(), order.end());
+    layout.push_back(exit);
+
+    function.reorder(layout);
+
+    //Restore the semantics of the blocks that do not fall through the same block anymore
+
+    for(auto& bb : order){
+        auto next = bb->next();
+        auto quadruple = terminator(bb);
+
+        if(is_jump(quadruple)){
+            if(quadruple->block == next){
+                mtac::transform_to_nop(*quadruple);
+            }
+        } else if(is_return(quadruple)){
+            //The block does not really go to its next block but to the exit
+            auto old_next = after_return[bb];
+
+            if(old_next != next && old_next != exit){
+                mtac::remove_edge(bb, old_next);
+
+                if(!bb->successors.contains(exit)){
+                    mtac::make_edge(bb, exit);
+                }
+            }
+        } else {
+            auto target = fall_through[bb];
+
+            if(target != next){
+                fix_fall_through(function, bb, target);
+            }
+        }
+    }
+
+    return true;
+}
+
+} //end of anonymous namespace
+
+bool mtac::block_layout::gate(std::shared_ptr<Configuration> configuration){
+    return configuration->option_defined("fblock-layout");
+}
+
+bool mtac::block_layout::operator()(mtac::Program& program){
+    bool optimized = false;
+
+    for(auto& function : program.functions){
+        if(layout(program, function)){
+            LOG<Trace>("Layout") << "Reordered the basic blocks of " << function.get_name() << log::endl;
+            program.context->stats().inc_counter("functions_reordered");
+
+            optimized = true;
+        }
+    }
+
+    return optimized;
+}
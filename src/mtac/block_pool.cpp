@@ -0,0 +1,125 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "cpp_utils/assert.hpp"
+
+#include "mtac/block_pool.hpp"
+#include "mtac/basic_block.hpp"
+
+using namespace eddic;
+
+const std::size_t mtac::block_pool::npos;
+const mtac::basic_block_p mtac::block_pool::null_block;
+
+mtac::block_pool::~block_pool(){
+    //The blocks can outlive their function
+    for(auto& block : blocks){
+        if(block){
+            block->pool = nullptr;
+            block->statements.pool = nullptr;
+        }
+    }
+}
+
+void mtac::block_pool::add(const basic_block_p& block){
+    auto id = block->id();
+
+    if(id >= blocks.size()){
+        blocks.resize(id + 1);
+        positions.resize(id + 1, npos);
+    }
+
+    cpp_assert(!blocks[id], "There is already a block with this id");
+
+    blocks[id] = block;
+}
+
+void mtac::block_pool::insert(std::size_t position, const basic_block_p& block){
+    auto id = block->id();
+
+    cpp_assert(id < blocks.size() && blocks[id] == block, "The block is not part of the pool");
+    cpp_assert(positions[id] == npos, "The block is already part of the layout");
+    cpp_assert(position <= layout.size(), "Invalid position");
+
+    layout.insert(layout.begin() + position, id);
+
+    renumber(position);
+}
+
+void mtac::block_pool::release(const basic_block_p& block){
+    auto id = block->id();
+
+    cpp_assert(id < blocks.size() && blocks[id] == block, "The block is not part of the pool");
+
+    auto position = positions[id];
+
+    if(position != npos){
+        layout.erase(layout.begin() + position);
+        positions[id] = npos;
+
+        renumber(position);
+    }
+
+    block->pool = nullptr;
+    block->statements.pool = nullptr;
+    block->dominator_id = npos;
+    block->successors.clear();
+    block->predecessors.clear();
+
+    blocks[id] = nullptr;
+}
+
+void mtac::block_pool::relayout(const std::vector<basic_block_p>& order){
+    cpp_assert(order.size() == layout.size(), "The new layout must contain all the blocks");
+
+    for(auto id : layout){
+        positions[id] = npos;
+    }
+
+    for(std::size_t i = 0; i < order.size(); ++i){
+        auto id = order[i]->id();
+
+        cpp_assert(positions[id] == npos, "A block cannot appear twice in the layout");
+
+        layout[i] = id;
+        positions[id] = i;
+    }
+}
+
+void mtac::block_pool::renumber(std::size_t first){
+    for(std::size_t i = first; i < layout.size(); ++i){
+        positions[layout[i]] = i;
+    }
+}
+
+void mtac::block_list::push_back(const basic_block_p& block){
+    cpp_assert((*pool)[block->id()] == block, "The block is not part of the same function");
+
+    ids.push_back(block->id());
+}
+
+void mtac::block_list::set(std::size_t i, const basic_block_p& block){
+    cpp_assert((*pool)[block->id()] == block, "The block is not part of the same function");
+
+    ids[i] = block->id();
+}
+
+void mtac::block_list::replace(const basic_block_p& block, const basic_block_p& replacement){
+    cpp_assert((*pool)[replacement->id()] == replacement, "The block is not part of the same function");
+
+    std::replace(ids.begin(), ids.end(), block->id(), replacement->id());
+}
+
+void mtac::block_list::remove(const basic_block_p& block){
+    ids.erase(std::remove(ids.begin(), ids.end(), block->id()), ids.end());
+}
+
+bool mtac::block_list::contains(const basic_block_p& block) const {
+    return std::find(ids.begin(), ids.end(), block->id()) != ids.end();
+}
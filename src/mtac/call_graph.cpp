@@ -5,6 +5,10 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+
 #include "cpp_utils/assert.hpp"
 
 #include "Function.hpp"
@@ -124,10 +128,13 @@ void mtac::build_call_graph(mtac::Program& program){
     }
 }
 
-void post_dfs_visit(mtac::call_graph_node_p& node, std::vector<std::reference_wrapper<eddic::Function>>& order){
+void post_dfs_visit(mtac::call_graph_node_p& node, std::vector<std::reference_wrapper<eddic::Function>>& order, std::unordered_set<mtac::call_graph_node_p>& visited){
+    //Each function is visited once, even in a cycle of recursive functions
+    visited.insert(node);
+
     for(auto& edge : node->out_edges){
-        if(edge->target->function != node->function){
-            post_dfs_visit(edge->target, order);
+        if(!visited.count(edge->target)){
+            post_dfs_visit(edge->target, order, visited);
         }
     }
 
@@ -136,8 +143,70 @@ void post_dfs_visit(mtac::call_graph_node_p& node, std::vector<std::reference_wr
 
 std::vector<std::reference_wrapper<eddic::Function>> mtac::call_graph::topological_order(){
     std::vector<std::reference_wrapper<eddic::Function>> order;
+    std::unordered_set<mtac::call_graph_node_p> visited;
 
-    post_dfs_visit(entry, order);
+    post_dfs_visit(entry, order, visited);
 
     return order;
 }
+
+namespace {
+
+struct tarjan_state {
+    std::size_t index = 0;
+    std::unordered_map<mtac::call_graph_node_p, std::size_t> indices;
+    std::unordered_map<mtac::call_graph_node_p, std::size_t> low_links;
+    std::vector<mtac::call_graph_node_p> stack;
+    std::unordered_set<mtac::call_graph_node_p> on_stack;
+    std::vector<std::vector<std::reference_wrapper<eddic::Function>>> components;
+};
+
+void strong_connect(const mtac::call_graph_node_p& node, tarjan_state& state){
+    state.indices[node] = state.low_links[node] = state.index++;
+    state.stack.push_back(node);
+    state.on_stack.insert(node);
+
+    for(auto& edge : node->out_edges){
+        //The edges without calls anymore do not count
+        if(!edge->count){
+            continue;
+        }
+
+        auto& target = edge->target;
+
+        if(!state.indices.count(target)){
+            strong_connect(target, state);
+            state.low_links[node] = std::min(state.low_links[node], state.low_links[target]);
+        } else if(state.on_stack.count(target)){
+            state.low_links[node] = std::min(state.low_links[node], state.indices[target]);
+        }
+    }
+
+    //The node is the root of a component
+    if(state.low_links[node] == state.indices[node]){
+        std::vector<std::reference_wrapper<eddic::Function>> component;
+
+        mtac::call_graph_node_p member;
+        do {
+            member = state.stack.back();
+            state.stack.pop_back();
+            state.on_stack.erase(member);
+
+            component.push_back(member->function);
+        } while(member != node);
+
+        state.components.push_back(std::move(component));
+    }
+}
+
+} //end of anonymous namespace
+
+std::vector<std::vector<std::reference_wrapper<eddic::Function>>> mtac::call_graph::strongly_connected_components(){
+    cpp_assert(entry, "The call graph must be built before computing the components");
+
+    tarjan_state state;
+
+    strong_connect(entry, state);
+
+    return std::move(state.components);
+}
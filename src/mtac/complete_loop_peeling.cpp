@@ -103,17 +103,21 @@ void peel(mtac::loop& loop, mtac::Function& function, mtac::Program& program){
         //Adapt the CFG
 
         for(auto& clone : local_cloned){
-            for(auto& succ : clone->successors){
+            for(std::size_t j = 0; j < clone->successors.size(); ++j){
+                auto succ = clone->successors[j];
+
                 if(bb_clones.find(succ) != bb_clones.end()){
-                    succ = bb_clones[succ];
+                    clone->successors.set(j, bb_clones[succ]);
                 } else if(succ == next_bb){
-                    succ = entry;
+                    clone->successors.set(j, entry);
                 }
             }
 
-            for(auto& pred : clone->predecessors){
+            for(std::size_t j = 0; j < clone->predecessors.size(); ++j){
+                auto pred = clone->predecessors[j];
+
                 if(bb_clones.find(pred) != bb_clones.end()){
-                    pred = bb_clones[pred];
+                    clone->predecessors.set(j, bb_clones[pred]);
                 }
             }
 
@@ -126,25 +130,17 @@ void peel(mtac::loop& loop, mtac::Function& function, mtac::Program& program){
         }
 
         if(entry != real_entry){
-            for(auto& pred : entry->predecessors){
-                if(pred == preheader){
-                    pred = bb_clones[exit];
-                }
-            }
+            entry->predecessors.replace(preheader, bb_clones[exit]);
         }
 
         entry = bb_clones[real_entry];
 
         if(i == iterations -1){
-            preheader->successors.front() = entry;
+            preheader->successors.set(0, entry);
         }
     }
 
-    for(auto& pred : real_entry->predecessors){
-        if(pred == preheader){
-            pred = real_entry->prev;
-        }
-    }
+    real_entry->predecessors.replace(preheader, real_entry->prev());
 }
 
 }
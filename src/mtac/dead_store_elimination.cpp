@@ -0,0 +1,220 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#define BOOST_NO_RTTI
+#define BOOST_NO_TYPEID
+#include <boost/range/adaptors.hpp>
+
+#include "Variable.hpp"
+#include "FunctionContext.hpp"
+#include "GlobalContext.hpp"
+#include "Type.hpp"
+#include "logging.hpp"
+
+#include "mtac/dead_store_elimination.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/Quadruple.hpp"
+
+using namespace eddic;
+
+typedef mtac::dead_store_elimination::ProblemDomain ProblemDomain;
+
+namespace {
+
+bool is_store(mtac::Operator op){
+    return op == mtac::Operator::DOT_ASSIGN || op == mtac::Operator::DOT_FASSIGN || op == mtac::Operator::DOT_PASSIGN;
+}
+
+bool is_load(mtac::Operator op){
+    return op == mtac::Operator::DOT || op == mtac::Operator::FDOT || op == mtac::Operator::PDOT;
+}
+
+void kill(ProblemDomain& in, const std::shared_ptr<Variable>& variable){
+    auto& values = in.values();
+
+    auto it = values.begin();
+    while(it != values.end()){
+        if(it->variable == variable){
+            it = values.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void kill(ProblemDomain& in, const boost::optional<mtac::Argument>& arg){
+    if(arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*arg)){
+            kill(in, *ptr);
+        }
+    }
+}
+
+} //end of anonymous namespace
+
+ProblemDomain mtac::dead_store_elimination::Boundary(mtac::Function& function){
+    auto escaped = mtac::escape_analysis(function);
+
+    candidates.clear();
+
+    for(auto& block : function){
+        for(auto& quadruple : block->statements){
+            if(is_store(quadruple.op)){
+                auto& variable = quadruple.result;
+                auto type = variable->type();
+
+                if(variable->is_reference() || variable->position().isGlobal() || variable->position().isParameter()){
+                    continue;
+                }
+
+                if(type->is_pointer() || type->is_dynamic_array() || !(type->is_array() || type->is_custom_type() || type->is_template_type())){
+                    continue;
+                }
+
+                if(escaped->find(variable) == escaped->end()){
+                    candidates.insert(variable);
+                }
+            }
+        }
+    }
+
+    //Arrays are not considered as escaped after being passed in parameters
+    for(auto& block : function){
+        for(auto& quadruple : block->statements){
+            if(quadruple.op == mtac::Operator::PARAM || quadruple.op == mtac::Operator::PPARAM){
+                if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple.arg1)){
+                    candidates.erase(*ptr);
+                }
+            }
+        }
+    }
+
+    //Nothing is known to be overwritten after the end of the function
+    return ProblemDomain(ProblemDomain::Values());
+}
+
+ProblemDomain mtac::dead_store_elimination::Init(mtac::Function& /*function*/){
+    return ProblemDomain();
+}
+
+void mtac::dead_store_elimination::meet(ProblemDomain& in, const ProblemDomain& out){
+    if(in.top()){
+        in = out;
+    } else if(out.top()){
+        //in does not change
+    } else {
+        auto& values = in.values();
+
+        auto it = values.begin();
+        while(it != values.end()){
+            if(out.values().find(*it) == out.values().end()){
+                it = values.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void mtac::dead_store_elimination::transfer(mtac::basic_block_p basic_block, ProblemDomain& in){
+    for(auto& quadruple : boost::adaptors::reverse(basic_block->statements)){
+        transfer(quadruple, in);
+    }
+}
+
+void mtac::dead_store_elimination::transfer(mtac::Quadruple& quadruple, ProblemDomain& in){
+    //Without a path to the exit, nothing is known
+    if(in.top()){
+        in = ProblemDomain(ProblemDomain::Values());
+    }
+
+    if(quadruple.op == mtac::Operator::NOP){
+        return;
+    }
+
+    if(is_store(quadruple.op)){
+        //The smaller stores do not overwrite a complete value
+        if(candidates.count(quadruple.result) && quadruple.size == tac::Size::DEFAULT){
+            if(auto* ptr = boost::get<int>(&*quadruple.arg1)){
+                in.values().insert({quadruple.result, *ptr});
+            } else {
+                kill(in, quadruple.arg1);
+            }
+        } else {
+            kill(in, quadruple.arg1);
+        }
+
+        kill(in, quadruple.arg2);
+
+        return;
+    }
+
+    if(is_load(quadruple.op)){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple.arg1)){
+            if(auto* offset_ptr = boost::get<int>(&*quadruple.arg2)){
+                in.values().erase({*ptr, *offset_ptr});
+            } else {
+                kill(in, *ptr);
+                kill(in, quadruple.arg2);
+            }
+        }
+
+        return;
+    }
+
+    //Any other use reads the whole aggregate
+    if(quadruple.result && !mtac::erase_result(quadruple.op)){
+        kill(in, quadruple.result);
+    }
+
+    kill(in, quadruple.arg1);
+    kill(in, quadruple.arg2);
+}
+
+bool mtac::dead_store_elimination::optimize(mtac::Function& function, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> results){
+    bool optimized = false;
+
+    for(auto& block : function){
+        auto out = results->OUT[block];
+
+        for(auto& quadruple : boost::adaptors::reverse(block->statements)){
+            if(is_store(quadruple.op) && !out.top() && candidates.count(quadruple.result)){
+                if(auto* ptr = boost::get<int>(&*quadruple.arg1)){
+                    if(out.values().count({quadruple.result, *ptr})){
+                        LOG<Trace>("Optimizer") << "Remove dead store " << quadruple << log::endl;
+
+                        //The overwriting store is still in the domain
+                        mtac::transform_to_nop(quadruple);
+
+                        function.context->global()->stats().inc_counter("dead_stores_eliminated");
+                        optimized = true;
+
+                        continue;
+                    }
+                }
+            }
+
+            transfer(quadruple, out);
+        }
+    }
+
+    return optimized;
+}
+
+bool mtac::operator==(const mtac::Domain<mtac::Stores>& lhs, const mtac::Domain<mtac::Stores>& rhs){
+    if(lhs.top() || rhs.top()){
+        return lhs.top() == rhs.top();
+    }
+
+    return lhs.values() == rhs.values();
+}
+
+bool mtac::operator!=(const mtac::Domain<mtac::Stores>& lhs, const mtac::Domain<mtac::Stores>& rhs){
+    return !(lhs == rhs);
+}
@@ -6,11 +6,11 @@
 //=======================================================================
 
 #include <vector>
-#include <unordered_map>
 
 #include "PerfsTimer.hpp"
 
 #include "mtac/basic_block.hpp"
+#include "mtac/block_map.hpp"
 #include "mtac/Function.hpp"
 #include "mtac/dominators.hpp"
 
@@ -35,12 +35,12 @@ struct dominators {
     std::vector<std::vector<unsigned int>> pred;
     std::vector<std::vector<unsigned int>> bucket;
 
-    std::unordered_map<mtac::basic_block_p, unsigned int> numbers;
-    std::unordered_map<unsigned int, mtac::basic_block_p> blocks;
+    mtac::block_map<unsigned int> numbers;
+    std::vector<mtac::basic_block_p> blocks;
 
     dominators(std::size_t cn, mtac::Function& function) : cn(cn), n(cn), function(function), 
             parent(cn+1), semi(cn+1), vertex(cn+1), dom(cn+1), size(cn+1), child(cn+1), label(cn+1), ancestor(cn+1),
-            succ(cn+1), pred(cn+1), bucket(cn+1) {
+            succ(cn+1), pred(cn+1), bucket(cn+1), numbers(function.bb_ids()), blocks(cn+1) {
 
         //Nothing to init
     }
@@ -195,10 +195,10 @@ struct dominators {
             ++number;
 
             if(number == 1){
-                block->dominator = nullptr;
+                block->set_dominator(nullptr);
             }
 
-            block->dominator = blocks[dom[number]]; 
+            block->set_dominator(blocks[dom[number]]); 
         }
     }
 };
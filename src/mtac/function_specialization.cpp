@@ -0,0 +1,441 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "logging.hpp"
+#include "Utils.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "Function.hpp"
+#include "FunctionContext.hpp"
+#include "GlobalContext.hpp"
+
+#include "mtac/function_specialization.hpp"
+#include "mtac/Program.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Quadruple.hpp"
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/VariableReplace.hpp"
+#include "mtac/profile.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//The smaller functions are left to the inliner
+const std::size_t MIN_SIZE = 12;
+
+//The larger functions would cost too much space to be copied
+const std::size_t MAX_SIZE = 300;
+
+//Maximum number of copies of the same function
+const unsigned int MAX_SPECIALIZATIONS = 4;
+
+typedef std::unordered_set<std::shared_ptr<Variable>> Variables;
+typedef std::vector<std::pair<std::shared_ptr<Variable>, int>> Constants;
+
+struct CallSite {
+    eddic::Function* caller;
+    mtac::basic_block_p block;
+    std::size_t uid;
+};
+
+struct Specialization {
+    eddic::Function* target;
+    Constants constants;
+    std::vector<CallSite> sites;
+    std::size_t frequency = 0;
+};
+
+//Each parameter must be passed by a single PARAM
+bool single_param(const std::shared_ptr<const Type>& type){
+    return (type->is_standard_type() && type != STRING) || type->is_pointer();
+}
+
+bool can_be_specialized(mtac::Function& function){
+    if(function.is_main() || function.definition().parameters().empty()){
+        return false;
+    }
+
+    for(auto& param : function.definition().parameters()){
+        if(!single_param(param.type())){
+            return false;
+        }
+    }
+
+    //The recursive calls of the copy would still go to the original function
+    return !mtac::is_recursive(function);
+}
+
+bool hot_site(mtac::Program& program, const mtac::basic_block_p& block){
+    if(program.profiled){
+        return mtac::hot(program, block);
+    }
+
+    return block->depth > 0;
+}
+
+//The variables that are written or whose address is taken cannot be replaced by constants
+Variables non_constant_variables(mtac::Function& function){
+    Variables variables;
+
+    for(auto& block : function){
+        for(auto& quadruple : block){
+            if(quadruple.op == mtac::Operator::PPARAM || quadruple.op == mtac::Operator::PASSIGN || quadruple.op == mtac::Operator::DOT_PASSIGN){
+                for(auto* arg : {&quadruple.arg1, &quadruple.arg2}){
+                    if(*arg){
+                        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&**arg)){
+                            variables.insert(*ptr);
+                        }
+                    }
+                }
+            }
+
+            //The result of a PARAM is a parameter of the called function
+            if(quadruple.op != mtac::Operator::PARAM && quadruple.op != mtac::Operator::PPARAM){
+                if(quadruple.result){
+                    variables.insert(quadruple.result);
+                }
+
+                if(quadruple.secondary){
+                    variables.insert(quadruple.secondary);
+                }
+            }
+        }
+    }
+
+    return variables;
+}
+
+//Collect the PARAM of each parameter of the call
+bool collect_params(mtac::basic_block_p block, std::size_t uid, eddic::Function& target, std::vector<mtac::Quadruple*>& params){
+    std::vector<mtac::Quadruple*> candidates;
+
+    auto it = block->statements.rbegin();
+    auto end = block->statements.rend();
+
+    while(it != end && it->uid() != uid){
+        ++it;
+    }
+
+    if(it == end){
+        return false;
+    }
+
+    for(++it; it != end; ++it){
+        candidates.push_back(&*it);
+    }
+
+    //The parameters can only be in the previous block if it always falls through to the call
+    if(block->predecessors.size() == 1 && block->predecessors[0] == block->prev() && block->prev()->index >= 0){
+        for(auto pit = block->prev()->statements.rbegin(); pit != block->prev()->statements.rend(); ++pit){
+            candidates.push_back(&*pit);
+        }
+    }
+
+    auto parameters = target.parameters().size();
+
+    for(auto* quadruple : candidates){
+        if(params.size() == parameters){
+            break;
+        }
+
+        //The parameters of a previous call to the same function
+        if(quadruple->op == mtac::Operator::CALL && quadruple->function() == target){
+            return false;
+        }
+
+        if((quadruple->op == mtac::Operator::PARAM || quadruple->op == mtac::Operator::PPARAM) && quadruple->m_function && *quadruple->m_function == target){
+            if(!quadruple->param()){
+                return false;
+            }
+
+            for(auto* param : params){
+                if(param->param() == quadruple->param()){
+                    return false;
+                }
+            }
+
+            params.push_back(quadruple);
+        }
+    }
+
+    return params.size() == parameters;
+}
+
+std::vector<Specialization> collect_specializations(mtac::Program& program, std::unordered_map<std::string, Variables>& candidates){
+    std::vector<Specialization> specializations;
+
+    for(auto& function : program.functions){
+        for(auto& block : function){
+            if(!hot_site(program, block)){
+                continue;
+            }
+
+            for(auto& quadruple : block){
+                if(quadruple.op != mtac::Operator::CALL || !candidates.count(quadruple.function().mangled_name())){
+                    continue;
+                }
+
+                auto& target = quadruple.function();
+                auto& non_constant = candidates[target.mangled_name()];
+
+                std::vector<mtac::Quadruple*> params;
+                if(!collect_params(block, quadruple.uid(), target, params)){
+                    continue;
+                }
+
+                Constants constants;
+
+                for(auto* param : params){
+                    if(param->param()->type() == INT && !non_constant.count(param->param())){
+                        if(auto* ptr = boost::get<int>(&*param->arg1)){
+                            constants.emplace_back(param->param(), *ptr);
+                        }
+                    }
+                }
+
+                if(constants.empty()){
+                    continue;
+                }
+
+                std::sort(constants.begin(), constants.end(),
+                        [](const std::pair<std::shared_ptr<Variable>, int>& lhs, const std::pair<std::shared_ptr<Variable>, int>& rhs){ return lhs.first->name() < rhs.first->name(); });
+
+                auto it = std::find_if(specializations.begin(), specializations.end(),
+                        [&target, &constants](const Specialization& specialization){ return *specialization.target == target && specialization.constants == constants; });
+
+                if(it == specializations.end()){
+                    specializations.emplace_back();
+                    it = specializations.end() - 1;
+
+                    it->target = &target;
+                    it->constants = std::move(constants);
+                }
+
+                it->sites.push_back({&function.definition(), block, quadruple.uid()});
+                it->frequency += program.profiled ? block->frequency : 1;
+            }
+        }
+    }
+
+    return specializations;
+}
+
+eddic::Function& specialize(mtac::Program& program, Specialization& specialization, const std::string& mangled_name, Platform platform, std::shared_ptr<Configuration> configuration){
+    auto global_context = program.context;
+
+    auto& target = *specialization.target;
+    auto& source = program.mtac_function(target);
+
+    LOG<Trace>("Specialization") << "Specialize " << target.mangled_name() << " into " << mangled_name << log::endl;
+    global_context->stats().inc_counter("specialized_functions");
+
+    auto& definition = global_context->add_function(target.return_type(), target.name(), mangled_name);
+    definition.struct_type() = target.struct_type();
+
+    auto context = std::make_shared<FunctionContext>(target.context()->parent(), global_context, platform, configuration);
+    context->struct_type = target.context()->struct_type;
+    definition.context() = context;
+
+    //The constant parameters are removed from the copy
+    mtac::VariableClones variable_clones;
+
+    for(auto& parameter : target.parameters()){
+        auto variable = target.context()->getVariable(parameter.name());
+
+        auto it = std::find_if(specialization.constants.begin(), specialization.constants.end(),
+                [&variable](const std::pair<std::shared_ptr<Variable>, int>& constant){ return constant.first == variable; });
+
+        if(it != specialization.constants.end()){
+            variable_clones[variable] = it->second;
+        } else {
+            variable_clones[variable] = context->addParameter(parameter.name(), parameter.type());
+            definition.parameters().emplace_back(parameter.name(), parameter.type());
+        }
+    }
+
+    for(auto& variable : target.context()->stored_variables()){
+        variable_clones[variable] = context->newVariable(variable);
+    }
+
+    mtac::Function function(context, mangled_name, definition);
+    function.pure() = source.pure();
+
+    function.create_entry_bb();
+    function.create_exit_bb();
+
+    mtac::BBClones bb_clones;
+    bb_clones[source.entry_bb()] = function.entry_bb();
+    bb_clones[source.exit_bb()] = function.exit_bb();
+
+    for(auto& block : source){
+        if(block->index >= 0){
+            auto new_bb = function.new_bb();
+            function.insert_before(function.at(function.exit_bb()), new_bb);
+            bb_clones[block] = new_bb;
+        }
+    }
+
+    //The counts of the original function are shared with the copy
+    auto calls = source.entry_bb()->frequency;
+
+    for(auto& block : source){
+        auto& new_bb = bb_clones[block];
+
+        new_bb->depth = block->depth;
+
+        if(program.profiled && calls){
+            new_bb->frequency = static_cast<std::size_t>(static_cast<double>(block->frequency) * std::min(specialization.frequency, calls) / calls);
+            block->frequency -= std::min(block->frequency, new_bb->frequency);
+        }
+
+        for(auto& statement : block->statements){
+            new_bb->statements.push_back(mtac::copy(statement));
+        }
+
+        for(auto& succ : block->successors){
+            mtac::make_edge(new_bb, bb_clones[succ]);
+        }
+    }
+
+    mtac::VariableReplace variable_replacer(variable_clones);
+
+    for(auto& block : function){
+        for(auto& quadruple : block){
+            variable_replacer.replace(quadruple);
+            mtac::replace_bbs(bb_clones, quadruple);
+
+            //The copy calls the same functions as the original
+            if(quadruple.op == mtac::Operator::CALL){
+                program.cg.add_edge(definition, quadruple.function());
+
+                if(program.profiled){
+                    program.cg.edge(definition, quadruple.function())->frequency += block->frequency;
+                }
+            }
+        }
+    }
+
+    //Redirect the call sites to the copy
+    for(auto& site : specialization.sites){
+        std::vector<mtac::Quadruple*> params;
+        collect_params(site.block, site.uid, target, params);
+
+        for(auto* param : params){
+            auto& clone = variable_clones[param->param()];
+
+            if(mtac::isVariable(clone)){
+                param->result = boost::get<std::shared_ptr<Variable>>(clone);
+                param->m_function = &definition;
+            } else {
+                mtac::transform_to_nop(*param);
+            }
+        }
+
+        for(auto& quadruple : site.block->statements){
+            if(quadruple.uid() == site.uid){
+                quadruple.m_function = &definition;
+            }
+        }
+
+        auto frequency = program.profiled ? site.block->frequency : 0;
+
+        auto edge = program.cg.edge(*site.caller, target);
+        --edge->count;
+        edge->frequency -= std::min(edge->frequency, frequency);
+
+        program.cg.add_edge(*site.caller, definition);
+        program.cg.edge(*site.caller, definition)->frequency += frequency;
+    }
+
+    program.functions.push_back(std::move(function));
+
+    return definition;
+}
+
+} //end of anonymous namespace
+
+bool mtac::specialize_functions::gate(std::shared_ptr<Configuration> configuration){
+    return configuration->option_defined("fspecialize-functions");
+}
+
+void mtac::specialize_functions::set_platform(Platform platform){
+    this->platform = platform;
+}
+
+void mtac::specialize_functions::set_configuration(std::shared_ptr<Configuration> configuration){
+    this->configuration = configuration;
+}
+
+bool mtac::specialize_functions::operator()(mtac::Program& program){
+    auto global_context = program.context;
+
+    std::size_t program_size = 0;
+    std::unordered_map<std::string, Variables> candidates;
+
+    for(auto& function : program.functions){
+        program_size += function.size();
+
+        if(function.size() >= MIN_SIZE && function.size() <= MAX_SIZE && can_be_specialized(function)){
+            candidates[function.definition().mangled_name()] = non_constant_variables(function);
+        }
+    }
+
+    //The copies can grow the original program by half, at least by one copy
+    auto original_size = program_size - std::min(program_size, program.specialized_size);
+    auto budget = std::max(original_size / 2, MAX_SIZE);
+
+    auto specializations = collect_specializations(program, candidates);
+
+    //The hottest call sites are specialized first
+    std::stable_sort(specializations.begin(), specializations.end(),
+            [](const Specialization& lhs, const Specialization& rhs){ return lhs.frequency > rhs.frequency; });
+
+    bool optimized = false;
+
+    for(auto& specialization : specializations){
+        auto& target = *specialization.target;
+
+        std::size_t calls = 0;
+        for(auto& in_edge : program.cg.node(target)->in_edges){
+            calls += in_edge->count;
+        }
+
+        //If all the calls pass the same constants, the parameters are propagated instead
+        if(specialization.sites.size() >= calls){
+            continue;
+        }
+
+        auto size = program.mtac_function(target).size();
+
+        if(program.specialized_size + size > budget){
+            continue;
+        }
+
+        unsigned int copies = 1;
+        while(global_context->exists(target.mangled_name() + "_S" + toString(copies))){
+            ++copies;
+        }
+
+        if(copies > MAX_SPECIALIZATIONS){
+            continue;
+        }
+
+        specialize(program, specialization, target.mangled_name() + "_S" + toString(copies), platform, configuration);
+
+        program.specialized_size += size;
+        optimized = true;
+    }
+
+    return optimized;
+}
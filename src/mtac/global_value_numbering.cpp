@@ -0,0 +1,546 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include "FunctionContext.hpp"
+#include "GlobalContext.hpp"
+#include "Function.hpp"
+#include "Variable.hpp"
+#include "Type.hpp"
+#include "logging.hpp"
+
+#include "mtac/global_value_numbering.hpp"
+#include "mtac/cse.hpp"
+#include "mtac/dominators.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Quadruple.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//A hash table whose modifications are undone when leaving a block of the dominator tree
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+struct scoped_table {
+    std::unordered_map<Key, Value, Hash> values;
+    std::vector<std::pair<Key, boost::optional<Value>>> log;
+
+    std::size_t mark() const {
+        return log.size();
+    }
+
+    const Value* find(const Key& key) const {
+        auto it = values.find(key);
+        return it == values.end() ? nullptr : &it->second;
+    }
+
+    void set(const Key& key, Value value){
+        auto it = values.find(key);
+
+        if(it == values.end()){
+            log.emplace_back(key, boost::none);
+            values.emplace(key, std::move(value));
+        } else {
+            log.emplace_back(key, it->second);
+            it->second = std::move(value);
+        }
+    }
+
+    void undo(std::size_t mark){
+        while(log.size() > mark){
+            auto& entry = log.back();
+
+            if(entry.second){
+                values[entry.first] = *entry.second;
+            } else {
+                values.erase(entry.first);
+            }
+
+            log.pop_back();
+        }
+    }
+};
+
+struct position {
+    mtac::basic_block_p block;
+    std::size_t index;
+};
+
+//The value number held by a variable or stored in an aggregate
+struct mapping {
+    std::size_t number;
+    mtac::basic_block_p block;
+    std::size_t global_epoch;
+    std::size_t memory_epoch;
+    bool inheritable;           //All the other definitions dominate this one, so the blocks dominated by it can use it
+};
+
+struct expression_key {
+    mtac::Operator op;
+    std::size_t lhs;
+    std::size_t rhs;
+    tac::Size size;
+
+    bool operator==(const expression_key& rhs) const {
+        return op == rhs.op && lhs == rhs.lhs && this->rhs == rhs.rhs && size == rhs.size;
+    }
+};
+
+struct expression_hash {
+    std::size_t operator()(const expression_key& key) const {
+        std::size_t seed = 13;
+
+        boost::hash_combine(seed, static_cast<unsigned int>(key.op));
+        boost::hash_combine(seed, key.lhs);
+        boost::hash_combine(seed, key.rhs);
+        boost::hash_combine(seed, static_cast<unsigned int>(key.size));
+
+        return seed;
+    }
+};
+
+//The first computation of an expression
+struct expression_entry {
+    std::size_t number;
+    std::size_t uid;
+    mtac::basic_block_p block;
+    std::shared_ptr<const Type> type;
+};
+
+typedef std::unordered_map<std::shared_ptr<Variable>, std::vector<position>> Definitions;
+typedef std::vector<std::shared_ptr<Variable>> Holders;
+
+bool is_global(const std::shared_ptr<Variable>& variable){
+    return variable->position().isGlobal();
+}
+
+bool is_store(mtac::Operator op){
+    return op == mtac::Operator::DOT_ASSIGN || op == mtac::Operator::DOT_FASSIGN || op == mtac::Operator::DOT_PASSIGN;
+}
+
+struct value_numbering {
+    mtac::Function& function;
+    const mtac::escaped_variables& escaped;
+
+    std::size_t next = 0;
+
+    //Incremented when the global variables may have been modified behind our back
+    std::size_t global_epoch = 0;
+
+    //Incremented when the aggregates may have been modified behind our back
+    std::size_t memory_epoch = 0;
+
+    //The current position of the walk
+    mtac::basic_block_p block;
+    std::size_t index = 0;
+
+    std::unordered_map<mtac::basic_block_p, std::vector<mtac::basic_block_p>> children;
+    std::unordered_map<mtac::basic_block_p, std::pair<std::size_t, std::size_t>> numbers;
+
+    Definitions definitions;
+    Definitions stores;
+    std::vector<position> calls;
+    std::vector<position> clobbers;
+
+    std::unordered_map<mtac::Argument, std::size_t, boost::hash<mtac::Argument>> constants;
+
+    scoped_table<std::shared_ptr<Variable>, mapping> values;
+    scoped_table<std::shared_ptr<Variable>, mapping> memory;
+    scoped_table<expression_key, expression_entry, expression_hash> expressions;
+    scoped_table<std::size_t, Holders> holders;
+
+    //The temporaries saving the value of the first computations, by uid
+    std::unordered_map<std::size_t, std::shared_ptr<Variable>> temporaries;
+    std::vector<std::pair<mtac::basic_block_p, std::size_t>> saved;
+
+    bool optimized = false;
+
+    value_numbering(mtac::Function& function, const mtac::escaped_variables& escaped) : function(function), escaped(escaped) {}
+
+    bool clobbers_memory(mtac::Quadruple& quadruple){
+        return quadruple.op == mtac::Operator::CALL && !mtac::safe(quadruple.function().mangled_name());
+    }
+
+    bool clobbers_globals(mtac::Quadruple& quadruple){
+        if(quadruple.op == mtac::Operator::CALL){
+            return !quadruple.function().standard() && !mtac::safe(quadruple.function().mangled_name());
+        }
+
+        //A store through a pointer can modify any global variable
+        return is_store(quadruple.op) && quadruple.result->type()->is_pointer();
+    }
+
+    void collect(){
+        for(auto& bb : function){
+            if(bb->dominator()){
+                children[bb->dominator()].push_back(bb);
+            }
+
+            for(std::size_t i = 0; i < bb->statements.size(); ++i){
+                auto& quadruple = bb->statements[i];
+
+                if(quadruple.op == mtac::Operator::CALL){
+                    if(quadruple.return1()){
+                        definitions[quadruple.return1()].push_back({bb, i});
+                    }
+
+                    if(quadruple.return2()){
+                        definitions[quadruple.return2()].push_back({bb, i});
+                    }
+
+                    if(clobbers_memory(quadruple)){
+                        calls.push_back({bb, i});
+                    }
+                } else if(is_store(quadruple.op)){
+                    stores[quadruple.result].push_back({bb, i});
+                }
+
+                if(clobbers_globals(quadruple)){
+                    clobbers.push_back({bb, i});
+                }
+
+                if(quadruple.result && mtac::erase_result(quadruple.op)){
+                    definitions[quadruple.result].push_back({bb, i});
+                    stores[quadruple.result].push_back({bb, i});
+                }
+            }
+        }
+
+        std::size_t counter = 0;
+        number_tree(function.entry_bb(), counter);
+    }
+
+    void number_tree(mtac::basic_block_p bb, std::size_t& counter){
+        auto pre = counter++;
+
+        for(auto& child : children[bb]){
+            number_tree(child, counter);
+        }
+
+        numbers[bb] = std::make_pair(pre, counter++);
+    }
+
+    bool dominates(const position& def, const position& point) const {
+        if(def.block == point.block){
+            return def.index < point.index;
+        }
+
+        auto lhs = numbers.find(def.block);
+        auto rhs = numbers.find(point.block);
+
+        if(lhs == numbers.end() || rhs == numbers.end()){
+            return false;
+        }
+
+        return lhs->second.first < rhs->second.first && rhs->second.second < lhs->second.second;
+    }
+
+    bool dominate(const std::vector<position>& positions, const position& point) const {
+        for(auto& def : positions){
+            if(!(def.block == point.block && def.index == point.index) && !dominates(def, point)){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool inheritable(const std::shared_ptr<Variable>& variable, const Definitions& definitions, bool memory) const {
+        position point{block, index};
+
+        auto it = definitions.find(variable);
+        if(it != definitions.end() && !dominate(it->second, point)){
+            return false;
+        }
+
+        if(is_global(variable) && !dominate(clobbers, point)){
+            return false;
+        }
+
+        return !memory || dominate(calls, point);
+    }
+
+    bool tracked(const std::shared_ptr<Variable>& variable) const {
+        return !variable->is_reference() && escaped.find(variable) == escaped.end();
+    }
+
+    bool valid(const mapping& mapping, const std::shared_ptr<Variable>& variable, bool memory) const {
+        if(!mapping.inheritable && mapping.block != block){
+            return false;
+        }
+
+        if(memory && mapping.memory_epoch != memory_epoch){
+            return false;
+        }
+
+        return !is_global(variable) || mapping.global_epoch == global_epoch;
+    }
+
+    const mapping* current(const std::shared_ptr<Variable>& variable){
+        auto* mapping = values.find(variable);
+        return mapping && valid(*mapping, variable, false) ? mapping : nullptr;
+    }
+
+    void define(const std::shared_ptr<Variable>& variable, std::size_t number){
+        if(!tracked(variable)){
+            return;
+        }
+
+        values.set(variable, {number, block, global_epoch, memory_epoch, inheritable(variable, definitions, false)});
+
+        auto* previous = holders.find(number);
+        Holders list = previous ? *previous : Holders();
+        list.push_back(variable);
+        holders.set(number, std::move(list));
+    }
+
+    void define_memory(const std::shared_ptr<Variable>& variable, std::size_t number){
+        memory.set(variable, {number, block, global_epoch, memory_epoch, inheritable(variable, stores, true)});
+    }
+
+    std::size_t value(const std::shared_ptr<Variable>& variable){
+        if(!tracked(variable)){
+            return next++;
+        }
+
+        if(auto* mapping = current(variable)){
+            return mapping->number;
+        }
+
+        //The current value of the variable is not known yet
+        auto number = next++;
+        define(variable, number);
+        return number;
+    }
+
+    std::size_t value(const mtac::Argument& arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            return value(*ptr);
+        }
+
+        auto it = constants.find(arg);
+        if(it != constants.end()){
+            return it->second;
+        }
+
+        return constants[arg] = next++;
+    }
+
+    std::size_t memory_value(const std::shared_ptr<Variable>& variable){
+        auto* mapping = memory.find(variable);
+
+        if(mapping && valid(*mapping, variable, true)){
+            return mapping->number;
+        }
+
+        auto number = next++;
+        define_memory(variable, number);
+        return number;
+    }
+
+    //A variable still holding the given value
+    std::shared_ptr<Variable> holder(std::size_t number, std::shared_ptr<const Type> type){
+        if(auto* list = holders.find(number)){
+            for(auto it = list->rbegin(); it != list->rend(); ++it){
+                auto* mapping = current(*it);
+
+                if(mapping && mapping->number == number && (*it)->type() == type){
+                    return *it;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<Variable> temporary(const expression_entry& entry){
+        auto it = temporaries.find(entry.uid);
+        if(it != temporaries.end()){
+            return it->second;
+        }
+
+        auto tmp = function.context->new_temporary(entry.type);
+        temporaries[entry.uid] = tmp;
+        saved.emplace_back(entry.block, entry.uid);
+        return tmp;
+    }
+
+    void number_expression(mtac::Quadruple& quadruple){
+        auto op = quadruple.op;
+        std::size_t lhs;
+
+        if(op == mtac::Operator::DOT){
+            auto* aggregate = boost::get<std::shared_ptr<Variable>>(&*quadruple.arg1);
+
+            //Only the loads from the aggregates themselves can be numbered
+            if(!aggregate || (*aggregate)->type()->is_pointer() || !tracked(*aggregate)){
+                define(quadruple.result, next++);
+                return;
+            }
+
+            lhs = memory_value(*aggregate);
+        } else {
+            lhs = value(*quadruple.arg1);
+        }
+
+        auto rhs = value(*quadruple.arg2);
+
+        if(mtac::is_commutative(op) && rhs < lhs){
+            std::swap(lhs, rhs);
+        }
+
+        expression_key key{op, lhs, rhs, quadruple.size};
+        auto type = quadruple.result->type();
+
+        auto* entry = expressions.find(key);
+        if(entry && entry->type == type){
+            auto number = entry->number;
+            auto source = holder(number, type);
+
+            //The first computation dominates this one, its value can be saved
+            if(!source){
+                source = temporary(*entry);
+            }
+
+            LOG<Trace>("Optimizer") << "GVN: " << quadruple << " is redundant with " << source << log::endl;
+
+            if(source == quadruple.result){
+                quadruple.op = mtac::Operator::NOP;
+                quadruple.result = nullptr;
+                quadruple.arg1.reset();
+            } else {
+                quadruple.op = mtac::assign_op(op);
+                quadruple.arg1 = source;
+            }
+
+            quadruple.arg2.reset();
+
+            function.context->global()->stats().inc_counter("gvn_eliminated");
+            optimized = true;
+
+            if(source != quadruple.result && quadruple.result){
+                define(quadruple.result, number);
+            }
+
+            return;
+        }
+
+        auto number = next++;
+        expressions.set(key, {number, quadruple.uid(), block, type});
+        define(quadruple.result, number);
+    }
+
+    void number_block(mtac::basic_block_p bb){
+        block = bb;
+
+        for(index = 0; index < bb->statements.size(); ++index){
+            auto& quadruple = bb->statements[index];
+            auto op = quadruple.op;
+
+            if(op == mtac::Operator::CALL){
+                if(clobbers_memory(quadruple)){
+                    ++memory_epoch;
+                }
+
+                if(clobbers_globals(quadruple)){
+                    ++global_epoch;
+                }
+
+                if(quadruple.return1()){
+                    define(quadruple.return1(), next++);
+                }
+
+                if(quadruple.return2()){
+                    define(quadruple.return2(), next++);
+                }
+            } else if(mtac::is_expression(op) && quadruple.result && quadruple.arg1 && quadruple.arg2){
+                number_expression(quadruple);
+            } else if((op == mtac::Operator::ASSIGN || op == mtac::Operator::FASSIGN) && quadruple.result && quadruple.arg1){
+                auto* ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple.arg1);
+
+                //A copy holds the same value as its source
+                if(!ptr || (*ptr)->type() == quadruple.result->type()){
+                    define(quadruple.result, value(*quadruple.arg1));
+                } else {
+                    define(quadruple.result, next++);
+                }
+            } else if(is_store(op)){
+                if(clobbers_globals(quadruple)){
+                    ++global_epoch;
+                } else if(tracked(quadruple.result)){
+                    define_memory(quadruple.result, next++);
+                }
+            } else if(quadruple.result && mtac::erase_result(op)){
+                define(quadruple.result, next++);
+            }
+
+            //The contents of an assigned aggregate are not known anymore
+            if(quadruple.result && mtac::erase_result(quadruple.op) && memory.find(quadruple.result)){
+                define_memory(quadruple.result, next++);
+            }
+        }
+    }
+
+    void visit(mtac::basic_block_p bb){
+        auto values_mark = values.mark();
+        auto memory_mark = memory.mark();
+        auto expressions_mark = expressions.mark();
+        auto holders_mark = holders.mark();
+
+        number_block(bb);
+
+        for(auto& child : children[bb]){
+            visit(child);
+        }
+
+        values.undo(values_mark);
+        memory.undo(memory_mark);
+        expressions.undo(expressions_mark);
+        holders.undo(holders_mark);
+    }
+
+    //The first computations now compute the temporaries and copy them to their old result
+    void save_computations(){
+        for(auto& pair : saved){
+            auto& statements = pair.first->statements;
+
+            auto it = statements.begin();
+            while(it->uid() != pair.second){
+                ++it;
+            }
+
+            auto tmp = temporaries[pair.second];
+            auto result = it->result;
+
+            it->result = tmp;
+
+            statements.insert(it + 1, mtac::Quadruple(result, tmp, mtac::assign_op(it->op)));
+        }
+    }
+};
+
+} //end of anonymous namespace
+
+bool mtac::global_value_numbering::operator()(mtac::Function& function){
+    mtac::compute_dominators(function);
+
+    auto escaped = mtac::escape_analysis(function);
+
+    value_numbering numbering(function, *escaped);
+
+    numbering.collect();
+    numbering.visit(function.entry_bb());
+    numbering.save_computations();
+
+    return numbering.optimized;
+}
@@ -5,8 +5,13 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <cmath>
+#include <queue>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+
+#include "cpp_utils/assert.hpp"
 
 #include "logging.hpp"
 #include "Options.hpp"
@@ -18,6 +23,7 @@
 #include "Variable.hpp"
 
 #include "mtac/inlining.hpp"
+#include "mtac/profile.hpp"
 #include "mtac/Utils.hpp"
 #include "mtac/VariableReplace.hpp"
 #include "mtac/ControlFlowGraph.hpp"
@@ -29,6 +35,7 @@ namespace {
 
 mtac::basic_block_p create_safe_block(mtac::Function& dest_function, mtac::basic_block_p bb){
     auto safe_block = dest_function.new_bb();
+    safe_block->frequency = bb->frequency;
 
     //Insert the new basic block before the old one
     dest_function.insert_after(dest_function.at(bb), safe_block);
@@ -61,6 +68,7 @@ mtac::basic_block_p split_if_necessary(mtac::Function& dest_function, mtac::basi
         log::emit<Trace>("Inlining") << "Split block " << bb << " to perform inlining" << log::endl;
 
         auto split_block = dest_function.new_bb();
+        split_block->frequency = bb->frequency;
 
         dest_function.insert_after(dest_function.at(bb), split_block);
 
@@ -74,11 +82,7 @@ mtac::basic_block_p split_if_necessary(mtac::Function& dest_function, mtac::basi
 
         mtac::make_edge(bb, split_block);
 
-        auto pit = bb->statements.begin();
-
-        while(pit->uid() != call_uid){
-            ++pit;
-        }
+        auto pit = bb->statements.find(call_uid);
 
         //Erase the call
         mtac::transform_to_nop(*pit);
@@ -97,29 +101,25 @@ mtac::BBClones clone(mtac::Function& source_function, mtac::Function& dest_funct
 
     mtac::BBClones bb_clones;
 
-    std::vector<mtac::basic_block_p> cloned;
-
     auto old_entry = source_function.entry_bb();
     auto old_exit = source_function.exit_bb();
 
-    auto entry = bb->prev;
+    auto entry = bb->prev();
     auto exit = bb;
 
+    std::vector<mtac::basic_block_p> sources;
+
     for(auto& block : source_function){
         //Copy all basic blocks except ENTRY and EXIT
         if(block->index >= 0){
             auto new_bb = dest_function.new_bb();
 
-            //Copy the control flow graph properties, they will be corrected after
-            new_bb->successors = block->successors;
-            new_bb->predecessors = block->predecessors;
-
             for(auto& statement : block->statements){
                 new_bb->statements.push_back(mtac::copy(statement));
             }
 
             bb_clones[block] = new_bb;
-            cloned.push_back(new_bb);
+            sources.push_back(block);
 
             dest_function.insert_before(dest_function.at(exit), new_bb);
         }
@@ -127,22 +127,25 @@ mtac::BBClones clone(mtac::Function& source_function, mtac::Function& dest_funct
 
     mtac::remove_edge(entry, exit);
 
-    for(auto& block : cloned){
+    //The edges refer to the blocks of the source function, they are recreated between the clones
+    for(auto& block : sources){
+        auto& new_bb = bb_clones[block];
+
         for(auto& succ : block->successors){
             if(succ == old_exit){
-                succ = exit;
-                exit->predecessors.push_back(block);
+                new_bb->successors.push_back(exit);
+                exit->predecessors.push_back(new_bb);
             } else {
-                succ = bb_clones[succ];
+                new_bb->successors.push_back(bb_clones[succ]);
             }
         }
 
         for(auto& pred : block->predecessors){
             if(pred == old_entry){
-                pred = entry;
-                entry->successors.push_back(block);
+                new_bb->predecessors.push_back(entry);
+                entry->successors.push_back(new_bb);
             } else {
-                pred = bb_clones[pred];
+                new_bb->predecessors.push_back(bb_clones[pred]);
             }
         }
     }
@@ -150,6 +153,21 @@ mtac::BBClones clone(mtac::Function& source_function, mtac::Function& dest_funct
     return bb_clones;
 }
 
+//The counts of the callee are the sum over all its call sites, only the share of this call site is kept
+void scale_frequencies(mtac::Function& source_function, mtac::BBClones& bb_clones, std::size_t call_frequency){
+    auto calls = source_function.entry_bb()->frequency;
+
+    for(auto& block : source_function){
+        if(block->index >= 0){
+            if(calls){
+                bb_clones[block]->frequency = static_cast<std::size_t>(static_cast<double>(block->frequency) * call_frequency / calls);
+            } else {
+                bb_clones[block]->frequency = 0;
+            }
+        }
+    }
+}
+
 mtac::VariableClones copy_parameters(mtac::Function& source_function, mtac::Function& dest_function, mtac::basic_block_p bb){
     mtac::VariableClones variable_clones;
 
@@ -171,7 +189,7 @@ mtac::VariableClones copy_parameters(mtac::Function& source_function, mtac::Func
     if(source_definition.parameters().size() > 0){
         //We know for sure that that the parameters are in the previous block
         //This is ensured by split_if_necessary
-        auto pit = bb->prev->statements.end() - 1;
+        auto pit = bb->prev()->statements.end() - 1;
 
         for(int i = parameters - 1; i >= 0;){
             auto& statement = *pit;
@@ -247,7 +265,7 @@ unsigned int count_constant_parameters(mtac::Function& source_function, mtac::Fu
         mtac::basic_block::iterator pit;
 
         if(bb->statements.front() == call){
-            pit = bb->prev->statements.end() - 1;
+            pit = bb->prev()->statements.end() - 1;
         } else {
             pit = bb->statements.begin();
 
@@ -287,7 +305,7 @@ unsigned int count_constant_parameters(mtac::Function& source_function, mtac::Fu
 void adapt_instructions(mtac::VariableClones& variable_clones, mtac::BBClones& bb_clones, mtac::Quadruple& call, mtac::basic_block_p basic_block){
     mtac::VariableReplace variable_replacer(variable_clones);
 
-    auto new_bb = basic_block->prev;
+    auto new_bb = basic_block->prev();
 
     auto cloned_bb = bb_clones.size();
 
@@ -305,12 +323,12 @@ void adapt_instructions(mtac::VariableClones& variable_clones, mtac::BBClones& b
                 mtac::Quadruple goto_(static_cast<const std::string&>(label), mtac::Operator::GOTO);
                 goto_.block = basic_block;
 
-                mtac::remove_edge(new_bb, new_bb->next);
+                mtac::remove_edge(new_bb, new_bb->next());
                 mtac::make_edge(new_bb, basic_block);
 
                 if(!call.return1()){
                     //If the caller does not care about the return value, return has no effect
-                    *ssit = std::move(goto_);
+                    new_bb->statements.replace(*ssit, std::move(goto_));
 
                     continue;
                 } else {
@@ -350,7 +368,7 @@ void adapt_instructions(mtac::VariableClones& variable_clones, mtac::BBClones& b
         }
 
         --cloned_bb;
-        new_bb = new_bb->prev;
+        new_bb = new_bb->prev();
     }
 }
 
@@ -373,130 +391,208 @@ bool can_be_inlined(mtac::Function& function){
     return true;
 }
 
-const int SMALL_FUNCTION = 12;
+const std::size_t SMALL_FUNCTION = 12;
 
-bool will_inline(mtac::Program& program, mtac::Function& source_function, mtac::Function& target_function, mtac::Quadruple& call, mtac::basic_block_p bb){
-    //Do not inline recursive calls
-    if(source_function.get_name() == target_function.get_name()){
-        return false;
-    }
+//Functions smaller than this can always grow up to it
+const std::size_t MIN_FUNCTION_LIMIT = 250;
 
-    if(can_be_inlined(target_function)){
-        auto caller_size = source_function.size();
-        auto callee_size = target_function.size();
+//The program can always grow by this number of statements
+const std::size_t MIN_UNIT_GROWTH = 300;
 
-        auto constant_parameters = count_constant_parameters(target_function, source_function, bb, call);
+bool non_standard_target(mtac::Quadruple& call, mtac::Program& program){
+    auto& target_definition = call.function();
 
-        //If all parameters are constant, there are high chances of further optimizations
-        if(target_function.definition().parameters().size() == constant_parameters){
-            return callee_size < 100 && caller_size < 300;
+    for(auto& function : program.functions){
+        if(function.definition().mangled_name() == target_definition.mangled_name()){
+            return false;
         }
+    }
 
-        //For inner loop, increase the chances of inlining
-        if(bb->depth > 1){
-            return caller_size < 250 && callee_size < 75;
-        }
+    return true;
+}
 
-        //For single loop, increase a bit the changes of inlining
-        if(bb->depth > 0){
-            return caller_size < 150 && callee_size < 50;
-        }
+struct call_site {
+    mtac::basic_block_p block;
+    std::size_t uid;
+    eddic::Function* callee;
+    double benefit;
+};
+
+struct lower_benefit {
+    bool operator()(const call_site& lhs, const call_site& rhs) const {
+        return lhs.benefit < rhs.benefit;
+    }
+};
+
+typedef std::priority_queue<call_site, std::vector<call_site>, lower_benefit> call_site_queue;
+
+std::size_t calls(mtac::Program& program, eddic::Function& function){
+    std::size_t count = 0;
 
-        //function called once
-        if(program.cg.node(target_function.definition())->in_edges.size() == 1){
-            return caller_size < 100 && callee_size < 100;
+    for(auto& in_edge : program.cg.node(function)->in_edges){
+        count += in_edge->count;
+    }
+
+    return count;
+}
+
+//The largest callee that can be inlined at the given call site
+std::size_t max_callee_size(mtac::Program& program, mtac::Function& callee, mtac::Function& caller, mtac::basic_block_p bb, mtac::Quadruple& call){
+    std::size_t limit = SMALL_FUNCTION;
+
+    //If all parameters are constant, there are high chances of further optimizations
+    if(callee.definition().parameters().size() == count_constant_parameters(callee, caller, bb, call)){
+        limit = std::max(limit, std::size_t(100));
+    }
+
+    if(program.profiled){
+        //With a profile, only the hot call sites get the budget of the inner loops
+        if(mtac::hot(program, bb)){
+            limit = std::max(limit, std::size_t(75));
         }
+    } else if(bb->depth > 1){
+        limit = std::max(limit, std::size_t(75));
+    } else if(bb->depth > 0){
+        limit = std::max(limit, std::size_t(50));
+    }
 
-        return callee_size < SMALL_FUNCTION && caller_size < 200;
+    //The callee will be removed once inlined
+    if(calls(program, callee.definition()) == 1){
+        limit = std::max(limit, std::size_t(100));
     }
 
-    return false;
+    return limit;
 }
 
-bool non_standard_target(mtac::Quadruple& call, mtac::Program& program){
-    auto& target_definition = call.function();
+//The most executed call sites of the smallest callees with constant arguments are inlined first
+double benefit(mtac::Program& program, mtac::Function& callee, mtac::Function& caller, mtac::basic_block_p bb, mtac::Quadruple& call){
+    double frequency;
+    if(program.profiled){
+        frequency = bb->frequency;
+    } else {
+        frequency = std::pow(10.0, std::min(bb->depth, 5u));
+    }
 
-    for(auto& function : program.functions){
-        if(function.definition().mangled_name() == target_definition.mangled_name()){
-            return false;
+    double benefit = frequency * (1 + count_constant_parameters(callee, caller, bb, call)) / (1 + callee.size());
+
+    if(calls(program, callee.definition()) == 1){
+        benefit *= 2;
+    }
+
+    return benefit;
+}
+
+call_site_queue collect_call_sites(mtac::Program& program, mtac::Function& caller, const std::unordered_set<std::string>& component){
+    call_site_queue queue;
+
+    for(auto& block : caller){
+        for(auto& quadruple : block){
+            if(quadruple.op != mtac::Operator::CALL || non_standard_target(quadruple, program)){
+                continue;
+            }
+
+            //Do not inline recursive calls
+            if(component.count(quadruple.function().mangled_name())){
+                continue;
+            }
+
+            auto& callee = program.mtac_function(quadruple.function());
+
+            if(can_be_inlined(callee)){
+                queue.push({block, quadruple.uid(), &quadruple.function(), benefit(program, callee, caller, block, quadruple)});
+            }
         }
     }
 
-    return true;
+    return queue;
 }
 
-bool call_site_inlining(mtac::Function& dest_function, mtac::Function& source_function, mtac::Program& program){
-    auto bit = dest_function.begin();
-    auto bend = dest_function.end();
+struct inlining_limits {
+    std::size_t unit;
+    unsigned int function_growth;
+};
+
+//Return the reason why the call site is not inlined, nullptr if it can be inlined
+const char* rejection(mtac::Program& program, mtac::Function& caller, mtac::Function& callee, call_site& site, const inlining_limits& limits){
+    //The call site has never been executed, inlining would only increase the size
+    if(mtac::cold(program, site.block)){
+        return "inline_rejected_cold";
+    }
+
+    auto& call = site.block->find(site.uid);
+    auto callee_size = callee.size();
 
+    if(callee_size > max_callee_size(program, callee, caller, site.block, call)){
+        return "inline_rejected_size";
+    }
+
+    auto original_size = program.original_sizes[caller.get_name()];
+    auto function_limit = std::max(original_size * (100 + limits.function_growth) / 100, MIN_FUNCTION_LIMIT);
+
+    if(caller.size() + callee_size > function_limit){
+        return "inline_rejected_function_growth";
+    }
+
+    if(program.inlined_size + callee_size > limits.unit){
+        return "inline_rejected_unit_growth";
+    }
+
+    return nullptr;
+}
+
+void inline_call_site(mtac::Program& program, mtac::Function& dest_function, mtac::Function& source_function, call_site& site){
     auto& source_definition = source_function.definition();
     auto& dest_definition = dest_function.definition();
 
-    while(bit != bend){
-        auto basic_block = *bit;
+    auto basic_block = site.block;
+    auto call = basic_block->find(site.uid);
+    auto call_frequency = basic_block->frequency;
 
-        auto it = iterate(basic_block->statements);
-
-        while(it.has_next()){
-            auto& src_call = *it;
-            if(src_call.op == mtac::Operator::CALL){
-                if(non_standard_target(src_call, program)){
-                    ++it;
-                    continue;
-                }
+    LOG<Trace>("Inlining") << "Inline " << source_function.get_name() << " into " << dest_function.get_name() << log::endl;
+    source_function.context->global()->stats().inc_counter("inlined_functions");
+    source_function.context->global()->stats().add_counter("inlined_statements", source_function.size());
 
-                if(src_call.function() == source_definition){
-                    if(will_inline(program, dest_function, source_function, src_call, basic_block)){
-                        auto call = src_call;
-                        auto src_call_uid = src_call.uid();
+    program.inlined_size += source_function.size();
 
-                        LOG<Trace>("Inlining") << "Inline " << source_function.get_name() << " into " << dest_function.get_name() << log::endl;
-                        source_function.context->global()->stats().inc_counter("inlined_functions");
+    basic_block = split_if_necessary(dest_function, basic_block, site.uid);
 
-                        basic_block = split_if_necessary(dest_function, basic_block, src_call_uid);
+    //Copy the parameters
+    auto variable_clones = copy_parameters(source_function, dest_function, basic_block);
 
-                        //Copy the parameters
-                        auto variable_clones = copy_parameters(source_function, dest_function, basic_block);
+    //Allocate storage for the local variables of the inlined function
+    for(auto& variable : source_definition.context()->stored_variables()){
+        variable_clones[variable] = dest_definition.context()->newVariable(variable);
+    }
 
-                        //Allocate storage for the local variables of the inlined function
-                        for(auto& variable : source_definition.context()->stored_variables()){
-                            variable_clones[variable] = dest_definition.context()->newVariable(variable);
-                        }
+    auto safe = create_safe_block(dest_function, basic_block);
 
-                        auto safe = create_safe_block(dest_function, basic_block);
+    //Clone all the source basic blocks in the dest function
+    auto bb_clones = clone(source_function, dest_function, safe);
 
-                        //Clone all the source basic blocks in the dest function
-                        auto bb_clones = clone(source_function, dest_function, safe);
+    if(program.profiled){
+        scale_frequencies(source_function, bb_clones, call_frequency);
+    }
 
-                        //Fix all the instructions (clones and return)
-                        adapt_instructions(variable_clones, bb_clones, call, safe);
+    //Fix all the instructions (clones and return)
+    adapt_instructions(variable_clones, bb_clones, call, safe);
 
-                        //The target function is called one less time
-                        --program.cg.edge(dest_definition, source_definition)->count;
+    //The target function is called one less time
+    auto edge = program.cg.edge(dest_definition, source_definition);
+    --edge->count;
+    edge->frequency -= std::min(edge->frequency, call_frequency);
 
-                        //There are perhaps new references to functions
-                        for(auto& block : source_function){
-                            for(auto& statement : block){
-                                if(statement.op == mtac::Operator::CALL){
-                                    program.cg.add_edge(dest_definition, statement.function());
-                                }
-                            }
-                        }
+    //There are perhaps new references to functions
+    for(auto& block : source_function){
+        for(auto& statement : block){
+            if(statement.op == mtac::Operator::CALL){
+                program.cg.add_edge(dest_definition, statement.function());
 
-                        //All the iterators are invalidated at this point
-                        //The loop will be restarted
-                        return true;
-                    }
+                if(program.profiled){
+                    program.cg.edge(dest_definition, statement.function())->frequency += bb_clones[block]->frequency;
                 }
             }
-
-            ++it;
         }
-
-        ++bit;
     }
-
-    return false;
 }
 
 } //end of anonymous namespace
@@ -509,58 +605,79 @@ bool mtac::inline_functions::gate(std::shared_ptr<Configuration> configuration){
     return configuration->option_defined("finline-functions");
 }
 
+void mtac::inline_functions::set_configuration(std::shared_ptr<Configuration> configuration){
+    this->configuration = configuration;
+}
+
 bool mtac::inline_functions::operator()(mtac::Program& program){
     bool optimized = false;
-    auto global_context = program.context;
 
-    auto& call_graph = program.cg;
+    //The budgets are relative to the program before any inlining
+    if(!program.original_size){
+        for(auto& function : program.functions){
+            program.original_size += function.size();
+        }
+    }
+
+    for(auto& function : program.functions){
+        if(!program.original_sizes.count(function.get_name())){
+            program.original_sizes[function.get_name()] = function.size();
+        }
+    }
 
-    auto order = call_graph.topological_order();
-    call_graph.compute_reachable();
+    inlining_limits limits;
+    limits.unit = std::max(program.original_size * configuration->option_int_value("inline-unit-growth") / 100, MIN_UNIT_GROWTH);
+    limits.function_growth = configuration->option_int_value("inline-function-growth");
 
-    typedef std::reference_wrapper<eddic::Function> func_ref;
+    //The callees are processed before their callers, so the sizes are the ones after inlining
+    for(auto& component : program.cg.strongly_connected_components()){
+        std::unordered_set<std::string> names;
+        for(auto& function : component){
+            names.insert(function.get().mangled_name());
+        }
 
-    for(auto& function_ref : order){
-        auto& function = function_ref.get();
+        for(auto& function_ref : component){
+            auto& function = function_ref.get();
 
-        //Consider only reachable functions
-        if(call_graph.is_reachable(function)){
-            //Standard function are assembly functions, cannot be inlined
-            if(!function.standard()){
-                auto cg_node = call_graph.node(function);
+            //Standard function are assembly functions, they do not call anything
+            if(function.standard()){
+                continue;
+            }
 
-                //Collect the callers of the functions
+            auto& caller = program.mtac_function(function);
 
-                std::vector<func_ref> callers;
-                for(auto& in_edge : cg_node->in_edges){
-                    if(in_edge->count > 0){
-                        callers.push_back(in_edge->source->function);
-                    }
-                }
+            //The call sites are collected again after each inlining since the blocks have been split
+            while(true){
+                auto queue = collect_call_sites(program, caller, names);
 
-                //Sort them to inline the edges in the order of the topological sort
+                std::vector<const char*> rejections;
+                bool inlined = false;
 
-                std::sort(callers.begin(), callers.end(),
-                        [&order](const func_ref& lhs, const func_ref& rhs){ return std::find(order.begin(), order.end(), lhs) < std::find(order.begin(),order.end(), rhs); });
+                while(!queue.empty()){
+                    auto site = queue.top();
+                    queue.pop();
 
-                auto& source_function = program.mtac_function(function);
+                    auto& callee = program.mtac_function(*site.callee);
 
-                for(auto& caller : callers){
-                    if(call_graph.is_reachable(caller.get())){
-                        auto& dest_function = program.mtac_function(caller.get());
+                    if(auto reason = rejection(program, caller, callee, site, limits)){
+                        rejections.push_back(reason);
+                    } else {
+                        inline_call_site(program, caller, callee, site);
+                        optimized = inlined = true;
+                        break;
+                    }
+                }
 
-                        bool local = false;
-                        do {
-                            local = call_site_inlining(dest_function, source_function, program);
-                            optimized |= local;
-                        } while(local);
+                if(!inlined){
+                    for(auto reason : rejections){
+                        program.context->stats().inc_counter(reason);
                     }
+
+                    break;
                 }
             }
         }
     }
 
-    call_graph.release_reachable();
-
     return optimized;
 }
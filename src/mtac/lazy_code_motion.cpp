@@ -0,0 +1,523 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#include "Variable.hpp"
+#include "FunctionContext.hpp"
+#include "GlobalContext.hpp"
+#include "logging.hpp"
+
+#include "mtac/lazy_code_motion.hpp"
+#include "mtac/GlobalOptimizations.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/block_map.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/Quadruple.hpp"
+#include "mtac/cse.hpp"
+
+using namespace eddic;
+
+namespace {
+
+typedef mtac::block_map<mtac::ExpressionBits> BlockBits;
+
+struct expression {
+    mtac::Operator op;
+    mtac::Argument arg1;
+    mtac::Argument arg2;
+    std::shared_ptr<const Type> type;
+    bool valid;
+};
+
+typedef std::tuple<mtac::Operator, mtac::Argument, mtac::Argument> Key;
+
+struct local_properties {
+    std::vector<expression> expressions;
+    std::map<Key, std::size_t> indices;
+    std::unordered_map<std::shared_ptr<Variable>, std::vector<std::size_t>> dependents;
+
+    BlockBits antloc;   //Computed before any operand is defined in the block
+    BlockBits comp;     //Computed after the last definition of its operands in the block
+    BlockBits transp;   //None of the operands is defined in the block
+
+    std::size_t size() const {
+        return expressions.size();
+    }
+
+    Key key(mtac::Quadruple& quadruple) const {
+        if(mtac::is_commutative(quadruple.op) && *quadruple.arg2 < *quadruple.arg1){
+            return std::make_tuple(quadruple.op, *quadruple.arg2, *quadruple.arg1);
+        }
+
+        return std::make_tuple(quadruple.op, *quadruple.arg1, *quadruple.arg2);
+    }
+
+    //Return the index of the expression computed by the quadruple or size() if it is not a candidate
+    std::size_t index(mtac::Quadruple& quadruple) const {
+        if(quadruple.op >= mtac::Operator::ADD && quadruple.op <= mtac::Operator::FDIV && quadruple.result && quadruple.arg1 && quadruple.arg2){
+            auto it = indices.find(key(quadruple));
+
+            if(it != indices.end()){
+                return it->second;
+            }
+        }
+
+        return size();
+    }
+};
+
+bool is_candidate_operand(const mtac::Argument& arg, const mtac::escaped_variables& escaped){
+    if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+        auto& variable = *ptr;
+        return !variable->is_reference() && !variable->position().isGlobal() && escaped.find(variable) == escaped.end();
+    }
+
+    return true;
+}
+
+std::vector<std::shared_ptr<Variable>> defined(mtac::Quadruple& quadruple){
+    if(quadruple.op == mtac::Operator::CALL){
+        std::vector<std::shared_ptr<Variable>> variables;
+
+        if(quadruple.return1()){
+            variables.push_back(quadruple.return1());
+        }
+
+        if(quadruple.return2()){
+            variables.push_back(quadruple.return2());
+        }
+
+        return variables;
+    } else if(quadruple.result && mtac::erase_result(quadruple.op)){
+        return {quadruple.result};
+    }
+
+    return {};
+}
+
+void collect(mtac::Function& function, const mtac::escaped_variables& escaped, local_properties& local){
+    for(auto& block : function){
+        for(auto& quadruple : block->statements){
+            if(quadruple.op >= mtac::Operator::ADD && quadruple.op <= mtac::Operator::FDIV && quadruple.result && quadruple.arg2 && mtac::is_interesting(quadruple)){
+                if(!is_candidate_operand(*quadruple.arg1, escaped) || !is_candidate_operand(*quadruple.arg2, escaped)){
+                    continue;
+                }
+
+                auto key = local.key(quadruple);
+                auto it = local.indices.find(key);
+
+                if(it == local.indices.end()){
+                    local.indices[key] = local.expressions.size();
+                    local.expressions.push_back({std::get<0>(key), std::get<1>(key), std::get<2>(key), quadruple.result->type(), true});
+
+                    for(auto* arg : {&std::get<1>(key), &std::get<2>(key)}){
+                        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(arg)){
+                            local.dependents[*ptr].push_back(local.expressions.size() - 1);
+                        }
+                    }
+                } else if(local.expressions[it->second].type != quadruple.result->type()){
+                    //The temporary could not hold all the computations
+                    local.expressions[it->second].valid = false;
+                }
+            }
+        }
+    }
+
+    auto n = local.size();
+
+    for(auto& block : function){
+        mtac::ExpressionBits antloc(n);
+        mtac::ExpressionBits comp(n);
+        mtac::ExpressionBits transp(n);
+        transp.set();
+
+        for(auto& quadruple : block->statements){
+            auto i = local.index(quadruple);
+
+            if(i < n){
+                if(transp[i]){
+                    antloc[i] = true;
+                }
+
+                comp[i] = true;
+            }
+
+            for(auto& variable : defined(quadruple)){
+                auto it = local.dependents.find(variable);
+
+                if(it != local.dependents.end()){
+                    for(auto k : it->second){
+                        transp[k] = false;
+                        comp[k] = false;
+                    }
+                }
+            }
+        }
+
+        local.antloc[block] = std::move(antloc);
+        local.comp[block] = std::move(comp);
+        local.transp[block] = std::move(transp);
+    }
+}
+
+typedef mtac::Domain<mtac::ExpressionBits> ProblemDomain;
+
+mtac::ExpressionBits values(const ProblemDomain& domain, std::size_t n){
+    if(domain.top()){
+        return mtac::ExpressionBits(n).set();
+    }
+
+    return domain.values();
+}
+
+void intersection(ProblemDomain& in, const ProblemDomain& out){
+    if(in.top()){
+        in = out;
+    } else if(!out.top()){
+        in.values() &= out.values();
+    }
+}
+
+struct availability_problem {
+    typedef ::ProblemDomain ProblemDomain;
+
+    STATIC_CONSTANT(mtac::DataFlowType, Type, mtac::DataFlowType::Fast_Forward_Block);
+    STATIC_CONSTANT(bool, Low, false);
+
+    local_properties& local;
+
+    availability_problem(local_properties& local) : local(local) {}
+
+    ProblemDomain Boundary(mtac::Function& /*function*/){
+        return ProblemDomain(mtac::ExpressionBits(local.size()));
+    }
+
+    ProblemDomain Init(mtac::Function& /*function*/){
+        return ProblemDomain();
+    }
+
+    void meet(ProblemDomain& in, const ProblemDomain& out){
+        intersection(in, out);
+    }
+
+    //OUT = COMP U (IN & TRANSP)
+    void transfer(mtac::basic_block_p block, ProblemDomain& x){
+        auto bits = values(x, local.size());
+
+        x = ProblemDomain(local.comp[block] | (bits & local.transp[block]));
+    }
+};
+
+struct anticipability_problem {
+    typedef ::ProblemDomain ProblemDomain;
+
+    STATIC_CONSTANT(mtac::DataFlowType, Type, mtac::DataFlowType::Fast_Backward_Block);
+    STATIC_CONSTANT(bool, Low, false);
+
+    local_properties& local;
+
+    anticipability_problem(local_properties& local) : local(local) {}
+
+    ProblemDomain Boundary(mtac::Function& /*function*/){
+        return ProblemDomain(mtac::ExpressionBits(local.size()));
+    }
+
+    ProblemDomain Init(mtac::Function& /*function*/){
+        return ProblemDomain();
+    }
+
+    void meet(ProblemDomain& in, const ProblemDomain& out){
+        intersection(in, out);
+    }
+
+    //IN = ANTLOC U (OUT & TRANSP)
+    void transfer(mtac::basic_block_p block, ProblemDomain& x){
+        auto bits = values(x, local.size());
+
+        x = ProblemDomain(local.antloc[block] | (bits & local.transp[block]));
+    }
+};
+
+struct cfg_edge {
+    mtac::basic_block_p source;
+    mtac::basic_block_p target;
+    mtac::ExpressionBits insert;
+};
+
+struct code_motion {
+    mtac::Function& function;
+    local_properties& local;
+
+    BlockBits avout;
+    BlockBits antin;
+    BlockBits antout;
+    BlockBits laterin;
+
+    code_motion(mtac::Function& function, local_properties& local) : function(function), local(local) {}
+
+    bool is_entry(const mtac::basic_block_p& block) const {
+        return block == function.entry_bb();
+    }
+
+    //LATER(i, j) = EARLIEST(i, j) U (LATERIN(i) & !ANTLOC(i))
+    mtac::ExpressionBits later(const mtac::basic_block_p& i, const mtac::basic_block_p& j){
+        //EARLIEST(i, j) = ANTIN(j) & !AVOUT(i) & (!TRANSP(i) | !ANTOUT(i))
+        auto earliest = antin[j] & ~avout[i];
+
+        if(!is_entry(i)){
+            earliest &= ~local.transp[i] | ~antout[i];
+        }
+
+        return earliest | (laterin[i] & ~local.antloc[i]);
+    }
+
+    void compute_laterin(){
+        auto n = local.size();
+
+        for(auto& block : function){
+            laterin[block] = mtac::ExpressionBits(n);
+
+            if(!is_entry(block)){
+                laterin[block].set();
+            }
+        }
+
+        bool changes = true;
+        while(changes){
+            changes = false;
+
+            for(auto& block : function){
+                if(is_entry(block) || block->predecessors.empty()){
+                    continue;
+                }
+
+                mtac::ExpressionBits in(n);
+                in.set();
+
+                for(auto& pred : block->predecessors){
+                    in &= later(pred, block);
+                }
+
+                if(in != laterin[block]){
+                    laterin[block] = std::move(in);
+                    changes = true;
+                }
+            }
+        }
+    }
+
+    //INSERT(i, j) = LATER(i, j) & !LATERIN(j)
+    std::vector<cfg_edge> insertions(){
+        std::vector<cfg_edge> edges;
+
+        for(auto& block : function){
+            for(auto& succ : block->successors){
+                edges.push_back({block, succ, later(block, succ) & ~laterin[succ]});
+            }
+        }
+
+        return edges;
+    }
+
+    bool kills(mtac::Quadruple& quadruple, std::size_t k){
+        auto& e = local.expressions[k];
+
+        auto* lhs = boost::get<std::shared_ptr<Variable>>(&e.arg1);
+        auto* rhs = boost::get<std::shared_ptr<Variable>>(&e.arg2);
+
+        for(auto& variable : defined(quadruple)){
+            if((lhs && *lhs == variable) || (rhs && *rhs == variable)){
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //The upward exposed computation is replaced by a copy of the temporary
+    void remove(mtac::basic_block_p block, std::size_t k, std::shared_ptr<Variable> tmp){
+        for(auto& quadruple : block->statements){
+            if(local.index(quadruple) == k){
+                LOG<Trace>("Optimizer") << "PRE: Replace " << quadruple << " with " << tmp << log::endl;
+
+                quadruple.op = mtac::assign_op(quadruple.op);
+                quadruple.arg1 = tmp;
+                quadruple.arg2.reset();
+
+                function.context->global()->stats().inc_counter("pre_eliminated");
+
+                return;
+            }
+
+            if(kills(quadruple, k)){
+                return;
+            }
+        }
+    }
+
+    //The downward exposed computation must save its value in the temporary
+    void save(mtac::basic_block_p block, std::size_t k, std::shared_ptr<Variable> tmp){
+        auto& statements = block->statements;
+
+        for(std::size_t i = statements.size(); i-- > 0;){
+            auto& quadruple = statements[i];
+
+            if(local.index(quadruple) == k){
+                auto result = quadruple.result;
+                auto op = mtac::assign_op(quadruple.op);
+
+                quadruple.result = tmp;
+                statements.insert(statements.begin() + i + 1, mtac::Quadruple(result, tmp, op));
+
+                return;
+            }
+
+            if(kills(quadruple, k)){
+                return;
+            }
+        }
+    }
+
+    void insert(const cfg_edge& edge, std::size_t k, std::shared_ptr<Variable> tmp){
+        auto& e = local.expressions[k];
+
+        mtac::Quadruple quadruple(tmp, e.arg1, e.op, e.arg2);
+
+        if(edge.target->predecessors.size() == 1){
+            auto& statements = edge.target->statements;
+            statements.insert(statements.begin(), std::move(quadruple));
+        } else {
+            auto& statements = edge.source->statements;
+
+            if(!statements.empty() && (statements.back().op == mtac::Operator::GOTO || statements.back().is_if() || statements.back().is_if_false())){
+                statements.insert(statements.end() - 1, std::move(quadruple));
+            } else {
+                statements.push_back(std::move(quadruple));
+            }
+        }
+    }
+
+    bool optimize(std::vector<cfg_edge>& edges){
+        bool optimized = false;
+
+        for(std::size_t k = 0; k < local.size(); ++k){
+            auto& e = local.expressions[k];
+
+            if(!e.valid){
+                continue;
+            }
+
+            //DELETE(b) = ANTLOC(b) & !LATERIN(b)
+            std::vector<mtac::basic_block_p> deleted;
+
+            for(auto& block : function){
+                if(!is_entry(block) && local.antloc[block][k] && !laterin[block][k]){
+                    deleted.push_back(block);
+                }
+            }
+
+            if(deleted.empty()){
+                continue;
+            }
+
+            //A computation cannot be inserted on a critical edge without splitting it
+            bool critical = false;
+
+            for(auto& edge : edges){
+                if(edge.insert[k] && edge.target->predecessors.size() > 1 && edge.source->successors.size() > 1){
+                    critical = true;
+                    break;
+                }
+            }
+
+            if(critical){
+                continue;
+            }
+
+            auto tmp = function.context->new_temporary(e.type);
+
+            for(auto& block : deleted){
+                remove(block, k, tmp);
+            }
+
+            for(auto& block : function){
+                if(local.comp[block][k]){
+                    save(block, k, tmp);
+                }
+            }
+
+            for(auto& edge : edges){
+                if(edge.insert[k]){
+                    insert(edge, k, tmp);
+                }
+            }
+
+            optimized = true;
+        }
+
+        return optimized;
+    }
+};
+
+} //end of anonymous namespace
+
+bool mtac::lazy_code_motion::operator()(mtac::Function& function){
+    auto escaped = mtac::escape_analysis(function);
+
+    local_properties local;
+    collect(function, *escaped, local);
+
+    if(local.expressions.empty()){
+        return false;
+    }
+
+    availability_problem availability(local);
+    auto available = mtac::data_flow(function, availability);
+
+    anticipability_problem anticipability(local);
+    auto anticipated = mtac::data_flow(function, anticipability);
+
+    code_motion motion(function, local);
+
+    auto n = local.size();
+
+    for(auto& block : function){
+        if(block != function.exit_bb()){
+            //The anticipability is meaningless in the blocks that cannot reach the exit
+            if(anticipated->OUT[block].top()){
+                return false;
+            }
+
+            motion.antout[block] = anticipated->OUT[block].values();
+        }
+
+        motion.antin[block] = values(anticipated->IN[block], n);
+        motion.avout[block] = values(available->OUT[block], n);
+    }
+
+    motion.compute_laterin();
+
+    auto edges = motion.insertions();
+
+    return motion.optimize(edges);
+}
+
+bool mtac::operator==(const mtac::Domain<mtac::ExpressionBits>& lhs, const mtac::Domain<mtac::ExpressionBits>& rhs){
+    if(lhs.top() || rhs.top()){
+        return lhs.top() == rhs.top();
+    }
+
+    return lhs.values() == rhs.values();
+}
+
+bool mtac::operator!=(const mtac::Domain<mtac::ExpressionBits>& lhs, const mtac::Domain<mtac::ExpressionBits>& rhs){
+    return !(lhs == rhs);
+}
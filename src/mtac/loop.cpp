@@ -121,7 +121,7 @@ mtac::basic_block_p mtac::loop::find_safe_preheader(mtac::Function& function, bo
 
     if(pred){
         //It must be the only successor and a fall through edge
-        if(pred->successors.size() == 1 && pred->next == first_bb){
+        if(pred->successors.size() == 1 && pred->next() == first_bb){
             LOG<Trace>("Control-Flow") << "Found " << *pred << " as safe preheader of " << *this << log::endl;
 
             return pred;
@@ -141,6 +141,8 @@ mtac::basic_block_p mtac::loop::find_safe_preheader(mtac::Function& function, bo
     auto predecessors = first_bb->predecessors;
     for(auto& pred : predecessors){
         if(blocks().find(pred) == blocks().end()){
+            pre_header->frequency += pred->frequency;
+
             mtac::remove_edge(pred, first_bb);
             mtac::make_edge(pred, pre_header);
 
@@ -152,6 +154,9 @@ mtac::basic_block_p mtac::loop::find_safe_preheader(mtac::Function& function, bo
         }
     }
 
+    //The loop is not entered more often than its header is executed
+    pre_header->frequency = std::min(pre_header->frequency, first_bb->frequency);
+
     function.insert_before(function.at(first_bb), pre_header);
 
     //Create the fall through edge
@@ -470,7 +470,7 @@ void find_loops(mtac::Function& function){
             //A node dominates itself
             if(block == succ){
                 back_edges.emplace_back(block, succ);
-            } else if(block->dominator == succ){
+            } else if(block->dominator() == succ){
                 back_edges.emplace_back(block, succ);
             }
         }
@@ -0,0 +1,405 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "iterators.hpp"
+#include "logging.hpp"
+#include "Options.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+
+#include "mtac/Function.hpp"
+#include "mtac/Program.hpp"
+#include "mtac/loop.hpp"
+#include "mtac/loop_idioms.hpp"
+#include "mtac/memory_intrinsics.hpp"
+#include "mtac/variable_usage.hpp"
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//An affine value of the form e * i + d, with i the value of the induction variable at the start of the iteration
+struct Affine {
+    int e;
+    int d;
+};
+
+typedef std::unordered_map<std::shared_ptr<Variable>, Affine> AffineValues;
+
+bool written_in(mtac::basic_block_p bb, std::shared_ptr<Variable> var){
+    for(auto& quadruple : bb->statements){
+        if(quadruple.result == var && mtac::erase_result(quadruple.op)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool invariant(mtac::basic_block_p bb, const mtac::Argument& arg){
+    if(boost::get<int>(&arg)){
+        return true;
+    }
+
+    if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+        return !written_in(bb, *ptr);
+    }
+
+    return false;
+}
+
+bool uses(mtac::Quadruple& quadruple, std::shared_ptr<Variable> var){
+    return quadruple.result == var
+        || (quadruple.arg1 && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, var))
+        || (quadruple.arg2 && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg2, var));
+}
+
+bool affine_of(AffineValues& values, const mtac::Argument& arg, Affine& result){
+    if(auto* ptr = boost::get<int>(&arg)){
+        result = {0, *ptr};
+        return true;
+    }
+
+    if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+        auto it = values.find(*ptr);
+
+        if(it != values.end()){
+            result = it->second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief The description of a recognized copy or fill loop.
+ */
+struct Idiom {
+    std::shared_ptr<Variable> i;
+    mtac::Argument n;
+
+    std::shared_ptr<Variable> dest;
+    int dest_offset;
+
+    //Only for a copy
+    std::shared_ptr<Variable> src;
+    int src_offset;
+
+    //Only for a fill
+    boost::optional<mtac::Argument> value;
+
+    int element_size;
+};
+
+/*!
+ * \brief Recognize the body of the loop.
+ *
+ * The body must be made only of affine computations of the induction variable, one load and one store of the
+ * same element (copy) or one store of an invariant value (fill), the increment of the induction variable and the
+ * final comparison to the bound.
+ */
+bool match_body(mtac::basic_block_p bb, int int_size, Idiom& idiom){
+    auto& condition = bb->statements.back();
+
+    if(condition.op != mtac::Operator::IF_LESS || condition.block != bb || !mtac::isVariable(*condition.arg1)){
+        return false;
+    }
+
+    idiom.i = boost::get<std::shared_ptr<Variable>>(*condition.arg1);
+    idiom.n = *condition.arg2;
+
+    if(idiom.i->type() != INT || !invariant(bb, idiom.n)){
+        return false;
+    }
+
+    AffineValues values;
+    values[idiom.i] = {1, 0};
+
+    bool incremented = false;
+    mtac::Quadruple* load = nullptr;
+    mtac::Quadruple* store = nullptr;
+
+    for(std::size_t s = 0; s + 1 < bb->statements.size(); ++s){
+        auto& quadruple = bb->statements[s];
+
+        if(quadruple.op == mtac::Operator::NOP){
+            continue;
+        }
+
+        //The increment of the induction variable
+        if(quadruple.result == idiom.i){
+            if(incremented || quadruple.op != mtac::Operator::ADD){
+                return false;
+            }
+
+            if(!(mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, idiom.i) && mtac::equals<int>(*quadruple.arg2, 1))
+                    && !(mtac::equals<int>(*quadruple.arg1, 1) && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg2, idiom.i))){
+                return false;
+            }
+
+            incremented = true;
+            values[idiom.i] = {1, 1};
+
+            continue;
+        }
+
+        Affine lhs;
+        Affine rhs;
+
+        switch(quadruple.op){
+            case mtac::Operator::ASSIGN:
+                if(!affine_of(values, *quadruple.arg1, lhs)){
+                    return false;
+                }
+
+                values[quadruple.result] = lhs;
+
+                break;
+            case mtac::Operator::ADD:
+            case mtac::Operator::SUB:
+                if(!affine_of(values, *quadruple.arg1, lhs) || !affine_of(values, *quadruple.arg2, rhs)){
+                    return false;
+                }
+
+                if(quadruple.op == mtac::Operator::ADD){
+                    values[quadruple.result] = {lhs.e + rhs.e, lhs.d + rhs.d};
+                } else {
+                    values[quadruple.result] = {lhs.e - rhs.e, lhs.d - rhs.d};
+                }
+
+                break;
+            case mtac::Operator::MUL:
+                if(!affine_of(values, *quadruple.arg1, lhs) || !affine_of(values, *quadruple.arg2, rhs)){
+                    return false;
+                }
+
+                if(lhs.e != 0 && rhs.e != 0){
+                    return false;
+                }
+
+                values[quadruple.result] = {lhs.e * rhs.d + rhs.e * lhs.d, lhs.d * rhs.d};
+
+                break;
+            case mtac::Operator::DOT:
+                if(load){
+                    return false;
+                }
+
+                load = &quadruple;
+
+                break;
+            case mtac::Operator::DOT_ASSIGN:
+            case mtac::Operator::DOT_FASSIGN:
+                if(store){
+                    return false;
+                }
+
+                store = &quadruple;
+
+                break;
+            default:
+                return false;
+        }
+
+        //The load and the store must be on the current element, not on the next one
+        if((quadruple.op == mtac::Operator::DOT || quadruple.op == mtac::Operator::DOT_ASSIGN || quadruple.op == mtac::Operator::DOT_FASSIGN) && incremented){
+            return false;
+        }
+    }
+
+    if(!incremented || !store || !store->result->type()->is_array()){
+        return false;
+    }
+
+    idiom.dest = store->result;
+    idiom.element_size = store->size == tac::Size::BYTE ? 1 : int_size;
+
+    Affine dest_offset;
+    if(!invariant(bb, idiom.dest) || !affine_of(values, *store->arg1, dest_offset) || dest_offset.e != idiom.element_size){
+        return false;
+    }
+
+    idiom.dest_offset = dest_offset.d;
+
+    if(load){
+        //Copy: the loaded value must only be stored
+        auto value = load->result;
+
+        if(!mtac::equals<std::shared_ptr<Variable>>(*store->arg2, value) || load->size != store->size){
+            return false;
+        }
+
+        if(!mtac::isVariable(*load->arg1)){
+            return false;
+        }
+
+        idiom.src = boost::get<std::shared_ptr<Variable>>(*load->arg1);
+
+        Affine src_offset;
+        if(!idiom.src->type()->is_array() || !invariant(bb, idiom.src) || !affine_of(values, *load->arg2, src_offset) || src_offset.e != idiom.element_size){
+            return false;
+        }
+
+        idiom.src_offset = src_offset.d;
+
+        for(auto& quadruple : bb->statements){
+            if(&quadruple != store && &quadruple != load && uses(quadruple, value)){
+                return false;
+            }
+        }
+    } else {
+        //Fill: the stored value must be invariant and fit in an int
+        if(store->op != mtac::Operator::DOT_ASSIGN || !invariant(bb, *store->arg2) || mtac::isFloat(*store->arg2)){
+            return false;
+        }
+
+        auto data_type = idiom.dest->type()->data_type();
+        if(data_type != INT && data_type != CHAR && data_type != BOOL){
+            return false;
+        }
+
+        idiom.value = *store->arg2;
+    }
+
+    return true;
+}
+
+//The loop is only entered when i < n, otherwise the body would be executed once
+bool guarded(mtac::loop& loop, Idiom& idiom){
+    if(loop.has_estimate()){
+        return true;
+    }
+
+    auto preheader = loop.find_preheader();
+
+    if(!preheader || preheader->statements.empty()){
+        return false;
+    }
+
+    auto& guard = preheader->statements.back();
+
+    if(guard.op != mtac::Operator::IF_FALSE_LESS && guard.op != mtac::Operator::IF_GREATER_EQUALS){
+        return false;
+    }
+
+    return mtac::equals<std::shared_ptr<Variable>>(*guard.arg1, idiom.i) && *guard.arg2 == idiom.n;
+}
+
+//All the temporaries computed in the loop must be dead after the loop
+bool local_temporaries(mtac::Function& function, mtac::basic_block_p bb, Idiom& idiom){
+    for(auto& quadruple : bb->statements){
+        if(quadruple.result && quadruple.result != idiom.i && mtac::erase_result(quadruple.op)){
+            for(auto& block : function){
+                if(block != bb && mtac::use_variable(block, quadruple.result)){
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+mtac::Argument offset_of(mtac::Function& function, std::vector<mtac::Quadruple>& statements, std::shared_ptr<Variable> i, int element_size, int offset){
+    auto temp = function.context->new_temporary(INT);
+
+    statements.emplace_back(temp, i, mtac::Operator::MUL, element_size);
+    statements.emplace_back(temp, temp, mtac::Operator::ADD, offset);
+
+    return temp;
+}
+
+} //end of anonymous namespace
+
+bool mtac::loop_idioms::gate(std::shared_ptr<Configuration> configuration){
+    return configuration->option_defined("fmemory-idioms");
+}
+
+bool mtac::loop_idioms::operator()(mtac::Function& function){
+    if(function.loops().empty()){
+        return false;
+    }
+
+    bool optimized = false;
+
+    auto global_context = function.context->global();
+    int int_size = INT->size(global_context->target_platform());
+
+    auto lit = iterate(function.loops());
+
+    while(lit.has_next()){
+        auto& loop = *lit;
+
+        if(loop.blocks().size() == 1){
+            auto bb = *loop.begin();
+
+            Idiom idiom;
+            if(!bb->statements.empty() && match_body(bb, int_size, idiom) && guarded(loop, idiom) && local_temporaries(function, bb, idiom)){
+                std::vector<mtac::Quadruple> statements;
+
+                //The loop executes n - i times, i being its value at the entry of the loop
+                auto bytes = function.context->new_temporary(INT);
+                statements.emplace_back(bytes, idiom.n, mtac::Operator::SUB, idiom.i);
+                if(idiom.element_size != 1){
+                    statements.emplace_back(bytes, bytes, mtac::Operator::MUL, idiom.element_size);
+                }
+
+                auto dest_offset = offset_of(function, statements, idiom.i, idiom.element_size, idiom.dest_offset);
+
+                std::string helper_name;
+                if(idiom.src){
+                    auto src_offset = offset_of(function, statements, idiom.i, idiom.element_size, idiom.src_offset);
+
+                    helper_name = mtac::memcpy_helper;
+                    mtac::emit_memcpy(statements, global_context->getFunction(helper_name), idiom.dest, dest_offset, idiom.src, src_offset, bytes);
+
+                    global_context->stats().inc_counter("copy_loop_replaced");
+                } else {
+                    //The helper always takes the value as a full integer
+                    auto value = *idiom.value;
+                    if(idiom.element_size == 1 && mtac::isVariable(value)){
+                        auto temp = function.context->new_temporary(INT);
+                        statements.emplace_back(temp, value, mtac::Operator::ASSIGN);
+                        value = temp;
+                    }
+
+                    helper_name = mtac::memset_helper;
+                    mtac::emit_memset(statements, global_context->getFunction(helper_name), idiom.dest, dest_offset, value, bytes, idiom.element_size);
+
+                    global_context->stats().inc_counter("fill_loop_replaced");
+                }
+
+                //The induction variable has its final value
+                statements.emplace_back(idiom.i, idiom.n, mtac::Operator::ASSIGN);
+
+                bb->statements = std::move(statements);
+
+                program.cg.add_edge(function.definition(), global_context->getFunction(helper_name));
+
+                LOG<Trace>("loops") << "Replace loop by a call to " << helper_name << log::endl;
+
+                //It is not a loop anymore
+                mtac::remove_edge(bb, bb);
+
+                lit.erase();
+
+                optimized = true;
+
+                continue;
+            }
+        }
+
+        ++lit;
+    }
+
+    return optimized;
+}
@@ -74,7 +74,7 @@ bool is_valid_invariant(mtac::basic_block_p source_bb, mtac::Quadruple& quadrupl
         //A bb always dominates itself => no need to consider the source basic block
         if(bb != source_bb){
             if(use_variable(bb, var)){
-                auto dominator = bb->dominator;
+                auto dominator = bb->dominator();
 
                 //If the bb is not dominated by the source bb, it is not valid
                 if(dominator != source_bb){
@@ -96,7 +96,7 @@ bool is_valid_invariant(mtac::basic_block_p source_bb, mtac::Quadruple& quadrupl
         return true;
     }
 
-    auto dominator = exit_block->dominator;
+    auto dominator = exit_block->dominator();
 
     //If the exit bb is not dominated by the source bb, it is not valid
     if(dominator != source_bb){
@@ -12,6 +12,8 @@
 #include "mtac/Function.hpp"
 #include "mtac/loop.hpp"
 #include "mtac/loop_unrolling.hpp"
+#include "mtac/profile.hpp"
+#include "mtac/Program.hpp"
 #include "mtac/Utils.hpp"
 
 using namespace eddic;
@@ -31,11 +33,18 @@ bool mtac::loop_unrolling::operator()(mtac::Function& function){
         if(loop.has_estimate() && loop.blocks().size() == 1){
             auto it = loop.estimate();
 
+            auto bb = *loop.begin();
+
+            //A loop that has never been executed is not worth the code growth
+            if(mtac::cold(program, bb)){
+                continue;
+            }
+
             if(it > 100){
-                auto bb = *loop.begin();
+                //Do not increase too much the size of the body, unless the loop is hot
+                std::size_t max_size = mtac::hot(program, bb) ? 40 : 20;
 
-                //Do not increase too much the size of the body
-                if(bb->statements.size() < 20){
+                if(bb->statements.size() < max_size){
                     unsigned int factor = 0;
                     if((it % 8) == 0){
                         factor = 8;
@@ -61,23 +61,23 @@ bool mtac::loop_unswitching::operator()(mtac::Function& function){
                             auto loop_1_entry = entry->successors.front();
                             auto loop_2_entry = entry->successors.back();
 
-                            if(loop_2_entry->next == loop_1_entry){
+                            if(loop_2_entry->next() == loop_1_entry){
                                 std::swap(loop_1_entry, loop_2_entry);
                             }
                             
-                            entry->predecessors.erase(std::remove(entry->predecessors.begin(), entry->predecessors.end(), entry), entry->predecessors.end());
+                            entry->predecessors.remove(entry);
 
                             auto exit_copy = mtac::clone(function, exit);
                             
-                            entry->successors.erase(std::remove(entry->successors.begin(), entry->successors.end(), exit), entry->successors.end());
+                            entry->successors.remove(exit);
 
-                            exit->successors.erase(std::remove(exit->successors.begin(), exit->successors.end(), entry), exit->successors.end());
+                            exit->successors.remove(entry);
                             exit->successors.push_back(loop_2_entry);
                             
-                            exit_copy->successors.erase(std::remove(exit_copy->successors.begin(), exit_copy->successors.end(), entry), exit_copy->successors.end());
+                            exit_copy->successors.remove(entry);
                             exit_copy->successors.push_back(loop_1_entry);
                             
-                            exit_copy->predecessors.erase(std::remove(exit_copy->predecessors.begin(), exit_copy->predecessors.end(), loop_2_entry), exit_copy->predecessors.end());
+                            exit_copy->predecessors.remove(loop_2_entry);
                             exit_copy->predecessors.pop_back();
 
                             mtac::BBClones bb_clones;
@@ -91,7 +91,7 @@ bool mtac::loop_unswitching::operator()(mtac::Function& function){
                             loop_1_entry->statements.pop_back();
                             loop_1_entry->predecessors.push_back(exit_copy);
 
-                            auto after_exit = exit->next;
+                            auto after_exit = exit->next();
 
                             mtac::Quadruple goto_(mtac::Operator::GOTO);
                             goto_.block = after_exit;
@@ -41,7 +41,7 @@ bool mtac::merge_basic_blocks::operator()(mtac::Function& function){
             break;
         }
                 
-        auto next = block->next;
+        auto next = block->next();
 
         if(cpp_unlikely(block->size_no_nop() == 0)){
             if(usage.find(block) == usage.end()){
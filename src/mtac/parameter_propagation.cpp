@@ -45,8 +45,8 @@ Arguments collect_arguments(mtac::Program& program){
                         mtac::basic_block::reverse_iterator end;
 
                         if(block->statements.front() == quadruple){
-                            it = block->prev->statements.rbegin();
-                            end = block->prev->statements.rend();
+                            it = block->prev()->statements.rbegin();
+                            end = block->prev()->statements.rend();
                         } else {
                             it = block->statements.rbegin();
                             end = block->statements.rend();
@@ -169,9 +169,9 @@ bool mtac::parameter_propagation::operator()(mtac::Program& program){
                                     mtac::basic_block::reverse_iterator end;
 
                                     if(block->statements.front() == quadruple){
-                                        param_block = block->prev;
-                                        it = block->prev->statements.rbegin();
-                                        end = block->prev->statements.rend();
+                                        param_block = block->prev();
+                                        it = block->prev()->statements.rbegin();
+                                        end = block->prev()->statements.rend();
                                     } else {
                                         param_block = block;
                                         it = block->statements.rbegin();
@@ -0,0 +1,166 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "Variable.hpp"
+#include "FunctionContext.hpp"
+#include "GlobalContext.hpp"
+#include "logging.hpp"
+#include "variant_utils.hpp"
+
+#include "mtac/partial_dead_code_elimination.hpp"
+#include "mtac/GlobalOptimizations.hpp"
+#include "mtac/LiveVariableAnalysisProblem.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/Quadruple.hpp"
+
+using namespace eddic;
+
+namespace {
+
+bool sinkable(mtac::Operator op){
+    return op == mtac::Operator::ASSIGN || op == mtac::Operator::FASSIGN
+        || (op >= mtac::Operator::ADD && op <= mtac::Operator::FDIV)
+        || op == mtac::Operator::MINUS || op == mtac::Operator::FMINUS
+        || op == mtac::Operator::I2F || op == mtac::Operator::F2I;
+}
+
+bool local(const std::shared_ptr<Variable>& variable, const mtac::escaped_variables& escaped){
+    return !variable->is_reference() && !variable->position().isGlobal() && escaped.find(variable) == escaped.end();
+}
+
+bool local(const boost::optional<mtac::Argument>& arg, const mtac::escaped_variables& escaped){
+    if(arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*arg)){
+            return local(*ptr, escaped);
+        }
+    }
+
+    return true;
+}
+
+bool uses(const boost::optional<mtac::Argument>& arg, const std::shared_ptr<Variable>& variable){
+    if(arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*arg)){
+            return *ptr == variable;
+        }
+    }
+
+    return false;
+}
+
+bool uses(mtac::Quadruple& quadruple, const std::shared_ptr<Variable>& variable){
+    return uses(quadruple.arg1, variable) || uses(quadruple.arg2, variable) || (!mtac::erase_result(quadruple.op) && quadruple.result == variable);
+}
+
+bool defines(mtac::Quadruple& quadruple, const std::shared_ptr<Variable>& variable){
+    if(quadruple.op == mtac::Operator::CALL){
+        return quadruple.return1() == variable || quadruple.return2() == variable;
+    }
+
+    return mtac::erase_result(quadruple.op) && quadruple.result == variable;
+}
+
+bool defines(mtac::Quadruple& quadruple, const boost::optional<mtac::Argument>& arg){
+    if(arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*arg)){
+            return defines(quadruple, *ptr);
+        }
+    }
+
+    return false;
+}
+
+//The statement can be moved to the end of the block
+bool movable(mtac::statement_list& statements, std::size_t i){
+    auto& quadruple = statements[i];
+
+    for(std::size_t j = i + 1; j < statements.size(); ++j){
+        auto& next = statements[j];
+
+        if(uses(next, quadruple.result) || defines(next, quadruple.result) || defines(next, quadruple.arg1) || defines(next, quadruple.arg2)){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void add_uses(mtac::Values& live, mtac::Quadruple& quadruple){
+    if_init<std::shared_ptr<Variable>>(quadruple.arg1, [&live](std::shared_ptr<Variable>& var){ live.insert(var); });
+    if_init<std::shared_ptr<Variable>>(quadruple.arg2, [&live](std::shared_ptr<Variable>& var){ live.insert(var); });
+}
+
+} //end of anonymous namespace
+
+bool mtac::partial_dead_code_elimination::operator()(mtac::Function& function){
+    mtac::LiveVariableAnalysisProblem problem;
+    auto results = mtac::data_flow(function, problem);
+
+    auto& escaped = *problem.pointer_escaped;
+
+    bool optimized = false;
+
+    for(auto& block : function){
+        if(block->successors.size() != 2){
+            continue;
+        }
+
+        auto first = block->successors[0];
+        auto second = block->successors[1];
+
+        if(first == second || results->IN[first].top() || results->IN[second].top()){
+            continue;
+        }
+
+        //The live variables are updated as statements are sunk
+        auto first_live = results->IN[first].values();
+        auto second_live = results->IN[second].values();
+
+        auto& statements = block->statements;
+
+        for(std::size_t i = statements.size(); i-- > 0;){
+            auto& quadruple = statements[i];
+
+            if(!sinkable(quadruple.op) || !quadruple.result || !local(quadruple.result, escaped)){
+                continue;
+            }
+
+            if(!local(quadruple.arg1, escaped) || !local(quadruple.arg2, escaped)){
+                continue;
+            }
+
+            bool in_first = first_live.count(quadruple.result);
+            bool in_second = second_live.count(quadruple.result);
+
+            //Dead on both paths is the job of the DCE
+            if(in_first == in_second){
+                continue;
+            }
+
+            auto target = in_first ? first : second;
+            auto& live = in_first ? first_live : second_live;
+
+            if(target == block || target->index == -2 || target->predecessors.size() != 1 || !movable(statements, i)){
+                continue;
+            }
+
+            LOG<Trace>("Optimizer") << "Sink " << quadruple << " into B" << target->index << log::endl;
+
+            add_uses(live, quadruple);
+
+            auto sunk = std::move(quadruple);
+            statements.erase(statements.begin() + i);
+            target->statements.insert(target->statements.begin(), std::move(sunk));
+
+            function.context->global()->stats().inc_counter("partially_dead_sunk");
+            optimized = true;
+        }
+    }
+
+    return optimized;
+}
@@ -0,0 +1,166 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <fstream>
+#include <vector>
+
+#include "logging.hpp"
+#include "timing.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "Warnings.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+
+#include "mtac/profile.hpp"
+#include "mtac/Program.hpp"
+#include "mtac/Quadruple.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//Name of the global array holding the counters of the instrumented program
+const char* const profile_counters = "__profile_counters";
+
+std::size_t count_blocks(mtac::Program& program){
+    std::size_t blocks = 0;
+
+    for(auto& function : program.functions){
+        for(auto& bb : function){
+            if(bb->index >= 0){
+                ++blocks;
+            }
+        }
+    }
+
+    return blocks;
+}
+
+//The counters are dumped with the native size and endianness of the target
+std::vector<std::size_t> read_counters(std::ifstream& stream, unsigned int int_size){
+    std::vector<std::size_t> counters;
+
+    unsigned char buffer[8];
+
+    while(stream.read(reinterpret_cast<char*>(buffer), int_size)){
+        std::size_t value = 0;
+
+        for(unsigned int i = int_size; i > 0; --i){
+            value = (value << 8) | buffer[i - 1];
+        }
+
+        counters.push_back(value);
+    }
+
+    return counters;
+}
+
+} //end of anonymous namespace
+
+void mtac::instrument_profile(mtac::Program& program, const std::string& file){
+    timing_timer timer(program.context->timing(), "profile_instrumentation");
+
+    auto blocks = count_blocks(program);
+
+    if(!blocks){
+        return;
+    }
+
+    auto counters = program.context->addVariable(profile_counters, new_array_type(INT, blocks));
+    int int_size = INT->size(program.context->target_platform());
+
+    std::size_t block = 0;
+
+    for(auto& function : program.functions){
+        for(auto& bb : function){
+            if(bb->index >= 0){
+                //Skip the size of the array
+                int offset = int_size + block * int_size;
+                ++block;
+
+                auto count = function.context->new_temporary(INT);
+
+                std::vector<mtac::Quadruple> increment;
+                increment.emplace_back(count, counters, mtac::Operator::DOT, offset);
+                increment.emplace_back(count, count, mtac::Operator::ADD, 1);
+                increment.emplace_back(counters, offset, mtac::Operator::DOT_ASSIGN, count);
+
+                bb->statements.insert(bb->statements.begin(), increment.begin(), increment.end());
+            }
+        }
+    }
+
+    program.profile_file = file;
+
+    LOG<Debug>("Profile") << "Instrumented " << blocks << " basic blocks" << log::endl;
+}
+
+void mtac::load_profile(mtac::Program& program, const std::string& file){
+    timing_timer timer(program.context->timing(), "profile_loading");
+
+    std::ifstream stream(file.c_str(), std::ios::binary);
+
+    if(!stream){
+        warn("The profile \"" + file + "\" cannot be read, it is ignored");
+        return;
+    }
+
+    auto blocks = count_blocks(program);
+    auto counters = read_counters(stream, INT->size(program.context->target_platform()));
+
+    //The first value is the size of the counters array
+    if(counters.size() != blocks + 1 || counters[0] != blocks){
+        warn("The profile \"" + file + "\" does not match the program, it is ignored");
+        return;
+    }
+
+    std::size_t block = 1;
+    std::size_t max = 0;
+
+    for(auto& function : program.functions){
+        std::size_t calls = 0;
+
+        for(auto& bb : function){
+            if(bb->index >= 0){
+                bb->frequency = counters[block++];
+                max = std::max(max, bb->frequency);
+
+                if(bb == function.entry_bb()->next()){
+                    calls = bb->frequency;
+                }
+            }
+        }
+
+        function.entry_bb()->frequency = calls;
+        function.exit_bb()->frequency = calls;
+
+        //Each call site is executed as many times as its block
+        for(auto& bb : function){
+            for(auto& quadruple : bb->statements){
+                if(quadruple.op == mtac::Operator::CALL){
+                    if(auto edge = program.cg.edge(function.definition(), quadruple.function())){
+                        edge->frequency += bb->frequency;
+                    }
+                }
+            }
+        }
+    }
+
+    program.profiled = true;
+    program.hot_frequency = std::max<std::size_t>(1, max / 10);
+
+    LOG<Debug>("Profile") << "Loaded the counts of " << blocks << " basic blocks" << log::endl;
+}
+
+bool mtac::cold(const mtac::Program& program, const mtac::basic_block_p& bb){
+    return program.profiled && bb->frequency == 0;
+}
+
+bool mtac::hot(const mtac::Program& program, const mtac::basic_block_p& bb){
+    return program.profiled && bb->frequency >= program.hot_frequency;
+}
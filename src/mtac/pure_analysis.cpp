@@ -52,6 +52,13 @@ bool edit_global_variables(mtac::Function& function){
                     return true;
                 }
             }
+
+            //Stores into global arrays (the profile counters for instance)
+            if(quadruple.op == mtac::Operator::DOT_ASSIGN || quadruple.op == mtac::Operator::DOT_FASSIGN || quadruple.op == mtac::Operator::DOT_PASSIGN){
+                if(quadruple.result->position().isGlobal()){
+                    return true;
+                }
+            }
         }
     }
 
@@ -54,7 +54,7 @@ bool mtac::remove_empty_functions::operator()(mtac::Program& program){
                             if(parameters > 0){
                                 //The parameters are in the previous block
                                 if(fit == block->statements.begin()){
-                                    auto previous = block->prev;
+                                    auto previous = block->prev();
 
                                     auto fend = previous->statements.end();
                                     --fend;
@@ -0,0 +1,149 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "cpp_utils/assert.hpp"
+
+#include "mtac/statement_list.hpp"
+
+using namespace eddic;
+
+mtac::statement_list& mtac::statement_list::operator=(const statement_list& rhs){
+    if(this != &rhs){
+        unindex(0);
+        statements = rhs.statements;
+        reindex(0);
+    }
+
+    return *this;
+}
+
+mtac::statement_list& mtac::statement_list::operator=(statement_list&& rhs){
+    if(this != &rhs){
+        unindex(0);
+        statements = std::move(rhs.statements);
+        rhs.statements.clear();
+        reindex(0);
+    }
+
+    return *this;
+}
+
+mtac::statement_list& mtac::statement_list::operator=(container_type&& rhs){
+    unindex(0);
+    statements = std::move(rhs);
+    reindex(0);
+
+    return *this;
+}
+
+void mtac::statement_list::pop_back(){
+    if(pool){
+        pool->unindex(statements.back().uid(), id);
+    }
+
+    statements.pop_back();
+}
+
+mtac::statement_list::iterator mtac::statement_list::insert(const_iterator position, const mtac::Quadruple& quadruple){
+    auto offset = position - statements.cbegin();
+    statements.insert(position, quadruple);
+    reindex(offset);
+    return statements.begin() + offset;
+}
+
+mtac::statement_list::iterator mtac::statement_list::insert(const_iterator position, mtac::Quadruple&& quadruple){
+    auto offset = position - statements.cbegin();
+    statements.insert(position, std::move(quadruple));
+    reindex(offset);
+    return statements.begin() + offset;
+}
+
+mtac::statement_list::iterator mtac::statement_list::erase(const_iterator position){
+    return erase(position, position + 1);
+}
+
+mtac::statement_list::iterator mtac::statement_list::erase(const_iterator first, const_iterator last){
+    auto offset = first - statements.cbegin();
+
+    if(pool){
+        for(auto it = first; it != last; ++it){
+            pool->unindex(it->uid(), id);
+        }
+    }
+
+    statements.erase(first, last);
+    reindex(offset);
+    return statements.begin() + offset;
+}
+
+void mtac::statement_list::clear(){
+    unindex(0);
+    statements.clear();
+}
+
+void mtac::statement_list::replace(mtac::Quadruple& statement, mtac::Quadruple&& replacement){
+    std::size_t i = &statement - statements.data();
+
+    cpp_assert(i < statements.size(), "The statement is not part of the list");
+
+    if(pool){
+        pool->unindex(statement.uid(), id);
+    }
+
+    statement = std::move(replacement);
+    index(i);
+}
+
+mtac::statement_list::iterator mtac::statement_list::find(std::size_t uid){
+    if(!pool){
+        return std::find_if(statements.begin(), statements.end(), [uid](auto& quadruple){ return quadruple.uid() == uid; });
+    }
+
+    auto it = indexed(uid);
+
+    //The statement may have been replaced through a reference, only this block needs to be indexed again
+    if(it == statements.end()){
+        reindex(0);
+        it = indexed(uid);
+    }
+
+    return it;
+}
+
+mtac::statement_list::iterator mtac::statement_list::indexed(std::size_t uid){
+    auto position = pool->find(uid);
+
+    if(position && position->first == id && position->second < statements.size() && statements[position->second].uid() == uid){
+        return statements.begin() + position->second;
+    }
+
+    return statements.end();
+}
+
+void mtac::statement_list::index(std::size_t i){
+    if(pool){
+        pool->index(statements[i].uid(), id, i);
+    }
+}
+
+void mtac::statement_list::reindex(std::size_t first){
+    if(pool){
+        for(std::size_t i = first; i < statements.size(); ++i){
+            pool->index(statements[i].uid(), id, i);
+        }
+    }
+}
+
+void mtac::statement_list::unindex(std::size_t first){
+    if(pool){
+        for(std::size_t i = first; i < statements.size(); ++i){
+            pool->unindex(statements[i].uid(), id);
+        }
+    }
+}
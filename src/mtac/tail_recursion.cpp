@@ -0,0 +1,225 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "logging.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+
+#include "mtac/tail_recursion.hpp"
+#include "mtac/Program.hpp"
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/Quadruple.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+bool single_register(std::shared_ptr<const Type> type){
+    return mtac::is_single_int_register(type) || mtac::is_single_float_register(type);
+}
+
+mtac::Operator assign_op(std::shared_ptr<const Type> type){
+    if(type == FLOAT){
+        return mtac::Operator::FASSIGN;
+    } else if(type->is_pointer()){
+        return mtac::Operator::PASSIGN;
+    } else {
+        return mtac::Operator::ASSIGN;
+    }
+}
+
+bool is_copy(mtac::Quadruple& quadruple){
+    return quadruple.op == mtac::Operator::ASSIGN || quadruple.op == mtac::Operator::FASSIGN || quadruple.op == mtac::Operator::PASSIGN;
+}
+
+bool supported(mtac::Function& function){
+    if(function.is_main()){
+        return false;
+    }
+
+    auto& definition = function.definition();
+
+    //Values returned or passed in several parts or by address are not handled
+    if(definition.return_type() != VOID && !single_register(definition.return_type())){
+        return false;
+    }
+
+    for(auto& parameter : definition.parameters()){
+        if(!single_register(parameter.type())){
+            return false;
+        }
+    }
+
+    //The aggregates are only cleared and constructed at the entry of the function
+    for(auto& pair : *function.context){
+        auto& var = pair.second;
+        auto type = var->type();
+
+        if(var->position().isStack() && (type->is_array() || type->is_custom_type() || type->is_template_type())){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool self_call(mtac::Function& function, mtac::Quadruple& quadruple){
+    return quadruple.op == mtac::Operator::CALL && quadruple.function().mangled_name() == function.definition().mangled_name();
+}
+
+//The call must be directly followed by the return of its result
+bool tail_position(mtac::Function& function, mtac::basic_block_p bb, std::size_t call){
+    auto value = bb->statements[call].return1();
+
+    for(std::size_t i = call + 1; i < bb->statements.size(); ++i){
+        auto& quadruple = bb->statements[i];
+
+        if(quadruple.op == mtac::Operator::NOP){
+            continue;
+        }
+
+        if(value && is_copy(quadruple) && !quadruple.arg2 && mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, value)){
+            value = quadruple.result;
+            continue;
+        }
+
+        if(quadruple.op != mtac::Operator::RETURN || quadruple.arg2){
+            return false;
+        }
+
+        if(value){
+            if(!quadruple.arg1 || !mtac::equals<std::shared_ptr<Variable>>(*quadruple.arg1, value)){
+                return false;
+            }
+        } else if(quadruple.arg1){
+            return false;
+        }
+
+        for(std::size_t j = i + 1; j < bb->statements.size(); ++j){
+            if(bb->statements[j].op != mtac::Operator::NOP){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //A procedure can also end by falling through the exit
+    return !value && function.definition().return_type() == VOID && bb->next() == function.exit_bb();
+}
+
+//The parameters are passed just before the call, in the previous block
+bool collect_parameters(mtac::Function& function, mtac::basic_block_p bb, std::vector<mtac::Quadruple*>& parameters){
+    auto count = function.definition().parameters().size();
+
+    if(!count){
+        return true;
+    }
+
+    auto prev = bb->prev();
+
+    if(prev == function.entry_bb() || bb->predecessors.size() != 1 || bb->predecessors.front() != prev){
+        return false;
+    }
+
+    for(auto it = prev->statements.rbegin(); it != prev->statements.rend() && parameters.size() < count; ++it){
+        auto& quadruple = *it;
+
+        if(quadruple.op == mtac::Operator::PARAM || quadruple.op == mtac::Operator::PPARAM){
+            if(!quadruple.param() || !self_call(function, quadruple)){
+                return false;
+            }
+
+            parameters.push_back(&quadruple);
+        } else if(quadruple.op == mtac::Operator::CALL){
+            return false;
+        }
+    }
+
+    return parameters.size() == count;
+}
+
+} //end of anonymous namespace
+
+bool mtac::tail_recursion::gate(std::shared_ptr<Configuration> configuration){
+    return configuration->option_defined("ftail-calls");
+}
+
+bool mtac::tail_recursion::operator()(mtac::Function& function){
+    if(!mtac::is_recursive(function) || !supported(function)){
+        return false;
+    }
+
+    bool optimized = false;
+
+    auto& definition = function.definition();
+    auto start = function.entry_bb()->next();
+
+    for(auto& bb : function){
+        std::size_t call = 0;
+        while(call < bb->statements.size() && bb->statements[call].op == mtac::Operator::NOP){
+            ++call;
+        }
+
+        if(call == bb->statements.size() || !self_call(function, bb->statements[call]) || !tail_position(function, bb, call)){
+            continue;
+        }
+
+        std::vector<mtac::Quadruple*> parameters;
+        if(!collect_parameters(function, bb, parameters)){
+            continue;
+        }
+
+        //The arguments may use the old values of the parameters, they are assigned only once all computed
+
+        std::vector<mtac::Quadruple> statements;
+
+        for(auto* quadruple : parameters){
+            auto param = quadruple->param();
+            auto op = assign_op(param->type());
+            auto temp = function.context->new_temporary(param->type());
+
+            quadruple->op = op;
+            quadruple->result = temp;
+            quadruple->arg2.reset();
+            quadruple->m_function = nullptr;
+
+            statements.emplace_back(param, temp, op);
+        }
+
+        mtac::Quadruple goto_(start->label, mtac::Operator::GOTO);
+        goto_.block = start;
+        statements.push_back(std::move(goto_));
+
+        bb->statements = std::move(statements);
+
+        auto successors = bb->successors;
+        for(auto& succ : successors){
+            mtac::remove_edge(bb, succ);
+        }
+
+        mtac::make_edge(bb, start);
+
+        if(auto edge = program.cg.edge(definition, definition)){
+            if(edge->count){
+                --edge->count;
+            }
+
+            edge->frequency -= std::min(edge->frequency, bb->frequency);
+        }
+
+        LOG<Trace>("Optimizer") << "Transform tail recursive call in B" << bb->index << " of " << function.get_name() << " into a jump" << log::endl;
+        program.context->stats().inc_counter("tail_recursions_eliminated");
+
+        optimized = true;
+    }
+
+    return optimized;
+}
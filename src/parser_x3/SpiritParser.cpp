@@ -20,8 +20,8 @@
 #include <istream>
 #include <sstream>
 #include <iostream>
-#include <fstream>
 #include <string>
+#include <mutex>
 
 #include "GlobalContext.hpp"
 
@@ -37,7 +37,7 @@ namespace x3_grammar {
 
     typedef x3::with_context<
         error_handler_tag
-        , std::reference_wrapper<global_error_handler> const
+        , std::reference_wrapper<file_error_handler> const
         , phrase_context_type>::type
         context_type;
 
@@ -54,12 +54,7 @@ namespace x3_grammar {
 
     /* Match operators into symbols */
 
-    void add_keywords(){
-        static bool once = false;
-        if(once){
-            return;
-        }
-        once = true;
+    void add_keywords_once(){
         unary_op.add
             ("+", ast::Operator::ADD)
             ("-", ast::Operator::SUB)
@@ -122,6 +117,12 @@ namespace x3_grammar {
             ;
     }
 
+    //The symbols are shared by all the parsers, they can be parsing at the same time
+    void add_keywords(){
+        static std::once_flag once;
+        std::call_once(once, add_keywords_once);
+    }
+
     struct source_file_class;
 
     struct type_class {};
@@ -328,10 +329,9 @@ namespace x3_grammar {
 
     x3::real_parser<double, x3::strict_real_policies<double>> strict_double;
 
+    //A single alternative, the identifiers are the most parsed tokens
     auto const identifier_def =
-                x3::lexeme[(x3::char_('_') >> *(x3::alnum | x3::char_('_')))]
-            |   x3::lexeme[(x3::alpha >> *(x3::alnum | x3::char_('_')))]
-            ;
+            x3::lexeme[(x3::alpha | x3::char_('_')) >> *(x3::alnum | x3::char_('_'))];
 
     class identifier_class;
     x3::rule<identifier_class, std::string> const identifier("identifier");
@@ -896,28 +896,28 @@ namespace x3_grammar {
 bool parser_x3::SpiritParser::parse(const std::string& file, ast::SourceFile& program, std::shared_ptr<GlobalContext> context){
     timing_timer timer(context->timing(), "parsing");
 
-    std::ifstream in(file.c_str(), std::ios::binary);
-    in.unsetf(std::ios::skipws);
-
-    //Collect the size of the file
-    in.seekg(0, std::istream::end);
-    std::size_t size(static_cast<size_t>(in.tellg()));
-    in.seekg(0, std::istream::beg);
+    return parse(file, program, context, std::cout, std::cerr);
+}
 
+bool parser_x3::SpiritParser::parse(const std::string& file, ast::SourceFile& program, std::shared_ptr<GlobalContext> context, std::ostream& out, std::ostream& err){
     int current_file = context->new_file(file);
 
     x3_grammar::add_keywords();
 
-    std::string& file_contents = context->get_file_content(current_file);
-    file_contents.resize(size);
-    in.read(&file_contents[0], size);
+    //The file is parsed directly from its mapping
+    auto& file_contents = context->get_file_content(current_file);
+
+    if(!file_contents.is_open()){
+        out << "Unable to read the source file " << file << std::endl;
+        return false;
+    }
 
     x3_grammar::iterator_type it(file_contents.begin());
     x3_grammar::iterator_type end(file_contents.end());
 
-    context->error_handler.register_handler(it, end, file);
+    auto error_handler = context->error_handler.register_handler(current_file, it, end, file, err);
 
-    auto const parser = x3::with<x3_grammar::error_handler_tag>(std::ref(context->error_handler))[x3_grammar::source_file];
+    auto const parser = x3::with<x3_grammar::error_handler_tag>(std::ref(error_handler))[x3_grammar::source_file];
     auto& skipper = x3_grammar::skipper;
 
     bool r = x3::phrase_parse(it, end, parser, skipper, program);
@@ -925,7 +925,7 @@ bool parser_x3::SpiritParser::parse(const std::string& file, ast::SourceFile& pr
     if(r && it == end){
         return true;
     } else {
-        std::cout << "Invalid source file" << std::endl;
+        out << "Invalid source file" << std::endl;
         return false;
     }
 }
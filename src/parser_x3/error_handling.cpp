@@ -1,11 +1,35 @@
 #include "parser_x3/error_handling.hpp"
 #include "SemanticalException.hpp"
 
+void x3_grammar::file_error_handler::operator()(iterator_type err_pos, const std::string& message){
+    handler(out, err_pos, message);
+}
+
+void x3_grammar::file_error_handler::operator()(iterator_type err_pos, iterator_type err_last, const std::string& message){
+    handler(out, err_pos, err_last, message);
+}
+
+x3_grammar::file_error_handler x3_grammar::global_error_handler::register_handler(std::size_t file, iterator_type it, iterator_type end, std::string file_name, std::ostream& out){
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& handler = error_handlers.emplace(std::piecewise_construct,
+            std::forward_as_tuple(file),
+            std::forward_as_tuple(it, end, std::cerr, std::move(file_name))).first->second;
+
+    return {handler, static_cast<int>(file), out};
+}
+
+x3_grammar::error_handler_type& x3_grammar::global_error_handler::handler(std::size_t file){
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return error_handlers.at(file);
+}
+
 void x3_grammar::global_error_handler::operator()(const boost::spirit::x3::file_position_tagged& t, const std::string& message){
     if(t.id_file == -1){
         std::cerr << "Unnotated AST node: " << message << std::endl;
     } else {
-        error_handlers[t.id_file](t, message);
+        handler(t.id_file)(t, message);
     }
 }
 
@@ -13,18 +37,10 @@ std::string x3_grammar::global_error_handler::to_string(const boost::spirit::x3:
     if(t.id_file == -1){
         return std::string("Unnotated AST node: ") + message;
     } else {
-        return error_handlers[t.id_file].to_string(t, message);
+        return handler(t.id_file).to_string(t, message);
     }
 }
 
-void x3_grammar::global_error_handler::operator()(iterator_type err_pos, const std::string& message){
-    current()(err_pos, message);
-}
-
-void x3_grammar::global_error_handler::operator()(iterator_type err_pos, iterator_type err_last, const std::string& message){
-    current()(err_pos, err_last, message);
-}
-
 void x3_grammar::global_error_handler::semantical_exception(const std::string& message, const boost::spirit::x3::file_position_tagged& t){
     throw eddic::SemanticalException(to_string(t, message));
 }
@@ -1,23 +1,70 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+/*
+ * Benchmark of the parser alone. Each file is parsed several times and the throughput is reported in MB/s.
+ *
+ * Usage: x3_test [--repeat N] files...
+ */
+
 #include <iostream>
 #include <vector>
+#include <string>
 
 #include "parser_x3/SpiritParser.hpp"
 
 #include "GlobalContext.hpp"
+#include "StopWatch.hpp"
 
 using namespace eddic;
 
 int main(int argc, char** args){
-    const std::vector<std::string> argv(args+1, args+argc);
+    std::vector<std::string> argv(args+1, args+argc);
+
+    std::size_t repeat = 100;
+
+    if(argv.size() > 1 && argv[0] == "--repeat"){
+        repeat = std::stoul(argv[1]);
+        argv.erase(argv.begin(), argv.begin() + 2);
+    }
+
+    std::size_t bytes = 0;
+    double total = 0.0;
+
+    for (auto& file : argv){
+        std::size_t size = 0;
+        double time = 0.0;
 
-    for (int i=0; i<100; i++){
-        for (auto& file : argv){
+        for (std::size_t i = 0; i < repeat; ++i){
             auto context = std::make_shared<GlobalContext>(Platform::INTEL_X86_64);
             parser_x3::SpiritParser parser;
             ast::SourceFile source;
 
-            parser.parse(file, source, context);
+            //Only the parsing itself is timed
+            StopWatch watch;
+            bool valid = parser.parse(file, source, context);
+            time += watch.elapsed();
+
+            if(!valid){
+                std::cout << file << ": parsing failed" << std::endl;
+                return 1;
+            }
+
+            size = context->get_file_content(0).size();
         }
+
+        bytes += size * repeat;
+        total += time;
+
+        std::cout << file << ": " << (size / 1024.0) << "KB in " << (time / repeat) << "ms, " << ((size * repeat) / (1024.0 * 1024.0)) / (time / 1000.0) << "MB/s" << std::endl;
+    }
+
+    if(total > 0.0){
+        std::cout << "Total: " << (bytes / (1024.0 * 1024.0)) << "MB in " << total << "ms, " << (bytes / (1024.0 * 1024.0)) / (total / 1000.0) << "MB/s" << std::endl;
     }
 
     return 0;
@@ -13,6 +13,14 @@ void statistics::inc_counter(const std::string& a){
     ++counters[a];
 }
 
+void statistics::add_counter(const std::string& a, std::size_t value){
+    counters[a] += value;
+}
+
+void statistics::set_counter(const std::string& a, std::size_t value){
+    counters[a] = value;
+}
+
 std::size_t statistics::counter(const std::string& a) const {
     return counters.at(a);
 }
@@ -0,0 +1,36 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2016.
+// Distributed under the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <unordered_set>
+#include <mutex>
+#include <iostream>
+
+#include "symbol.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//The strings are never released, the pointers must stay valid
+const std::string* intern(const std::string& value){
+    static std::unordered_set<std::string> strings;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return &*strings.insert(value).first;
+}
+
+} //end of anonymous namespace
+
+symbol::symbol() : value(intern("")) {}
+symbol::symbol(const std::string& value) : value(intern(value)) {}
+symbol::symbol(const char* value) : value(intern(value)) {}
+
+std::ostream& eddic::operator<<(std::ostream& stream, const symbol& symbol){
+    return stream << symbol.str();
+}
@@ -65,5 +65,8 @@ void timing_system::display(){
 }
 
 void timing_system::register_timing(std::string name, double time){
+    //The parsers of the imported files register their timings concurrently
+    std::lock_guard<std::mutex> lock(mutex);
+
     timings[name] += time;
 }
@@ -10,6 +10,7 @@
 #include "Function.hpp"
 
 #include "mtac/Function.hpp"
+#include "mtac/ControlFlowGraph.hpp"
 
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
@@ -26,8 +27,8 @@ BOOST_AUTO_TEST_CASE( bb_entry_exit_count ){
     BOOST_CHECK_EQUAL(function->entry_bb()->index, -1);
     BOOST_CHECK_EQUAL(function->exit_bb()->index, -2);
 
-    BOOST_CHECK(function->entry_bb()->next == function->exit_bb());
-    BOOST_CHECK(function->exit_bb()->prev == function->entry_bb());
+    BOOST_CHECK(function->entry_bb()->next() == function->exit_bb());
+    BOOST_CHECK(function->exit_bb()->prev() == function->entry_bb());
 
     BOOST_CHECK_EQUAL(function->bb_count(), 2u);
 }
@@ -90,10 +91,10 @@ BOOST_AUTO_TEST_CASE( bb_new_bb ){
 
     BOOST_CHECK_EQUAL(function->bb_count(), 3u);
 
-    BOOST_CHECK(bb->next == function->exit_bb());
-    BOOST_CHECK(bb->prev == function->entry_bb());
-    BOOST_CHECK(function->entry_bb()->next == bb);
-    BOOST_CHECK(function->exit_bb()->prev == bb);
+    BOOST_CHECK(bb->next() == function->exit_bb());
+    BOOST_CHECK(bb->prev() == function->entry_bb());
+    BOOST_CHECK(function->entry_bb()->next() == bb);
+    BOOST_CHECK(function->exit_bb()->prev() == bb);
 }
 
 BOOST_AUTO_TEST_CASE( bb_remove_bb ){
@@ -113,8 +114,8 @@ BOOST_AUTO_TEST_CASE( bb_remove_bb ){
 
     BOOST_CHECK_EQUAL(function->bb_count(), 5u);
 
-    BOOST_CHECK(bb1->next == bb3);
-    BOOST_CHECK(bb3->prev == bb1);
+    BOOST_CHECK(bb1->next() == bb3);
+    BOOST_CHECK(bb3->prev() == bb1);
 
     auto it = function->begin();
     ++it;
@@ -122,8 +123,8 @@ BOOST_AUTO_TEST_CASE( bb_remove_bb ){
 
     function->remove(it);
 
-    BOOST_CHECK(bb1->next == bb4);
-    BOOST_CHECK(bb4->prev == bb1);
+    BOOST_CHECK(bb1->next() == bb4);
+    BOOST_CHECK(bb4->prev() == bb1);
 
     BOOST_CHECK_EQUAL(function->bb_count(), 4u);
 }
@@ -165,3 +166,76 @@ BOOST_AUTO_TEST_CASE( bb_at ){
     BOOST_CHECK(it_end == it);
     BOOST_CHECK(it_at == it_end);
 }
+
+BOOST_AUTO_TEST_CASE( bb_layout ){
+    Function definition(nullptr, "test_function", "test_function");
+    auto function = std::make_shared<mtac::Function>(nullptr, "test_function", definition);
+
+    function->create_entry_bb();
+    auto bb1 = function->append_bb();
+    auto bb2 = function->append_bb();
+    auto bb3 = function->append_bb();
+    function->create_exit_bb();
+
+    mtac::make_edge(bb1, bb3);
+    mtac::make_edge(bb2, bb3);
+    bb3->set_dominator(bb1);
+
+    BOOST_CHECK_EQUAL(function->position(bb3), 3u);
+
+    function->remove(bb2);
+
+    BOOST_CHECK_EQUAL(function->position(bb3), 2u);
+    BOOST_CHECK_EQUAL(bb3->predecessors.size(), 1u);
+    BOOST_CHECK(bb3->predecessors[0] == bb1);
+    BOOST_CHECK(!bb2->next());
+    BOOST_CHECK(!bb2->prev());
+
+    function->reorder({function->entry_bb(), bb3, bb1, function->exit_bb()});
+
+    BOOST_CHECK_EQUAL(function->position(bb1), 2u);
+    BOOST_CHECK_EQUAL(function->position(bb3), 1u);
+    BOOST_CHECK(bb3->next() == bb1);
+    BOOST_CHECK(bb1->next() == function->exit_bb());
+    BOOST_CHECK(bb1->successors[0] == bb3);
+    BOOST_CHECK(bb3->dominator() == bb1);
+}
+
+BOOST_AUTO_TEST_CASE( find_uid ){
+    Function definition(nullptr, "test_function", "test_function");
+    auto function = std::make_shared<mtac::Function>(nullptr, "test_function", definition);
+
+    function->create_entry_bb();
+    auto bb1 = function->append_bb();
+    auto bb2 = function->append_bb();
+    function->create_exit_bb();
+
+    bb1->emplace_back(mtac::Operator::NOP);
+    bb2->emplace_back(mtac::Operator::NOP);
+    bb2->emplace_back(mtac::Operator::NOP);
+
+    auto uid = bb2->statements[1].uid();
+
+    BOOST_CHECK_EQUAL(function->find(uid).uid(), uid);
+    BOOST_CHECK_EQUAL(function->find(bb1->statements[0].uid()).uid(), bb1->statements[0].uid());
+
+    //The index is updated when the statements are moved
+    bb2->statements.insert(bb2->statements.begin(), mtac::Quadruple(mtac::Operator::NOP));
+
+    BOOST_CHECK_EQUAL(function->find(uid).uid(), uid);
+    BOOST_CHECK(&function->find(uid) == &bb2->statements[2]);
+    BOOST_CHECK(&bb2->find(uid) == &bb2->statements[2]);
+
+    bb2->statements.erase(bb2->statements.begin());
+
+    BOOST_CHECK(&function->find(uid) == &bb2->statements[1]);
+
+    bb1->statements.replace(bb1->statements[0], mtac::Quadruple(mtac::Operator::GOTO));
+
+    BOOST_CHECK(&function->find(bb1->statements[0].uid()) == &bb1->statements[0]);
+
+    //The statements assigned through a reference are found again
+    bb2->statements[0] = mtac::Quadruple(mtac::Operator::NOP);
+
+    BOOST_CHECK(&function->find(bb2->statements[0].uid()) == &bb2->statements[0]);
+}
@@ -19,8 +19,15 @@
 #include "Platform.hpp"
 #include "GlobalContext.hpp"
 #include "EDDIFrontEnd.hpp"
+#include "StringPool.hpp"
 
 #include "mtac/Program.hpp"
+#include "mtac/Compiler.hpp"
+
+#include "ast/SourceFile.hpp"
+#include "ast/DependenciesResolver.hpp"
+
+#include "parser_x3/SpiritParser.hpp"
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE eddic_test_suite
@@ -490,6 +497,71 @@ BOOST_AUTO_TEST_CASE( switch_string ){
     assert_output("switch_string.eddi", "5|5|3|6|default|4|");
 }
 
+BOOST_AUTO_TEST_CASE( memory_builtins ){
+    assert_output("memory_builtins.eddi", "1|4|0|9|12|12|0|0|0|9|9|0|xyyx|xyx|");
+}
+
+BOOST_AUTO_TEST_CASE( block_layout ){
+    assert_output("block_layout.eddi", "110|10|-1|");
+}
+
+BOOST_AUTO_TEST_CASE( scheduling ){
+    validate("scheduling.eddi", 126, 103, -22, 6.75, 9.75);
+}
+
+BOOST_AUTO_TEST_CASE( tail_calls ){
+    validate("tail_calls.eddi", 50005000, 21, 1, 1024.0, 3, 2, 1);
+}
+
+BOOST_AUTO_TEST_CASE( stack_clearing ){
+    validate("stack_clearing.eddi", 7, 0, 9, 307);
+}
+
+BOOST_AUTO_TEST_CASE( stack_slots ){
+    validate("stack_slots.eddi", 1225, 4900, 30, 77);
+    validate("stack_slots_clear.eddi", 4592);
+}
+
+BOOST_AUTO_TEST_CASE( address_folding ){
+    validate("address_folding.eddi", 96, 45, 90);
+}
+
+BOOST_AUTO_TEST_CASE( register_pressure ){
+    validate("register_pressure.eddi", 28755);
+}
+
+BOOST_AUTO_TEST_CASE( function_specialization ){
+    validate("function_specialization.eddi", 234, 90);
+}
+
+BOOST_AUTO_TEST_CASE( inline_budget ){
+    validate("inline_budget.eddi", 320, 1, 1);
+    assert_output_equals("inline_budget.eddi", "320|1|1|", "--64", "--inline-unit-growth=0", "inline_budget.eddi.7.out");
+    assert_output_equals("inline_budget.eddi", "320|1|1|", "--64", "--inline-function-growth=0", "inline_budget.eddi.8.out");
+}
+
+BOOST_AUTO_TEST_CASE( gvn ){
+    validate("gvn.eddi", 24, 25, 8, 6, 100, 45);
+}
+
+BOOST_AUTO_TEST_CASE( dead_stores ){
+    validate("dead_stores.eddi", 5, 6, 7, 8, 11, 2);
+}
+
+BOOST_AUTO_TEST_CASE( pre ){
+    validate("pre.eddi", 42, 42);
+}
+
+BOOST_AUTO_TEST_CASE( profile ){
+    assert_output_equals("profile.eddi", "285|", "--32", "--profile-generate", "profile.eddi.1.out");
+    assert_output_equals("profile.eddi", "285|", "--32", "--profile-use=profile.eddi.1.out.profile", "profile.eddi.2.out");
+    remove("./profile.eddi.1.out.profile");
+
+    assert_output_equals("profile.eddi", "285|", "--64", "--profile-generate", "profile.eddi.3.out");
+    assert_output_equals("profile.eddi", "285|", "--64", "--profile-use=profile.eddi.3.out.profile", "profile.eddi.4.out");
+    remove("./profile.eddi.3.out.profile");
+}
+
 BOOST_AUTO_TEST_CASE( nested ){
     validate("nested.eddi", 222, 555, 333, 444, 2222, 5555, 3333, 4444, "", 222, 555,333, 444, 2222, 5555, 3333, 4444);
 }
@@ -624,6 +696,9 @@ BOOST_AUTO_TEST_SUITE_END()
 
 /* Unit test for optimization regression */
 
+//The AST passes of the EDDI front end, defined in EDDIFrontEnd.cpp
+void generate_program(eddic::ast::SourceFile& program, std::shared_ptr<eddic::Configuration> configuration, eddic::Platform platform, std::shared_ptr<eddic::StringPool> pool);
+
 BOOST_AUTO_TEST_SUITE(OptimizationSuite)
 
 eddic::statistics& compute_stats_mtac(const std::string& file){
@@ -713,13 +788,89 @@ BOOST_AUTO_TEST_CASE( loop_unswitching ){
 BOOST_AUTO_TEST_CASE( global_cse ){
     auto& stats = compute_stats_mtac("common_subexpr_elim.eddi");
 
-    BOOST_REQUIRE_EQUAL(stats.counter("common_subexpr_eliminated"), 3);
+    BOOST_REQUIRE_EQUAL(stats.counter("gvn_eliminated"), 3);
 }
 
 BOOST_AUTO_TEST_CASE( local_cse ){
     auto& stats = compute_stats_mtac("local_cse.eddi");
 
-    BOOST_REQUIRE_EQUAL(stats.counter("local_cse"), 4);
+    BOOST_REQUIRE_EQUAL(stats.counter("gvn_eliminated"), 4);
+}
+
+BOOST_AUTO_TEST_CASE( dead_store_elimination ){
+    auto& stats = compute_stats_mtac("dead_stores.eddi");
+
+    BOOST_REQUIRE_EQUAL(stats.counter("dead_stores_eliminated"), 4);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_code_motion ){
+    auto& stats = compute_stats_mtac("pre.eddi");
+
+    BOOST_REQUIRE_EQUAL(stats.counter("pre_eliminated"), 1);
+}
+
+BOOST_AUTO_TEST_CASE( release_memory ){
+    auto configuration = parse_options("test/cases/pre.eddi", "test/cases/pre.eddi.out", {"--64", "--O3"});
+
+    //The body of an AST function is released once its MTAC has been generated
+
+    eddic::ast::SourceFile source;
+    source.context = std::make_shared<eddic::GlobalContext>(eddic::Platform::INTEL_X86_64);
+
+    eddic::parser_x3::SpiritParser parser;
+    BOOST_REQUIRE(parser.parse("test/cases/pre.eddi", source, source.context));
+
+    eddic::ast::resolveDependencies(source, parser);
+
+    auto pool = std::make_shared<eddic::StringPool>();
+    generate_program(source, configuration, eddic::Platform::INTEL_X86_64, pool);
+
+    eddic::mtac::Program mtac_program;
+    eddic::mtac::Compiler mtac_compiler;
+    mtac_compiler.compile(source, pool, mtac_program);
+
+    for(auto& block : source.blocks){
+        if(auto* ptr = boost::get<eddic::ast::TemplateFunctionDeclaration>(&block)){
+            if(!ptr->is_template()){
+                BOOST_REQUIRE(ptr->instructions.empty());
+                BOOST_REQUIRE_EQUAL(ptr->instructions.capacity(), 0);
+            }
+        }
+    }
+
+    //The MTAC and LTAC statements and the function contexts are released by the back end
+
+    eddic::Compiler compiler;
+    eddic::EDDIFrontEnd front_end;
+    auto program = compiler.compile_mtac("test/cases/pre.eddi", eddic::Platform::INTEL_X86_64, configuration, front_end);
+    compiler.compile_ltac(*program, eddic::Platform::INTEL_X86_64, configuration, front_end);
+
+    remove("test/cases/pre.eddi.out");
+
+    for(auto& function : program->functions){
+        BOOST_REQUIRE(!function.context);
+        BOOST_REQUIRE(!function.definition().context());
+
+        for(auto& bb : function){
+            BOOST_REQUIRE(bb->statements.empty());
+            BOOST_REQUIRE_EQUAL(bb->statements.capacity(), 0);
+            BOOST_REQUIRE(bb->l_statements.empty());
+            BOOST_REQUIRE_EQUAL(bb->l_statements.capacity(), 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( memory_idioms ){
+    auto& stats = compute_stats_mtac("memory_idioms.eddi");
+
+    BOOST_REQUIRE_EQUAL(stats.counter("fill_loop_replaced"), 1);
+    BOOST_REQUIRE_EQUAL(stats.counter("copy_loop_replaced"), 1);
+}
+
+BOOST_AUTO_TEST_CASE( stack_slots ){
+    auto& stats = compute_stats_ltac("stack_slots.eddi");
+
+    BOOST_REQUIRE(stats.counter("stack_slots_shared") >= 2);
 }
 
 BOOST_AUTO_TEST_CASE( cmov_opt ){
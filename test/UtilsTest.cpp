@@ -8,6 +8,7 @@
 #include <string>
 
 #include "Utils.hpp"
+#include "symbol.hpp"
 
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
@@ -23,3 +24,14 @@ BOOST_AUTO_TEST_CASE( toNumber ){
 
     BOOST_CHECK_EQUAL (value, 22);
 }
+
+BOOST_AUTO_TEST_CASE( symbols ){
+    eddic::symbol a("variable");
+    eddic::symbol b(std::string("vari") + "able");
+    eddic::symbol c("other");
+
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != c);
+    BOOST_CHECK_EQUAL (&a.str(), &b.str());
+    BOOST_CHECK_EQUAL (c.str(), "other");
+}
@@ -0,0 +1,23 @@
+#! /bin/bash
+
+#Benchmark the parser alone on a large generated source file
+
+executable=${1:-"release/bin/x3_test"}
+base_dir=${2:-"."}
+copies=${3:-"50"}
+
+generated="parser_bench.eddi"
+
+rm -f $generated
+
+#The generated file is only parsed, it does not need to be a valid program
+for i in $(seq 1 $copies) ; do
+    for file in $base_dir/test/cases/*.eddi $base_dir/eddi_samples/*.eddi ; do
+        cat $file >> $generated
+        echo >> $generated
+    done
+done
+
+$executable --repeat 10 $generated
+
+rm -f $generated